@@ -0,0 +1,649 @@
+/**
+ * bench.c
+ *
+ * Implements the microbenchmark harness of the simulator. Each benchmark runs
+ * one operation of the game, from counting the neighbours of a single cell to
+ * stepping a whole generation, on a set of reference workloads and world
+ * sizes. Every measurement is repeated several times and reported as one CSV
+ * row with its mean, standard deviation and minimum, so that runs of two
+ * commits can be lined up and compared.
+ *
+ * Usage: ./life_bench [options]
+ * Options:
+ *   -s, --sizes LIST         Comma-separated world sides (default: 1000,10000)
+ *   -r, --reps NUM           Set the samples taken per benchmark (default: 5)
+ *   -n, --generations NUM    Set the generations stepped per sample
+ *                            (default: 10)
+ *   -t, --threads NUM        Set the number of worker threads (default: 1)
+ *   -f, --filter TEXT        Only run the benchmarks whose name contains TEXT
+ *   -l, --label TEXT         Label the rows with TEXT, such as a commit
+ *   -h, --help               Print this message
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include <math.h>
+
+#include "life.h"
+
+// Reference pattern filling a blank world
+typedef struct {
+  const char* name;
+  void (*fill)(world_t* world);
+} workload_t;
+
+// Settings shared by every benchmark of a run
+typedef struct {
+  size_t reps;
+  size_t generations;
+  size_t threads;
+  const char* filter;
+  const char* label;
+  FILE* report;
+} bench_config_t;
+
+// World a benchmark runs on, with the files it was saved to in each format
+typedef struct {
+  const workload_t* workload;
+  const world_t* world;
+  char* filenames[3];  // Indexed by `pattern_format_t`
+} bench_case_t;
+
+// Measured operation. `run` times one sample and returns its duration in
+// seconds, or a negative value on failure.
+typedef struct {
+  const char* name;
+  size_t max_side;     // Largest world side the benchmark runs on
+  const char* engine;  // Engine the operation runs on, if any
+  double (*run)(const bench_config_t* bench, const bench_case_t* bench_case,
+                const engine_t* engine);
+  double work;         // Cells processed per sample, per cell of the world
+} benchmark_t;
+
+static void FillRandom(world_t* world);
+static void FillRPentomino(world_t* world);
+static void FillGliderGuns(world_t* world);
+static double RunComputeCellState(const bench_config_t* bench,
+                                  const bench_case_t* bench_case,
+                                  const engine_t* engine);
+static double RunSimulateGeneration(const bench_config_t* bench,
+                                    const bench_case_t* bench_case,
+                                    const engine_t* engine);
+static double RunStepTemporal(const bench_config_t* bench,
+                              const bench_case_t* bench_case,
+                              const engine_t* engine);
+static double RunCreateWorld(const bench_config_t* bench,
+                             const bench_case_t* bench_case,
+                             const engine_t* engine);
+static double RunCreateWorldRle(const bench_config_t* bench,
+                                const bench_case_t* bench_case,
+                                const engine_t* engine);
+static double RunCreateWorldBinary(const bench_config_t* bench,
+                                   const bench_case_t* bench_case,
+                                   const engine_t* engine);
+static double RunLoad(const bench_case_t* bench_case,
+                      pattern_format_t format);
+static double RunPrintWorld(const bench_config_t* bench,
+                            const bench_case_t* bench_case,
+                            const engine_t* engine);
+static double RunRenderFrame(const bench_config_t* bench,
+                             const bench_case_t* bench_case,
+                             const engine_t* engine);
+static int RunBenchmark(const bench_config_t* bench,
+                        const bench_case_t* bench_case,
+                        const benchmark_t* benchmark);
+static char* SaveTempWorld(const world_t* world, pattern_format_t format);
+static void PrintUsage(void);
+
+// Density of the random workload, out of 256, matching the 8.5% used by
+// scripts/generate.py
+static const unsigned kRandomDensity = 22;
+static const uint64_t kRandomSeed = 0x9E3779B97F4A7C15;
+// Generations advanced per pass by the temporal blocking benchmarks
+static const size_t kBenchTemporalDepth = 8;
+// Distance between the glider guns of the glider gun workload
+static const size_t kGunSpacing = 64;
+static const char* const kGliderGun[] = {
+  "                        *           ",
+  "                      * *           ",
+  "            **      **            **",
+  "           *   *    **            **",
+  "**        *     *   **              ",
+  "**        *   * **    * *           ",
+  "          *     *       *           ",
+  "           *   *                    ",
+  "            **                      ",
+};
+
+static const workload_t kWorkloads[] = {
+  {"random", FillRandom},
+  {"r-pentomino", FillRPentomino},
+  {"glider-guns", FillGliderGuns},
+};
+
+static const benchmark_t kBenchmarks[] = {
+  {"compute_cell_state", 1000, NULL, RunComputeCellState, 1},
+  {"simulate_generation", 1000, "scalar", RunSimulateGeneration, 0},
+  {"simulate_generation", SIZE_MAX, "swar", RunSimulateGeneration, 0},
+  {"simulate_generation", SIZE_MAX, "lut", RunSimulateGeneration, 0},
+  {"simulate_generation", SIZE_MAX, "avx2", RunSimulateGeneration, 0},
+  {"simulate_generation", SIZE_MAX, "avx512", RunSimulateGeneration, 0},
+  {"simulate_generation", SIZE_MAX, "neon", RunSimulateGeneration, 0},
+  {"step_temporal", SIZE_MAX, "swar", RunStepTemporal, 0},
+  {"step_temporal", SIZE_MAX, "avx2", RunStepTemporal, 0},
+  {"step_temporal", SIZE_MAX, "avx512", RunStepTemporal, 0},
+  {"step_temporal", SIZE_MAX, "neon", RunStepTemporal, 0},
+  {"create_world", 10000, NULL, RunCreateWorld, 1},
+  {"create_world_rle", 10000, NULL, RunCreateWorldRle, 1},
+  {"create_world_binary", 10000, NULL, RunCreateWorldBinary, 1},
+  {"print_world", 10000, NULL, RunPrintWorld, 1},
+  {"render_frame", 10000, NULL, RunRenderFrame, 1},
+};
+
+int main(int argc, char* argv[]) {
+  bench_config_t bench = {5, 10, 1, "", "unknown", NULL};
+  const char* sizes = "1000,10000";
+
+  static struct option longopts[] = {
+    {"sizes",       required_argument, 0, 's'},
+    {"reps",        required_argument, 0, 'r'},
+    {"generations", required_argument, 0, 'n'},
+    {"threads",     required_argument, 0, 't'},
+    {"filter",      required_argument, 0, 'f'},
+    {"label",       required_argument, 0, 'l'},
+    {"help",        no_argument,       0, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "hs:r:n:t:f:l:", longopts, 0)) != -1) {
+    switch (opt) {
+      case 's':
+        sizes = optarg;
+        break;
+
+      case 'r':
+        if (ParseLong(&bench.reps, optarg) < 0) {
+          fprintf(stderr, "Error: Invalid input for reps, '%s'\n", optarg);
+          return 1;
+        }
+        break;
+
+      case 'n':
+        if (ParseLong(&bench.generations, optarg) < 0) {
+          fprintf(stderr, "Error: Invalid input for generations, '%s'\n",
+                  optarg);
+          return 1;
+        }
+        break;
+
+      case 't':
+        if (ParseLong(&bench.threads, optarg) < 0) {
+          fprintf(stderr, "Error: Invalid input for threads, '%s'\n", optarg);
+          return 1;
+        }
+        break;
+
+      case 'f':
+        bench.filter = optarg;
+        break;
+
+      case 'l':
+        bench.label = optarg;
+        break;
+
+      case 'h':
+      case '?':
+        PrintUsage();
+        return 1;
+    }
+  }
+
+  // Rendered frames go to /dev/null; the report keeps the original stdout
+  bench.report = fdopen(dup(STDOUT_FILENO), "w");
+  if (!bench.report || !freopen("/dev/null", "w", stdout)) {
+    fprintf(stderr, "Error: Unable to redirect the standard output\n");
+    return 1;
+  }
+
+  fprintf(bench.report, "label,benchmark,engine,workload,side,reps,"
+                        "mean_seconds,stddev_seconds,min_seconds,"
+                        "cells_per_second\n");
+  fflush(bench.report);
+
+  int status = 0;
+  for (const char* size = sizes; *size && status == 0;) {
+    size_t side;
+    char* end;
+    side = (size_t)strtoul(size, &end, 10);
+    if (end == size || side == 0 || (*end != ',' && *end != '\0')) {
+      fprintf(stderr, "Error: Invalid world side in '%s'\n", sizes);
+      return 1;
+    }
+    size = *end ? end + 1 : end;
+
+    for (size_t w = 0; w < sizeof(kWorkloads) / sizeof(kWorkloads[0]); w++) {
+      world_t* world = CreateWorldGrid(side, side);
+      if (!world) {
+        fprintf(stderr, "Error: Unable to create a %zu x %zu world\n", side,
+                side);
+        status = 1;
+        break;
+      }
+      kWorkloads[w].fill(world);
+      bench_case_t bench_case = {&kWorkloads[w], world, {NULL, NULL, NULL}};
+
+      for (size_t b = 0; b < sizeof(kBenchmarks) / sizeof(kBenchmarks[0]);
+           b++) {
+        if (RunBenchmark(&bench, &bench_case, &kBenchmarks[b]) < 0) {
+          fprintf(stderr, "Error: Benchmark '%s' failed on %s at %zu\n",
+                  kBenchmarks[b].name, kWorkloads[w].name, side);
+          status = 1;
+          break;
+        }
+      }
+
+      for (size_t f = 0; f < 3; f++) {
+        if (bench_case.filenames[f]) {
+          remove(bench_case.filenames[f]);
+          free(bench_case.filenames[f]);
+        }
+      }
+      FreeWorldGrid(world);
+      if (status) {
+        break;
+      }
+    }
+  }
+
+  fclose(bench.report);
+  return status;
+}
+
+/**
+ * @brief Samples one benchmark on one world and reports its statistics.
+ *
+ * Skips the benchmark if it does not match the filter, if the world is wider
+ * than the benchmark allows, or if its engine does not run on this CPU. The
+ * samples reported follow a warm-up sample that is left out.
+ *
+ * @return Returns 0 on success or when the benchmark is skipped, -1 if a
+ *         sample fails.
+ */
+static int RunBenchmark(const bench_config_t* bench,
+                        const bench_case_t* bench_case,
+                        const benchmark_t* benchmark) {
+  const world_t* world = bench_case->world;
+  if (!strstr(benchmark->name, bench->filter) ||
+      world->rows > benchmark->max_side) {
+    return 0;
+  }
+
+  const engine_t* engine = NULL;
+  if (benchmark->engine) {
+    engine = FindEngine(benchmark->engine);
+    if (!engine || !IsEngineSupported(engine)) {
+      return 0;
+    }
+  }
+
+  // One sample is run and discarded first, so that page faults and one-time
+  // setup, such as building the table of the lut engine, are not timed
+  if (benchmark->run(bench, bench_case, engine) < 0) {
+    return -1;
+  }
+
+  double sum = 0;
+  double sum_squares = 0;
+  double min = INFINITY;
+  for (size_t i = 0; i < bench->reps; i++) {
+    double seconds = benchmark->run(bench, bench_case, engine);
+    if (seconds < 0) {
+      return -1;
+    }
+    sum += seconds;
+    sum_squares += seconds * seconds;
+    min = seconds < min ? seconds : min;
+  }
+
+  double reps = (double)bench->reps;
+  double mean = sum / reps;
+  double variance = reps > 1 ? (sum_squares - sum * mean) / (reps - 1) : 0;
+  double stddev = variance > 0 ? sqrt(variance) : 0;
+  double work = benchmark->work ? benchmark->work
+                                : (double)bench->generations;
+  double cells = (double)world->rows * (double)world->cols * work;
+
+  fprintf(bench->report, "%s,%s,%s,%s,%zu,%zu,%.9f,%.9f,%.9f,%.1f\n",
+          bench->label, benchmark->name, engine ? engine->name : "",
+          bench_case->workload->name, world->rows, bench->reps, mean, stddev,
+          min, mean > 0 ? cells / mean : 0);
+  fflush(bench->report);
+  return 0;
+}
+
+/**
+ * @brief Times `ComputeCellState` over every cell of the world.
+ */
+static double RunComputeCellState(const bench_config_t* bench,
+                                  const bench_case_t* bench_case,
+                                  const engine_t* engine) {
+  (void)bench;
+  (void)engine;
+  const world_t* world = bench_case->world;
+  volatile int sink = 0;
+  int alive = 0;
+
+  double start = MonotonicSeconds();
+  for (size_t i = kPadding; i <= world->rows; i++) {
+    for (size_t j = kPadding; j <= world->cols; j++) {
+      alive += ComputeCellState(world, i, j, &kConwayRule);
+    }
+  }
+  double seconds = MonotonicSeconds() - start;
+
+  sink = alive;
+  (void)sink;
+  return seconds;
+}
+
+/**
+ * @brief Times `bench->generations` calls to `SimulateGeneration`.
+ *
+ * Each sample starts over from the workload, with every tile marked changed,
+ * so that all samples step the same generations.
+ */
+static double RunSimulateGeneration(const bench_config_t* bench,
+                                    const bench_case_t* bench_case,
+                                    const engine_t* engine) {
+  const world_t* initial = bench_case->world;
+  config_t config = kDefaults;
+  config.rows = initial->rows;
+  config.cols = initial->cols;
+  config.engine = engine;
+  config.threads = bench->threads;
+
+  world_t* current = CreateWorldGrid(initial->rows, initial->cols);
+  world_t* next = CreateWorldGrid(initial->rows, initial->cols);
+  tiles_t* tiles = current ? CreateTiles((const world_t*)current, 0) : NULL;
+  pool_t* pool = CreatePool(bench->threads);
+  double seconds = -1;
+  if (current && next && tiles && pool) {
+    CopyWorldGrid(current, initial);
+    CopyWorldGrid(next, initial);
+
+    double start = MonotonicSeconds();
+    for (size_t gen = 0; gen < bench->generations; gen++) {
+      SimulateGeneration(current, next, tiles, (const config_t*)&config, pool);
+      world_t* tmp = current;
+      current = next;
+      next = tmp;
+    }
+    seconds = MonotonicSeconds() - start;
+  }
+
+  FreePool(pool);
+  FreeTiles(tiles);
+  FreeWorldGrid(next);
+  FreeWorldGrid(current);
+  return seconds;
+}
+
+/**
+ * @brief Times `bench->generations` generations advanced by `StepTemporal`,
+ *        `kBenchTemporalDepth` generations per pass.
+ */
+static double RunStepTemporal(const bench_config_t* bench,
+                              const bench_case_t* bench_case,
+                              const engine_t* engine) {
+  const world_t* initial = bench_case->world;
+  world_t* current = CreateWorldGrid(initial->rows, initial->cols);
+  world_t* next = CreateWorldGrid(initial->rows, initial->cols);
+  temporal_t* temporal = CreateTemporal(initial, kBenchTemporalDepth,
+                                        bench->threads);
+  pool_t* pool = CreatePool(bench->threads);
+  double seconds = -1;
+  if (current && next && temporal && pool) {
+    CopyWorldGrid(current, initial);
+
+    double start = MonotonicSeconds();
+    for (size_t gen = 0; gen < bench->generations;
+         gen += kBenchTemporalDepth) {
+      size_t left = bench->generations - gen;
+      StepTemporal(temporal, engine, &kConwayRule, (const world_t*)current,
+                   next, left < kBenchTemporalDepth ? left
+                                                    : kBenchTemporalDepth,
+                   0, pool);
+      world_t* tmp = current;
+      current = next;
+      next = tmp;
+    }
+    seconds = MonotonicSeconds() - start;
+  }
+
+  FreePool(pool);
+  FreeTemporal(temporal);
+  FreeWorldGrid(next);
+  FreeWorldGrid(current);
+  return seconds;
+}
+
+/**
+ * @brief Times `CreateWorld` parsing the workload back from a text file.
+ */
+static double RunCreateWorld(const bench_config_t* bench,
+                             const bench_case_t* bench_case,
+                             const engine_t* engine) {
+  (void)bench;
+  (void)engine;
+  return RunLoad(bench_case, kFormatText);
+}
+
+/**
+ * @brief Times `CreateWorld` decoding the workload from an RLE file.
+ */
+static double RunCreateWorldRle(const bench_config_t* bench,
+                                const bench_case_t* bench_case,
+                                const engine_t* engine) {
+  (void)bench;
+  (void)engine;
+  return RunLoad(bench_case, kFormatRle);
+}
+
+/**
+ * @brief Times `CreateWorld` unpacking the workload from a binary file.
+ */
+static double RunCreateWorldBinary(const bench_config_t* bench,
+                                   const bench_case_t* bench_case,
+                                   const engine_t* engine) {
+  (void)bench;
+  (void)engine;
+  return RunLoad(bench_case, kFormatBinary);
+}
+
+/**
+ * @brief Times `CreateWorld` loading the workload from a file in `format`.
+ *
+ * The file is written by the first sample and removed once every benchmark
+ * of the world has run.
+ */
+static double RunLoad(const bench_case_t* bench_case,
+                      pattern_format_t format) {
+  bench_case_t* saved = (bench_case_t*)bench_case;
+  if (!saved->filenames[format]) {
+    saved->filenames[format] = SaveTempWorld(bench_case->world, format);
+    if (!saved->filenames[format]) {
+      return -1;
+    }
+  }
+
+  config_t config = kDefaults;
+  config.rows = bench_case->world->rows;
+  config.cols = bench_case->world->cols;
+  config.filename = saved->filenames[format];
+
+  double start = MonotonicSeconds();
+  world_t* world = CreateWorld(&config);
+  double seconds = MonotonicSeconds() - start;
+
+  if (!world) {
+    return -1;
+  }
+  FreeWorldGrid(world);
+  return seconds;
+}
+
+/**
+ * @brief Times `PrintWorld` rendering one frame, including the flush of the
+ *        frame to /dev/null.
+ */
+static double RunPrintWorld(const bench_config_t* bench,
+                            const bench_case_t* bench_case,
+                            const engine_t* engine) {
+  (void)bench;
+  (void)engine;
+  config_t config = kDefaults;
+  config.rows = bench_case->world->rows;
+  config.cols = bench_case->world->cols;
+  config.debug = 1;
+
+  double start = MonotonicSeconds();
+  PrintWorld(bench_case->world, (const config_t*)&config, 0, NULL);
+  fflush(stdout);
+  return MonotonicSeconds() - start;
+}
+
+/**
+ * @brief Times `RenderFrame` redrawing the generation that follows the
+ *        workload over a frame showing the workload itself.
+ */
+static double RunRenderFrame(const bench_config_t* bench,
+                             const bench_case_t* bench_case,
+                             const engine_t* engine) {
+  (void)bench;
+  (void)engine;
+  const world_t* world = bench_case->world;
+  renderer_t* renderer = CreateRenderer(world->rows, world->cols, kAliveChar,
+                                        kDeadChar);
+  world_t* next = CreateWorldGrid(world->rows, world->cols);
+  double seconds = -1;
+  if (renderer && next &&
+      RenderFrame(renderer, world, 0) == 0) {
+    region_t region = WorldRegion(world);
+    BestEngine()->step(world, next, &region, &kConwayRule);
+
+    double start = MonotonicSeconds();
+    if (RenderFrame(renderer, (const world_t*)next, 1) == 0) {
+      seconds = MonotonicSeconds() - start;
+    }
+  }
+
+  FreeWorldGrid(next);
+  FreeRenderer(renderer);
+  return seconds;
+}
+
+/**
+ * @brief Fills the world with live cells at the density of
+ *        scripts/generate.py, from a fixed seed.
+ */
+static void FillRandom(world_t* world) {
+  uint64_t state = kRandomSeed;
+  uint64_t bytes = 0;
+  int left = 0;
+  for (size_t i = kPadding; i <= world->rows; i++) {
+    for (size_t j = kPadding; j <= world->cols; j++) {
+      if (left == 0) {
+        // xorshift64*
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        bytes = state * 0x2545F4914F6CDD1D;
+        left = 8;
+      }
+      SetCell(world, i, j, (bytes & 0xFF) < kRandomDensity);
+      bytes >>= 8;
+      left--;
+    }
+  }
+}
+
+/**
+ * @brief Places a single R-pentomino in the centre of the world.
+ */
+static void FillRPentomino(world_t* world) {
+  static const int kCells[5][2] = {{0, 1}, {0, 2}, {1, 0}, {1, 1}, {2, 1}};
+  size_t row = world->rows / 2;
+  size_t col = world->cols / 2;
+  for (int c = 0; c < 5; c++) {
+    SetCell(world, row + kCells[c][0], col + kCells[c][1], 1);
+  }
+}
+
+/**
+ * @brief Tiles the world with Gosper glider guns every `kGunSpacing` cells.
+ */
+static void FillGliderGuns(world_t* world) {
+  size_t height = sizeof(kGliderGun) / sizeof(kGliderGun[0]);
+  size_t width = strlen(kGliderGun[0]);
+  for (size_t top = kPadding; top + height <= world->rows;
+       top += kGunSpacing) {
+    for (size_t left = kPadding; left + width <= world->cols;
+         left += kGunSpacing) {
+      for (size_t i = 0; i < height; i++) {
+        for (size_t j = 0; j < width; j++) {
+          if (kGliderGun[i][j] == kAliveChar) {
+            SetCell(world, top + i, left + j, 1);
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Saves a world to a temporary pattern file in `format`.
+ *
+ * @return Returns the name of the file, to be freed by the caller, or NULL if
+ *         the file cannot be written.
+ */
+static char* SaveTempWorld(const world_t* world, pattern_format_t format) {
+  const char* extension = format == kFormatRle      ? kRleExtension
+                          : format == kFormatBinary ? kBinaryExtension
+                                                    : ".txt";
+  char* filename = malloc(32);
+  if (!filename) {
+    return NULL;
+  }
+  snprintf(filename, 32, "/tmp/life_bench_XXXXXX%s", extension);
+
+  int fd = mkstemps(filename, (int)strlen(extension));
+  if (fd < 0) {
+    free(filename);
+    return NULL;
+  }
+  close(fd);
+
+  if (SaveWorld(world, &kConwayRule, filename, kAliveChar, kDeadChar) < 0) {
+    remove(filename);
+    free(filename);
+    return NULL;
+  }
+  return filename;
+}
+
+/**
+ * @brief Prints the usage of the benchmark harness.
+ */
+static void PrintUsage(void) {
+  fprintf(stderr, "Usage: ./life_bench [options]\n");
+  fprintf(stderr, "Options:\n");
+  fprintf(stderr, "  -s, --sizes LIST         Comma-separated world sides (default: 1000,10000)\n");
+  fprintf(stderr, "  -r, --reps NUM           Set the samples taken per benchmark (default: 5)\n");
+  fprintf(stderr, "  -n, --generations NUM    Set the generations stepped per sample (default: 10)\n");
+  fprintf(stderr, "  -t, --threads NUM        Set the number of worker threads (default: 1)\n");
+  fprintf(stderr, "  -f, --filter TEXT        Only run the benchmarks whose name contains TEXT\n");
+  fprintf(stderr, "  -l, --label TEXT         Label the rows with TEXT, such as a commit\n");
+  fprintf(stderr, "  -h, --help               Print this message\n");
+}
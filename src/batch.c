@@ -0,0 +1,372 @@
+/**
+ * batch.c
+ *
+ * Implements batch mode, which simulates every world listed by a manifest
+ * in one process and prints a summary of each. Worlds are independent, so
+ * each one runs on a single worker of the pool, and workers that run out of
+ * worlds steal from the others, keeping every thread busy however uneven the
+ * worlds are.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "batch.h"
+
+static int ReadManifest(batch_t* batch, const char* filename);
+static void RunBatchWorker(void* arg, size_t worker, size_t workers);
+static int TakeJob(batch_t* batch, size_t worker, size_t* job);
+static void RunJob(batch_t* batch, batch_scratch_t* scratch, size_t job);
+static int PrepareScratch(batch_scratch_t* scratch, const world_t* world,
+                          int wrap);
+static void PrintResults(const batch_t* batch);
+static void FreeBatch(batch_t* batch);
+
+/**
+ * @brief Simulates every world listed by the manifest `config->batch`.
+ *
+ * Each line of the manifest names a pattern file, loaded like the file of
+ * `-f`; empty lines and lines starting with `#` are skipped. Every world is
+ * simulated for `config->generations` generations with the configured
+ * engine and rule, unless its file holds a rule of its own, and stops early
+ * once it repeats itself, as with `--detect-cycles`. A CSV summary of every
+ * world is printed in the order of the manifest once they are all done.
+ *
+ * @param config The game configuration shared by every world.
+ *
+ * @return Returns 0 if every world was simulated, -1 if the manifest cannot
+ *         be read, memory allocation or the creation of the pool fails, or
+ *         any world cannot be loaded. The worlds that could be loaded are
+ *         still simulated and summarized in the last case.
+ */
+int RunBatch(const config_t* config) {
+  batch_t batch;
+  memset(&batch, 0, sizeof(batch));
+  batch.config = config;
+  if (ReadManifest(&batch, config->batch) < 0) {
+    FreeBatch(&batch);
+    return -1;
+  }
+
+  batch.workers = config->threads;
+  batch.results = calloc(batch.jobs ? batch.jobs : 1, sizeof(batch_result_t));
+  batch.ranges = calloc(batch.workers, sizeof(batch_range_t));
+  batch.scratch = calloc(batch.workers, sizeof(batch_scratch_t));
+  pool_t* pool = CreatePool(config->threads);
+  if (!batch.results || !batch.ranges || !batch.scratch || !pool) {
+    fprintf(stderr, "Error: Unable to set up the batch, memory allocation or "
+                    "thread creation failed.\n");
+    FreePool(pool);
+    FreeBatch(&batch);
+    return -1;
+  }
+
+  // Every worker starts with an equal share of the manifest
+  for (size_t w = 0; w < batch.workers; w++) {
+    batch.ranges[w].begin = batch.jobs * w / batch.workers;
+    batch.ranges[w].end = batch.jobs * (w + 1) / batch.workers;
+    pthread_mutex_init(&batch.ranges[w].lock, NULL);
+  }
+  RunPool(pool, RunBatchWorker, &batch);
+  FreePool(pool);
+
+  PrintResults(&batch);
+  int status = 0;
+  for (size_t job = 0; job < batch.jobs; job++) {
+    if (batch.results[job].failed) {
+      status = -1;
+    }
+  }
+  FreeBatch(&batch);
+  return status;
+}
+
+/**
+ * @brief Reads the manifest into a list of file names.
+ *
+ * @return Returns 0 on success, -1 if the manifest cannot be read or memory
+ *         allocation fails. An error message is printed on failure.
+ */
+static int ReadManifest(batch_t* batch, const char* filename) {
+  size_t size;
+  const char* data = MapFile(filename, &size);
+  if (!data) {
+    return -1;
+  }
+
+  // Names are split in place in a copy of the manifest, which has a line
+  // per name at most
+  batch->manifest = malloc(size + 1);
+  batch->filenames = malloc((size / 2 + 1) * sizeof(char*));
+  if (!batch->manifest || !batch->filenames) {
+    fprintf(stderr, "Error: Unable to read manifest, memory allocation "
+                    "failed\n");
+    UnmapFile(data, size);
+    return -1;
+  }
+  memcpy(batch->manifest, data, size);
+  batch->manifest[size] = '\0';
+  UnmapFile(data, size);
+
+  char* line = batch->manifest;
+  char* end = batch->manifest + size;
+  while (line < end) {
+    char* newline = memchr(line, '\n', (size_t)(end - line));
+    char* stop = newline ? newline : end;
+    if (stop > line && stop[-1] == '\r') {
+      stop--;
+    }
+    *stop = '\0';
+    if (line[0] != '\0' && line[0] != '#') {
+      batch->filenames[batch->jobs++] = line;
+    }
+    line = newline ? newline + 1 : end;
+  }
+  return 0;
+}
+
+/**
+ * @brief Runs the jobs of one worker of the batch, stealing more until none
+ *        is left.
+ *
+ * @param arg     A pointer to the `batch_t` being run.
+ * @param worker  The index of the calling worker.
+ * @param workers The number of workers sharing the batch.
+ */
+static void RunBatchWorker(void* arg, size_t worker, size_t workers) {
+  (void)workers;
+  batch_t* batch = arg;
+  size_t job;
+  while (TakeJob(batch, worker, &job)) {
+    RunJob(batch, &batch->scratch[worker], job);
+  }
+}
+
+/**
+ * @brief Takes the next job of a worker, from its own range if it has any
+ *        left, or else by stealing the back half of the largest range left.
+ *
+ * @param batch  The batch being run.
+ * @param worker The index of the calling worker.
+ * @param job    Receives the index of the job taken.
+ *
+ * @return Returns 1 if a job was taken, 0 if every range is empty.
+ */
+static int TakeJob(batch_t* batch, size_t worker, size_t* job) {
+  batch_range_t* own = &batch->ranges[worker];
+  pthread_mutex_lock(&own->lock);
+  int found = own->begin < own->end;
+  if (found) {
+    *job = own->begin++;
+  }
+  pthread_mutex_unlock(&own->lock);
+  if (found) {
+    return 1;
+  }
+
+  for (;;) {
+    size_t victim = worker;
+    size_t largest = 0;
+    for (size_t w = 0; w < batch->workers; w++) {
+      pthread_mutex_lock(&batch->ranges[w].lock);
+      size_t left = batch->ranges[w].end - batch->ranges[w].begin;
+      pthread_mutex_unlock(&batch->ranges[w].lock);
+      if (left > largest) {
+        victim = w;
+        largest = left;
+      }
+    }
+    if (largest == 0) {
+      return 0;
+    }
+
+    // The victim may have drained its range since it was measured
+    batch_range_t* range = &batch->ranges[victim];
+    pthread_mutex_lock(&range->lock);
+    size_t left = range->end - range->begin;
+    size_t begin = range->end - (left + 1) / 2;
+    size_t end = range->end;
+    range->end = begin;
+    pthread_mutex_unlock(&range->lock);
+    if (left == 0) {
+      continue;
+    }
+
+    pthread_mutex_lock(&own->lock);
+    own->begin = begin + 1;
+    own->end = end;
+    pthread_mutex_unlock(&own->lock);
+    *job = begin;
+    return 1;
+  }
+}
+
+/**
+ * @brief Loads and simulates one world of the batch, and records its
+ *        summary.
+ *
+ * The world is stepped on the calling worker alone, with the tile map and
+ * the second buffer of the worker, and hashed to detect when it repeats
+ * itself. Once it does, the whole periods left are skipped, as in
+ * `PlayGame`, since they lead back to a generation already seen.
+ */
+static void RunJob(batch_t* batch, batch_scratch_t* scratch, size_t job) {
+  const config_t* config = batch->config;
+  batch_result_t* result = &batch->results[job];
+  rule_t rule = config->rule;
+  world_t* current = LoadWorld(batch->filenames[job], config->rows,
+                               config->cols, kAliveChar, &rule);
+  if (!current) {
+    result->failed = 1;
+    return;
+  }
+  if (config->rule_given) {
+    rule = config->rule;
+  } else if (rule.birth & 1) {
+    char text[kRuleTextSize];
+    FormatRule(&rule, text);
+    fprintf(stderr, "Error: Rules with B0 are not supported, '%s'\n", text);
+    FreeWorldGrid(current);
+    result->failed = 1;
+    return;
+  }
+  if (PrepareScratch(scratch, (const world_t*)current, config->wrap) < 0) {
+    fprintf(stderr, "Error: Unable to create world, memory allocation "
+                    "failed\n");
+    FreeWorldGrid(current);
+    result->failed = 1;
+    return;
+  }
+
+  world_t* next = scratch->next;
+  tiles_t* tiles = scratch->tiles;
+  cycle_t cycle;
+  ClearCycle(&cycle);
+  RecordGeneration(&cycle, WorldHash((const tiles_t*)tiles));
+  int detecting = 1;
+
+  size_t gen = 0;
+  for (;;) {
+    // A world that has not died out once it repeats itself never will
+    if (detecting && !result->extinct &&
+        IsWorldEmpty((const world_t*)current)) {
+      result->extinct = 1;
+      result->extinction = gen;
+    }
+    if (gen == config->generations) {
+      break;
+    }
+
+    if (config->wrap) {
+      FillHalo(current);
+    }
+    StepTileRows(config->engine, &rule, (const world_t*)current, next, tiles,
+                 0, tiles->rows);
+    SwapTiles(tiles);
+    if (config->wrap) {
+      ClearHalo(current);
+    }
+    world_t* tmp = current;
+    current = next;
+    next = tmp;
+    gen++;
+
+    size_t period = 0;
+    if (detecting) {
+      period = RecordGeneration(&cycle, WorldHash((const tiles_t*)tiles));
+    }
+    if (period) {
+      result->period = period;
+      gen += (config->generations - gen) / period * period;
+      detecting = 0;
+    }
+  }
+
+  result->rows = current->rows;
+  result->cols = current->cols;
+  result->population = CountPopulation((const world_t*)current);
+  // The buffer left over is kept for the next job
+  scratch->next = next;
+  FreeWorldGrid(current);
+}
+
+/**
+ * @brief Makes the buffers of a worker fit a world, reusing them if the
+ *        previous world had the same size.
+ *
+ * @return Returns 0 on success, -1 if memory allocation fails.
+ */
+static int PrepareScratch(batch_scratch_t* scratch, const world_t* world,
+                          int wrap) {
+  if (!scratch->next || scratch->next->rows != world->rows ||
+      scratch->next->cols != world->cols) {
+    FreeWorldGrid(scratch->next);
+    FreeTiles(scratch->tiles);
+    scratch->next = CreateWorldGrid(world->rows, world->cols);
+    scratch->tiles = CreateTiles(world, wrap);
+    if (!scratch->next || !scratch->tiles) {
+      FreeWorldGrid(scratch->next);
+      FreeTiles(scratch->tiles);
+      scratch->next = NULL;
+      scratch->tiles = NULL;
+      return -1;
+    }
+  } else {
+    // Every tile is recomputed by the first generation, so whatever the
+    // buffer still holds is overwritten
+    MarkAllTilesChanged(scratch->tiles);
+  }
+  return EnableTileHashes(scratch->tiles, world);
+}
+
+/**
+ * @brief Prints the summary of every world of the batch as CSV.
+ *
+ * Worlds that failed to load have an `error` status and no other field. The
+ * period and the extinction generation are left empty when the world did
+ * not repeat itself or die out.
+ */
+static void PrintResults(const batch_t* batch) {
+  printf("file,status,rows,columns,generations,population,period,"
+         "extinction\n");
+  for (size_t job = 0; job < batch->jobs; job++) {
+    const batch_result_t* result = &batch->results[job];
+    if (result->failed) {
+      printf("%s,error,,,,,,\n", batch->filenames[job]);
+      continue;
+    }
+
+    printf("%s,ok,%zu,%zu,%zu,%zu,", batch->filenames[job], result->rows,
+           result->cols, batch->config->generations, result->population);
+    if (result->period) {
+      printf("%zu", result->period);
+    }
+    putchar(',');
+    if (result->extinct) {
+      printf("%zu", result->extinction);
+    }
+    putchar('\n');
+  }
+}
+
+/**
+ * @brief Frees everything held by a batch.
+ */
+static void FreeBatch(batch_t* batch) {
+  if (batch->scratch) {
+    for (size_t w = 0; w < batch->workers; w++) {
+      FreeWorldGrid(batch->scratch[w].next);
+      FreeTiles(batch->scratch[w].tiles);
+    }
+  }
+  if (batch->ranges) {
+    for (size_t w = 0; w < batch->workers; w++) {
+      pthread_mutex_destroy(&batch->ranges[w].lock);
+    }
+  }
+  free(batch->scratch);
+  free(batch->ranges);
+  free(batch->results);
+  free(batch->filenames);
+  free(batch->manifest);
+}
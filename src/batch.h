@@ -0,0 +1,56 @@
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cycle.h"
+#include "life.h"
+#include "loader.h"
+#include "pool.h"
+#include "tiles.h"
+#include "world.h"
+
+// Summary of one world of a batch
+typedef struct {
+  int failed;         // Whether the world could not be loaded
+  size_t rows;
+  size_t cols;
+  size_t population;  // Live cells at the last generation
+  size_t period;      // Period of the cycle the world reached, or 0
+  int extinct;        // Whether the world died out
+  size_t extinction;  // First generation without live cells, if `extinct`
+} batch_result_t;
+
+// Jobs owned by one worker of a batch, [begin, end) in the manifest. The
+// owner takes jobs from the front; a worker out of jobs steals the back half
+// of the largest range left.
+typedef struct {
+  size_t begin;
+  size_t end;
+  pthread_mutex_t lock;
+} batch_range_t;
+
+// Buffers of one worker, reused by every job of the same size
+typedef struct {
+  world_t* next;   // Buffer receiving each generation
+  tiles_t* tiles;  // Tile map of the worlds of that size
+} batch_scratch_t;
+
+// Worlds simulated in batch mode and the state shared by the workers
+typedef struct {
+  const config_t* config;
+  char* manifest;            // Contents of the manifest, split into lines
+  char** filenames;          // Worlds listed by the manifest
+  size_t jobs;               // Number of worlds
+  batch_result_t* results;   // Summary of each world
+  batch_range_t* ranges;     // Jobs left to each worker
+  batch_scratch_t* scratch;  // Buffers of each worker
+  size_t workers;
+} batch_t;
+
+int RunBatch(const config_t* config);
+
+#endif  // BATCH_H_
@@ -0,0 +1,336 @@
+/**
+ * checkpoint.c
+ *
+ * Implements the checkpoints of long runs: a writer thread that saves a copy
+ * of the game in the background every so many generations, and the loading
+ * of a checkpoint to resume the game from it. Checkpoints keep the words of
+ * the world as they are in memory, so neither side spends time converting
+ * cells.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "checkpoint.h"
+
+static void* CheckpointMain(void* arg);
+
+/**
+ * @brief Creates a checkpointer and starts its writer thread.
+ *
+ * @param filename The file the checkpoints are written to, replaced by each
+ *                 of them.
+ * @param rows     The number of live rows of the world.
+ * @param cols     The number of live columns of the world.
+ * @param rule     The rule of the game, recorded in the checkpoints.
+ *
+ * @return Returns a pointer to the new checkpointer on success, or NULL if
+ *         memory allocation or the creation of the thread fails.
+ *
+ * @note The returned checkpointer must be released with `FreeCheckpointer`.
+ */
+checkpointer_t* CreateCheckpointer(const char* filename, size_t rows,
+                                   size_t cols, const rule_t* rule) {
+  checkpointer_t* checkpointer = calloc(1, sizeof(checkpointer_t));
+  if (!checkpointer) {
+    return NULL;
+  }
+
+  size_t length = strlen(filename);
+  checkpointer->filename = malloc(length + 1);
+  checkpointer->temp = malloc(length + sizeof(kCheckpointSuffix));
+  checkpointer->snapshot = CreateWorldGrid(rows, cols);
+  if (!checkpointer->filename || !checkpointer->temp ||
+      !checkpointer->snapshot) {
+    FreeWorldGrid(checkpointer->snapshot);
+    free(checkpointer->temp);
+    free(checkpointer->filename);
+    free(checkpointer);
+    return NULL;
+  }
+  memcpy(checkpointer->filename, filename, length + 1);
+  memcpy(checkpointer->temp, filename, length);
+  memcpy(checkpointer->temp + length, kCheckpointSuffix,
+         sizeof(kCheckpointSuffix));
+  checkpointer->rule = *rule;
+
+  pthread_mutex_init(&checkpointer->lock, NULL);
+  pthread_cond_init(&checkpointer->ready, NULL);
+  if (pthread_create(&checkpointer->thread, NULL, CheckpointMain,
+                     checkpointer) != 0) {
+    pthread_cond_destroy(&checkpointer->ready);
+    pthread_mutex_destroy(&checkpointer->lock);
+    FreeWorldGrid(checkpointer->snapshot);
+    free(checkpointer->temp);
+    free(checkpointer->filename);
+    free(checkpointer);
+    return NULL;
+  }
+  return checkpointer;
+}
+
+/**
+ * @brief Stops the writer thread and frees the checkpointer.
+ *
+ * A checkpoint still being written is completed first, so the last
+ * generation offered successfully is always on disk on return.
+ *
+ * @param checkpointer The checkpointer to free. It is safe to pass NULL.
+ */
+void FreeCheckpointer(checkpointer_t* checkpointer) {
+  if (!checkpointer) {
+    return;
+  }
+
+  pthread_mutex_lock(&checkpointer->lock);
+  checkpointer->stop = 1;
+  pthread_cond_signal(&checkpointer->ready);
+  pthread_mutex_unlock(&checkpointer->lock);
+  pthread_join(checkpointer->thread, NULL);
+
+  pthread_cond_destroy(&checkpointer->ready);
+  pthread_mutex_destroy(&checkpointer->lock);
+  FreeWorldGrid(checkpointer->snapshot);
+  free(checkpointer->temp);
+  free(checkpointer->filename);
+  free(checkpointer);
+}
+
+/**
+ * @brief Offers a completed generation to the writer thread.
+ *
+ * The world is copied and handed over only if the writer thread is idle; the
+ * generation is refused while the previous checkpoint is still being
+ * written, so the caller never waits for the disk.
+ *
+ * @param checkpointer The checkpointer to offer the generation to.
+ * @param world        The completed generation.
+ * @param generation   The generation number of `world`.
+ *
+ * @return Returns 0 if the generation will be written, -1 if the writer
+ *         thread is busy.
+ */
+int OfferCheckpoint(checkpointer_t* checkpointer, const world_t* world,
+                    size_t generation) {
+  pthread_mutex_lock(&checkpointer->lock);
+  int busy = checkpointer->busy;
+  pthread_mutex_unlock(&checkpointer->lock);
+  if (busy) {
+    return -1;
+  }
+
+  // An idle writer thread leaves `snapshot` alone, so it is filled outside
+  // the lock
+  CopyWorldGrid(checkpointer->snapshot, world);
+  checkpointer->generation = generation;
+
+  pthread_mutex_lock(&checkpointer->lock);
+  checkpointer->busy = 1;
+  pthread_cond_signal(&checkpointer->ready);
+  pthread_mutex_unlock(&checkpointer->lock);
+  return 0;
+}
+
+/**
+ * @brief Main loop of the writer thread.
+ *
+ * Waits for a generation to be handed over, writes it and hands `snapshot`
+ * back to the simulation, until asked to stop with no write pending.
+ *
+ * @param arg A pointer to the `checkpointer_t` to serve.
+ *
+ * @return Always NULL.
+ */
+static void* CheckpointMain(void* arg) {
+  checkpointer_t* checkpointer = arg;
+
+  for (;;) {
+    pthread_mutex_lock(&checkpointer->lock);
+    while (!checkpointer->busy && !checkpointer->stop) {
+      pthread_cond_wait(&checkpointer->ready, &checkpointer->lock);
+    }
+    int writing = checkpointer->busy;
+    pthread_mutex_unlock(&checkpointer->lock);
+
+    if (!writing) {
+      break;
+    }
+    SaveCheckpoint(checkpointer->filename, checkpointer->temp,
+                   (const world_t*)checkpointer->snapshot,
+                   &checkpointer->rule, checkpointer->generation);
+
+    pthread_mutex_lock(&checkpointer->lock);
+    checkpointer->busy = 0;
+    pthread_mutex_unlock(&checkpointer->lock);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Writes a checkpoint of a world.
+ *
+ * The checkpoint is written to `temp`, flushed to the disk and then renamed
+ * to `filename`, so `filename` always holds a complete checkpoint, either
+ * the previous one or this one.
+ *
+ * @param filename   The file the checkpoint is written to.
+ * @param temp       The temporary file written first, on the same file
+ *                   system as `filename`.
+ * @param world      The world to save.
+ * @param rule       The rule of the game.
+ * @param generation The generation number of `world`.
+ *
+ * @return Returns 0 on success, -1 if the checkpoint cannot be written. An
+ *         error message is printed on failure.
+ */
+int SaveCheckpoint(const char* filename, const char* temp,
+                   const world_t* world, const rule_t* rule,
+                   size_t generation) {
+  unsigned char page[kCheckpointHeaderSize];
+  PackCheckpointHeader(page, world, rule, generation);
+
+  int fd = open(temp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    fprintf(stderr, "Error: Failed to open file for writing, '%s'\n", temp);
+    return -1;
+  }
+
+  size_t words = world->rows * world->stride;
+  int status = WriteAll(fd, page, sizeof(page));
+  if (status == 0) {
+    status = WriteAll(fd, WorldRow(world, kPadding),
+                      words * sizeof(uint64_t));
+  }
+  if (status == 0) {
+    status = fsync(fd);
+  }
+  if (close(fd) != 0 || status != 0 || rename(temp, filename) != 0) {
+    fprintf(stderr, "Error: Failed to write checkpoint, '%s'\n", filename);
+    unlink(temp);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Loads the world saved in a checkpoint.
+ *
+ * @param filename   The checkpoint to load.
+ * @param rule       Receives the rule of the game.
+ * @param generation Receives the generation held by the checkpoint.
+ *
+ * @return Returns a pointer to the new world, or NULL if the file cannot be
+ *         read, is not a checkpoint or was written on a machine of another
+ *         byte order, or memory allocation fails. An error message is
+ *         printed in each case.
+ *
+ * @note The returned world must be released with `FreeWorldGrid`.
+ */
+world_t* LoadCheckpoint(const char* filename, rule_t* rule,
+                        size_t* generation) {
+  size_t size;
+  const char* data = MapFile(filename, &size);
+  if (!data) {
+    return NULL;
+  }
+
+  checkpoint_header_t header;
+  memset(&header, 0, sizeof(header));
+  if (size >= kCheckpointHeaderSize) {
+    memcpy(&header, data, sizeof(header));
+  }
+  if (CheckCheckpointHeader(filename, &header, size) < 0) {
+    UnmapFile(data, size);
+    return NULL;
+  }
+
+  world_t* world = CreateWorldGrid((size_t)header.rows, (size_t)header.cols);
+  if (!world) {
+    fprintf(stderr, "Error: Unable to create world, memory allocation "
+                    "failed\n");
+    UnmapFile(data, size);
+    return NULL;
+  }
+  memcpy(WorldRow(world, kPadding), data + kCheckpointHeaderSize,
+         size - kCheckpointHeaderSize);
+  UnmapFile(data, size);
+
+  rule->birth = header.birth;
+  rule->survive = header.survive;
+  *generation = (size_t)header.generation;
+  return world;
+}
+
+/**
+ * @brief Fills the header page of a checkpoint of a world.
+ *
+ * @param page       The `kCheckpointHeaderSize` bytes to fill.
+ * @param world      The world saved by the checkpoint, or any world of the
+ *                   same size.
+ * @param rule       The rule of the game.
+ * @param generation The generation number of the world saved.
+ */
+void PackCheckpointHeader(unsigned char* page, const world_t* world,
+                          const rule_t* rule, size_t generation) {
+  checkpoint_header_t header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kCheckpointMagic, sizeof(kCheckpointMagic));
+  header.order = kCheckpointOrder;
+  header.version = kCheckpointVersion;
+  header.birth = rule->birth;
+  header.survive = rule->survive;
+  header.rows = world->rows;
+  header.cols = world->cols;
+  header.stride = world->stride;
+  header.generation = generation;
+  memset(page, 0, kCheckpointHeaderSize);
+  memcpy(page, &header, sizeof(header));
+}
+
+/**
+ * @brief Checks the header of a checkpoint against the size of its file.
+ *
+ * @param filename The checkpoint, for error messages.
+ * @param header   The header read from the start of the file, zero-filled if
+ *                 the file is shorter than a header page.
+ * @param size     The size of the file, in bytes.
+ *
+ * @return Returns 0 if the file is a complete checkpoint written on a
+ *         machine of this byte order, -1 otherwise, in which case an error
+ *         message is printed.
+ */
+int CheckCheckpointHeader(const char* filename,
+                          const checkpoint_header_t* header, size_t size) {
+  if (size < kCheckpointHeaderSize ||
+      memcmp(header->magic, kCheckpointMagic, sizeof(kCheckpointMagic)) != 0 ||
+      header->version != kCheckpointVersion) {
+    fprintf(stderr, "Error: Invalid checkpoint, '%s'\n", filename);
+    return -1;
+  }
+  if (header->order != kCheckpointOrder) {
+    fprintf(stderr, "Error: Checkpoint written on a machine of another byte "
+                    "order, '%s'\n", filename);
+    return -1;
+  }
+
+  // A width this large would wrap the stride computed from it around to 0
+  if (header->cols == 0 ||
+      header->cols > SIZE_MAX - (2 * kPadding + kWordBits - 1)) {
+    fprintf(stderr, "Error: Invalid checkpoint, '%s'\n", filename);
+    return -1;
+  }
+
+  // The stride is checked against the one of a world of the same size before
+  // any memory is allocated for it, and the size of the rows only once their
+  // number is known not to overflow it
+  uint64_t stride = (header->cols + 2 * kPadding + kWordBits - 1) / kWordBits;
+  uint64_t words = (size - kCheckpointHeaderSize) / sizeof(uint64_t);
+  if (header->rows == 0 || header->stride != stride ||
+      header->rows > words / stride ||
+      header->rows * stride * sizeof(uint64_t) !=
+          size - kCheckpointHeaderSize) {
+    fprintf(stderr, "Error: Truncated checkpoint, '%s'\n", filename);
+    return -1;
+  }
+  return 0;
+}
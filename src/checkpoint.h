@@ -0,0 +1,83 @@
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "loader.h"
+#include "rule.h"
+#include "utils.h"
+#include "world.h"
+
+// Checkpoints of a running game.
+//
+// A checkpoint file holds a world exactly as it is laid out in memory, so
+// that resuming from it takes a single copy out of the mapped file. It starts
+// with a `checkpoint_header_t` padded to `kCheckpointHeaderSize` bytes, one
+// page, followed by the `rows * stride` words of the live rows in the byte
+// order of the machine that wrote them. The header records that byte order,
+// so a checkpoint moved to a machine of the other one is rejected rather
+// than misread.
+typedef struct {
+  char magic[4];        // `kCheckpointMagic`
+  uint32_t order;       // `kCheckpointOrder`, as written by the machine
+  uint32_t version;     // `kCheckpointVersion`
+  uint16_t birth;       // Birth mask of the rule
+  uint16_t survive;     // Survival mask of the rule
+  uint64_t rows;
+  uint64_t cols;
+  uint64_t stride;      // Words per row
+  uint64_t generation;  // Generation held by the checkpoint
+} checkpoint_header_t;
+
+static const char kCheckpointMagic[4] = {'L', 'I', 'F', 'C'};
+static const char kCheckpointSuffix[] = ".tmp";
+enum {
+  kCheckpointOrder = 0x01020304,
+  kCheckpointVersion = 1,
+  kCheckpointHeaderSize = 4096,
+};
+
+// Writer thread saving checkpoints in the background.
+//
+// The simulation copies a generation into `snapshot` and hands it over to
+// the thread, which writes it to a temporary file next to `filename` and
+// renames it into place once it is complete, so a crash in the middle of a
+// write leaves the previous checkpoint intact. The simulation never waits
+// for a write: a generation offered while the previous one is still being
+// written is refused, and the caller offers a later one instead.
+typedef struct {
+  world_t* snapshot;    // Copy of the generation to write
+  size_t generation;    // Generation held by `snapshot`
+  rule_t rule;          // Rule recorded in the checkpoints
+  char* filename;       // File the checkpoints are written to
+  char* temp;           // Temporary file a checkpoint is written to first
+  int busy;             // Whether `snapshot` belongs to the writer thread
+  int stop;             // Whether the writer thread should exit
+  pthread_mutex_t lock;
+  pthread_cond_t ready;
+  pthread_t thread;
+} checkpointer_t;
+
+checkpointer_t* CreateCheckpointer(const char* filename, size_t rows,
+                                   size_t cols, const rule_t* rule);
+void FreeCheckpointer(checkpointer_t* checkpointer);
+int OfferCheckpoint(checkpointer_t* checkpointer, const world_t* world,
+                    size_t generation);
+int SaveCheckpoint(const char* filename, const char* temp,
+                   const world_t* world, const rule_t* rule,
+                   size_t generation);
+world_t* LoadCheckpoint(const char* filename, rule_t* rule,
+                        size_t* generation);
+void PackCheckpointHeader(unsigned char* page, const world_t* world,
+                          const rule_t* rule, size_t generation);
+int CheckCheckpointHeader(const char* filename,
+                          const checkpoint_header_t* header, size_t size);
+
+#endif  // CHECKPOINT_H_
@@ -0,0 +1,971 @@
+/**
+ * cluster.c
+ *
+ * Implements the simulation of a world split across MPI ranks, for worlds
+ * too large for the memory of one node. Each rank steps its own block of the
+ * world and trades the one-cell halo around it with its eight neighbours
+ * every generation, computing the cells that do not depend on the halo
+ * while the messages are in flight.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "cluster.h"
+
+static int CheckClusterConfig(const config_t* config, int rank);
+static cluster_t* CreateCluster(config_t* config);
+static int LoadBlocks(cluster_t* cluster, const config_t* config,
+                      const world_t* world);
+static int PlayCluster(cluster_t* cluster, const config_t* config);
+static void StepBlock(cluster_t* cluster, const config_t* config);
+static void PostHalos(cluster_t* cluster);
+static void ApplyHalos(cluster_t* cluster);
+static void GatherBand(cluster_t* cluster, int band, world_t* dst,
+                       size_t dst_row);
+static void GatherWorld(cluster_t* cluster);
+static void WriteClusterCheckpoint(cluster_t* cluster, const config_t* config,
+                                   size_t generation);
+static void FreeCluster(cluster_t* cluster);
+static void BlockOf(const cluster_t* cluster, const int coords[2],
+                    size_t* row_offset, size_t* rows, size_t* col_offset,
+                    size_t* cols);
+static void CopyColumns(uint64_t* dst, size_t dst_col, const uint64_t* src,
+                        size_t src_col, size_t count);
+static int ReadCheckpointHeader(const char* filename,
+                                checkpoint_header_t* header);
+static int ReadPatternHeader(config_t* config, uint64_t* pattern_rows,
+                             uint64_t* pattern_cols);
+static int ReadPatternBlock(cluster_t* cluster, const char* filename);
+static int ReadAt(int fd, void* data, size_t size, off_t offset);
+
+/**
+ * @brief Returns 1 on every rank if all of them pass a non-zero `ok`, 0
+ *        otherwise, so that every rank takes the same path after a step
+ *        that may fail on some of them.
+ */
+static int AllRanks(MPI_Comm comm, int ok) {
+  int all = 0;
+  MPI_Allreduce(&ok, &all, 1, MPI_INT, MPI_MIN, comm);
+  return all;
+}
+
+/**
+ * @brief Returns the number of MPI ranks the program was started with.
+ *
+ * @note MPI must have been initialized.
+ */
+int ClusterSize(void) {
+  int ranks = 1;
+  MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+  return ranks;
+}
+
+/**
+ * @brief Runs the game across every MPI rank.
+ *
+ * Each rank parses the same command line. Every rank reads its own block
+ * straight from a checkpoint it resumes from or a binary pattern, and rank 0
+ * loads any other pattern whole and sends each rank its block, so that only
+ * worlds in those two formats may be larger than one node. Generations
+ * printed and the world
+ * saved with `--save` are gathered on rank 0, and checkpoints are written by
+ * rank 0 one row of blocks at a time, so that it never holds more than that
+ * of the world beyond its own block.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The command-line arguments, the same on every rank.
+ *
+ * @return Returns 0 on success, -1 if the configuration is invalid, the world
+ *         cannot be loaded or split across the ranks, or memory allocation
+ *         fails on any rank.
+ *
+ * @note MPI must have been initialized, and is left to the caller to
+ *       finalize.
+ */
+int RunCluster(int argc, char* argv[]) {
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  config_t config;
+  if (ConfigureGame(&config, argc, argv) != 0 ||
+      CheckClusterConfig((const config_t*)&config, rank) < 0) {
+    return -1;
+  }
+
+  cluster_t* cluster = CreateCluster(&config);
+  if (!cluster) {
+    return -1;
+  }
+
+  MPI_Barrier(cluster->comm);
+  double start = MonotonicSeconds();
+  int status = PlayCluster(cluster, (const config_t*)&config);
+  MPI_Barrier(cluster->comm);
+  double seconds = MonotonicSeconds() - start;
+
+  if (cluster->rank == 0 && config.bench) {
+    PrintBenchmark((const config_t*)&config, seconds);
+  }
+  if (config.save) {
+    GatherWorld(cluster);
+    if (cluster->rank == 0 &&
+        SaveWorld((const world_t*)cluster->gathered, &config.rule,
+                  config.save, kAliveChar, kDeadChar) < 0) {
+      status = -1;
+    }
+  }
+  FreeCluster(cluster);
+  return status;
+}
+
+/**
+ * @brief Rejects the options that are not supported across ranks.
+ *
+ * Each rank steps its block on a single thread, so ranks take the place of
+ * `-t`, and the stepping is done by the bounded engines only.
+ *
+ * @return Returns 0 if the configuration can run across ranks, -1 otherwise.
+ *         An error message is printed by rank 0.
+ */
+static int CheckClusterConfig(const config_t* config, int rank) {
+  if (config->threads > 1) {
+    if (rank == 0) {
+      fprintf(stderr, "Error: -t cannot be combined with more than one MPI "
+                      "rank, start one rank per core instead\n");
+    }
+    return -1;
+  }
+  if (config->hashlife || config->gpu || config->unbounded || config->fps ||
+      config->output || config->detect_cycles || config->batch ||
+      config->temporal_block > 1 || config->stats || config->profile ||
+      config->metrics_port) {
+    if (rank == 0) {
+      fprintf(stderr, "Error: An unbounded universe, the gpu engine, --fps, "
+                      "--output, --detect-cycles, --batch, --temporal-block, "
+                      "--stats, --profile and --metrics cannot be combined "
+                      "with more than one MPI rank\n");
+    }
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Splits the world into blocks across the ranks and loads them.
+ *
+ * Rank 0 reads the size of the world, from the pattern file or the header of
+ * the checkpoint or binary pattern, and shares it along with the rule and
+ * the first generation, filling in `config` on every rank. The ranks are
+ * then laid out on a grid as square as their number allows.
+ *
+ * @return Returns the block of the calling rank, or NULL on every rank if
+ *         any of them fails, in which case an error message is printed.
+ */
+static cluster_t* CreateCluster(config_t* config) {
+  int rank = 0;
+  int ranks = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+
+  // Only rank 0 reads the pattern; a checkpoint or binary pattern is read in
+  // parallel later
+  int binary = !config->resume &&
+               PatternFormat(config->filename) == kFormatBinary;
+  uint64_t pattern_rows = 0;
+  uint64_t pattern_cols = 0;
+  world_t* world = NULL;
+  int ok = 1;
+  if (rank == 0) {
+    if (config->resume) {
+      checkpoint_header_t header;
+      ok = ReadCheckpointHeader(config->resume, &header) == 0;
+      if (ok && ((config->rows && config->rows != header.rows) ||
+                 (config->cols && config->cols != header.cols))) {
+        fprintf(stderr, "Error: The size of the checkpoint, %zux%zu, does "
+                        "not match the size of the world\n",
+                (size_t)header.rows, (size_t)header.cols);
+        ok = 0;
+      }
+      if (ok && header.generation > config->generations) {
+        fprintf(stderr, "Error: The checkpoint is past the last generation, "
+                        "%zu\n", (size_t)header.generation);
+        ok = 0;
+      }
+      if (ok) {
+        config->rows = (size_t)header.rows;
+        config->cols = (size_t)header.cols;
+        config->first_generation = (size_t)header.generation;
+        if (!config->rule_given) {
+          config->rule.birth = header.birth;
+          config->rule.survive = header.survive;
+        }
+      }
+    } else if (binary) {
+      ok = ReadPatternHeader(config, &pattern_rows, &pattern_cols) == 0;
+    } else {
+      world = CreateWorld(config);
+      ok = world != NULL;
+    }
+  }
+
+  uint64_t shared[8] = {(uint64_t)ok, config->rows, config->cols,
+                        config->rule.birth, config->rule.survive,
+                        config->first_generation, pattern_rows,
+                        pattern_cols};
+  MPI_Bcast(shared, 8, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+  if (!shared[0]) {
+    return NULL;
+  }
+  config->rows = (size_t)shared[1];
+  config->cols = (size_t)shared[2];
+  config->rule.birth = (uint16_t)shared[3];
+  config->rule.survive = (uint16_t)shared[4];
+  config->first_generation = (size_t)shared[5];
+
+  int dims[2] = {0, 0};
+  MPI_Dims_create(ranks, 2, dims);
+  if (config->rows < (size_t)dims[0] || config->cols < (size_t)dims[1]) {
+    if (rank == 0) {
+      fprintf(stderr, "Error: The world, %zux%zu, is too small to split "
+                      "across %d ranks\n", config->rows, config->cols, ranks);
+    }
+    FreeWorldGrid(world);
+    return NULL;
+  }
+
+  cluster_t* cluster = calloc(1, sizeof(cluster_t));
+  if (!AllRanks(MPI_COMM_WORLD, cluster != NULL)) {
+    free(cluster);
+    FreeWorldGrid(world);
+    return NULL;
+  }
+
+  int periods[2] = {config->wrap, config->wrap};
+  MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periods, 0, &cluster->comm);
+  MPI_Comm_rank(cluster->comm, &cluster->rank);
+  cluster->ranks = ranks;
+  cluster->dims[0] = dims[0];
+  cluster->dims[1] = dims[1];
+  MPI_Cart_coords(cluster->comm, cluster->rank, 2, cluster->coords);
+  cluster->world_rows = config->rows;
+  cluster->world_cols = config->cols;
+  cluster->pattern_rows = (size_t)shared[6];
+  cluster->pattern_cols = (size_t)shared[7];
+
+  // Offsets of the neighbours, in the order of the directions
+  static const int kRowSteps[kDirections] = {-1, 1, 0, 0, -1, 1, -1, 1};
+  static const int kColSteps[kDirections] = {0, 0, -1, 1, -1, 1, 1, -1};
+  for (int d = 0; d < kDirections; d++) {
+    int coords[2] = {cluster->coords[0] + kRowSteps[d],
+                     cluster->coords[1] + kColSteps[d]};
+    int inside = 1;
+    for (int k = 0; k < 2; k++) {
+      if (coords[k] < 0 || coords[k] >= dims[k]) {
+        inside = config->wrap;
+        coords[k] = (coords[k] + dims[k]) % dims[k];
+      }
+    }
+    cluster->neighbours[d] = MPI_PROC_NULL;
+    if (inside) {
+      MPI_Cart_rank(cluster->comm, coords, &cluster->neighbours[d]);
+    }
+  }
+
+  size_t rows, cols;
+  BlockOf(cluster, cluster->coords, &cluster->row_offset, &rows,
+          &cluster->col_offset, &cols);
+  cluster->current = CreateWorldGrid(rows, cols);
+  cluster->next = CreateWorldGrid(rows, cols);
+  cluster->column_words = (rows + kWordBits - 1) / kWordBits;
+  for (int k = 0; k < 2; k++) {
+    cluster->send_columns[k] = calloc(cluster->column_words,
+                                      sizeof(uint64_t));
+    cluster->recv_columns[k] = calloc(cluster->column_words,
+                                      sizeof(uint64_t));
+  }
+  ok = cluster->current && cluster->next;
+  for (int k = 0; k < 2; k++) {
+    ok = ok && cluster->send_columns[k] && cluster->recv_columns[k];
+  }
+
+  if (cluster->rank == 0) {
+    // The largest block, plus a guard word for `CopyColumns`
+    size_t block_rows = (config->rows + dims[0] - 1) / dims[0];
+    size_t block_cols = (config->cols + dims[1] - 1) / dims[1];
+    size_t stride = (block_cols + 2 * kPadding + kWordBits - 1) / kWordBits;
+    cluster->block = calloc(block_rows * stride + 1, sizeof(uint64_t));
+    ok = ok && cluster->block;
+    if (!config->bench || config->save) {
+      cluster->gathered = CreateWorldGrid(config->rows, config->cols);
+      ok = ok && cluster->gathered;
+    }
+    if (config->checkpoint_every) {
+      size_t length = strlen(config->checkpoint);
+      cluster->band = CreateWorldGrid(block_rows, config->cols);
+      cluster->temp = malloc(length + sizeof(kCheckpointSuffix));
+      ok = ok && cluster->band && cluster->temp;
+      if (cluster->temp) {
+        memcpy(cluster->temp, config->checkpoint, length);
+        memcpy(cluster->temp + length, kCheckpointSuffix,
+               sizeof(kCheckpointSuffix));
+      }
+    }
+  }
+  if (!AllRanks(cluster->comm, ok)) {
+    if (cluster->rank == 0) {
+      fprintf(stderr, "Error: Unable to create block, memory allocation "
+                      "failed on some rank\n");
+    }
+    FreeWorldGrid(world);
+    FreeCluster(cluster);
+    return NULL;
+  }
+
+  ok = LoadBlocks(cluster, (const config_t*)config, (const world_t*)world);
+  FreeWorldGrid(world);
+  if (!AllRanks(cluster->comm, ok == 0)) {
+    FreeCluster(cluster);
+    return NULL;
+  }
+  return cluster;
+}
+
+/**
+ * @brief Fills the block of every rank with its part of the initial world.
+ *
+ * When resuming, each rank reads the rows of its block straight from the
+ * checkpoint, taking only the words that hold its columns, and likewise
+ * from a binary pattern. Otherwise rank 0 cuts the blocks out of `world` and
+ * sends each one to its rank.
+ *
+ * @param cluster The block of the calling rank.
+ * @param config  The game configuration.
+ * @param world   The initial world on rank 0 when it loaded the pattern
+ *                whole, NULL otherwise.
+ *
+ * @return Returns 0 on success, -1 if the checkpoint or pattern cannot be
+ *         read or memory allocation fails, in which case an error message is
+ *         printed.
+ */
+static int LoadBlocks(cluster_t* cluster, const config_t* config,
+                      const world_t* world) {
+  world_t* block = cluster->current;
+  if (!config->resume && PatternFormat(config->filename) == kFormatBinary) {
+    return ReadPatternBlock(cluster, config->filename);
+  }
+  if (config->resume) {
+    size_t stride = (cluster->world_cols + 2 * kPadding + kWordBits - 1) /
+                    kWordBits;
+    size_t first = (cluster->col_offset + kPadding) / kWordBits;
+    size_t last = (cluster->col_offset + block->cols) / kWordBits;
+    size_t words = last - first + 1;
+    uint64_t* row = calloc(words + 1, sizeof(uint64_t));
+    int fd = open(config->resume, O_RDONLY);
+    int status = row && fd >= 0 ? 0 : -1;
+    for (size_t i = kPadding; status == 0 && i <= block->rows; i++) {
+      size_t global = cluster->row_offset + i - kPadding;
+      off_t offset = (off_t)(kCheckpointHeaderSize +
+                             (global * stride + first) * sizeof(uint64_t));
+      status = ReadAt(fd, row, words * sizeof(uint64_t), offset);
+      CopyColumns(WorldRow(block, i), kPadding, row,
+                  cluster->col_offset + kPadding - first * kWordBits,
+                  block->cols);
+    }
+    if (status < 0) {
+      fprintf(stderr, "Error: Failed to read checkpoint, '%s'\n",
+              config->resume);
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+    free(row);
+    return status;
+  }
+
+  size_t words = block->rows * block->stride;
+  if (cluster->rank != 0) {
+    MPI_Recv(WorldRow(block, kPadding), (int)words, MPI_UINT64_T, 0,
+             kBlockTag, cluster->comm, MPI_STATUS_IGNORE);
+    return 0;
+  }
+
+  for (int k = cluster->ranks - 1; k >= 0; k--) {
+    int coords[2];
+    size_t row_offset, rows, col_offset, cols;
+    MPI_Cart_coords(cluster->comm, k, 2, coords);
+    BlockOf(cluster, coords, &row_offset, &rows, &col_offset, &cols);
+
+    // Rank 0 is done last, straight into its own block
+    size_t stride = (cols + 2 * kPadding + kWordBits - 1) / kWordBits;
+    uint64_t* cells = k == 0 ? WorldRow(block, kPadding) : cluster->block;
+    memset(cells, 0, rows * stride * sizeof(uint64_t));
+    for (size_t i = 0; i < rows; i++) {
+      CopyColumns(cells + i * stride, kPadding,
+                  WorldRow(world, row_offset + kPadding + i),
+                  col_offset + kPadding, cols);
+    }
+    if (k != 0) {
+      MPI_Send(cells, (int)(rows * stride), MPI_UINT64_T, k, kBlockTag,
+               cluster->comm);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Simulates the blocks for the configured number of generations.
+ *
+ * Every generation is gathered on rank 0 and printed as by `PlayGame`,
+ * unless benchmarking. With `config->checkpoint_every` set, every generation
+ * that is a multiple of it is written to a checkpoint before the game goes
+ * on; unlike `PlayGame`, the ranks wait for the write.
+ *
+ * @return Returns 0 on success, -1 if rank 0 fails to create its renderer.
+ */
+static int PlayCluster(cluster_t* cluster, const config_t* config) {
+  renderer_t* renderer = NULL;
+  int ok = 1;
+  if (cluster->rank == 0 && DrawsFrames(config)) {
+    renderer = CreateRenderer(config->rows, config->cols, kAliveChar,
+                              kDeadChar);
+    ok = renderer != NULL;
+  }
+  if (!AllRanks(cluster->comm, ok)) {
+    return -1;
+  }
+
+  size_t every = config->checkpoint_every;
+  for (size_t gen = config->first_generation; gen <= config->generations;
+       gen++) {
+    if (!config->bench && PrintsGeneration(config, gen)) {
+      GatherWorld(cluster);
+      if (cluster->rank == 0) {
+        PrintWorld((const world_t*)cluster->gathered, config, gen, renderer);
+      }
+    }
+    if (every && gen > config->first_generation && gen % every == 0) {
+      WriteClusterCheckpoint(cluster, config, gen);
+    }
+    if (gen < config->generations) {
+      StepBlock(cluster, config);
+    }
+  }
+
+  FreeRenderer(renderer);
+  return 0;
+}
+
+/**
+ * @brief Computes the next generation of the block of the calling rank.
+ *
+ * The halo messages are posted first. The cells two rows or more and one
+ * word or more away from the edges of the block depend on none of them, so
+ * they are computed while the messages travel; the frame of rows and words
+ * around them is computed once the halo is in place.
+ */
+static void StepBlock(cluster_t* cluster, const config_t* config) {
+  const world_t* src = (const world_t*)cluster->current;
+  world_t* dst = cluster->next;
+  size_t rows = src->rows;
+  size_t words = LastWord(src) + 1;
+  step_fn_t step = config->engine->step;
+
+  PostHalos(cluster);
+  if (rows > 2 && words > 2) {
+    region_t inner = {kPadding + 1, rows, 1, words - 1};
+    step(src, dst, &inner, &config->rule);
+  }
+  MPI_Waitall(2 * kDirections, cluster->requests, MPI_STATUSES_IGNORE);
+  ApplyHalos(cluster);
+
+  region_t top = {kPadding, kPadding + 1, 0, words};
+  step(src, dst, &top, &config->rule);
+  if (rows > 1) {
+    region_t bottom = {rows, rows + kPadding, 0, words};
+    step(src, dst, &bottom, &config->rule);
+  }
+  if (rows > 2) {
+    region_t left = {kPadding + 1, rows, 0, 1};
+    step(src, dst, &left, &config->rule);
+    if (words > 1) {
+      region_t right = {kPadding + 1, rows, words - 1, words};
+      step(src, dst, &right, &config->rule);
+    }
+  }
+
+  world_t* tmp = cluster->current;
+  cluster->current = cluster->next;
+  cluster->next = tmp;
+}
+
+/**
+ * @brief Posts the receives of the halo of the block and the sends of its
+ *        edges to the neighbours.
+ *
+ * Halo rows are received straight into the padding rows of the block, which
+ * nothing reads until the messages complete. Columns and corners arrive in
+ * buffers of their own, since their cells share words with the edge rows
+ * being sent, and are moved into the halo by `ApplyHalos`.
+ */
+static void PostHalos(cluster_t* cluster) {
+  world_t* world = cluster->current;
+  size_t rows = world->rows;
+  size_t cols = world->cols;
+  int stride = (int)world->stride;
+  int columns = (int)cluster->column_words;
+  MPI_Request* requests = cluster->requests;
+  const int* neighbours = cluster->neighbours;
+
+  // The halo on each side comes from the neighbour there, as a message
+  // travelling the opposite way
+  MPI_Irecv(WorldRow(world, 0), stride, MPI_UINT64_T, neighbours[kNorth],
+            kSouth, cluster->comm, &requests[0]);
+  MPI_Irecv(WorldRow(world, rows + kPadding), stride, MPI_UINT64_T,
+            neighbours[kSouth], kNorth, cluster->comm, &requests[1]);
+  MPI_Irecv(cluster->recv_columns[0], columns, MPI_UINT64_T,
+            neighbours[kWest], kEast, cluster->comm, &requests[2]);
+  MPI_Irecv(cluster->recv_columns[1], columns, MPI_UINT64_T,
+            neighbours[kEast], kWest, cluster->comm, &requests[3]);
+  for (int d = kNorthWest; d < kDirections; d++) {
+    MPI_Irecv(&cluster->recv_corners[d], 1, MPI_UINT8_T, neighbours[d],
+              d ^ 1, cluster->comm, &requests[d]);
+  }
+
+  memset(cluster->send_columns[0], 0, columns * sizeof(uint64_t));
+  memset(cluster->send_columns[1], 0, columns * sizeof(uint64_t));
+  for (size_t i = 0; i < rows; i++) {
+    uint64_t bit = (uint64_t)1 << (i % kWordBits);
+    if (GetCell(world, i + kPadding, kPadding)) {
+      cluster->send_columns[0][i / kWordBits] |= bit;
+    }
+    if (GetCell(world, i + kPadding, cols)) {
+      cluster->send_columns[1][i / kWordBits] |= bit;
+    }
+  }
+  cluster->send_corners[kNorthWest] = (uint8_t)GetCell(world, kPadding,
+                                                       kPadding);
+  cluster->send_corners[kNorthEast] = (uint8_t)GetCell(world, kPadding, cols);
+  cluster->send_corners[kSouthWest] = (uint8_t)GetCell(world, rows, kPadding);
+  cluster->send_corners[kSouthEast] = (uint8_t)GetCell(world, rows, cols);
+
+  MPI_Request* sends = requests + kDirections;
+  MPI_Isend(WorldRow(world, kPadding), stride, MPI_UINT64_T,
+            neighbours[kNorth], kNorth, cluster->comm, &sends[0]);
+  MPI_Isend(WorldRow(world, rows), stride, MPI_UINT64_T, neighbours[kSouth],
+            kSouth, cluster->comm, &sends[1]);
+  MPI_Isend(cluster->send_columns[0], columns, MPI_UINT64_T,
+            neighbours[kWest], kWest, cluster->comm, &sends[2]);
+  MPI_Isend(cluster->send_columns[1], columns, MPI_UINT64_T,
+            neighbours[kEast], kEast, cluster->comm, &sends[3]);
+  for (int d = kNorthWest; d < kDirections; d++) {
+    MPI_Isend(&cluster->send_corners[d], 1, MPI_UINT8_T, neighbours[d], d,
+              cluster->comm, &sends[d]);
+  }
+}
+
+/**
+ * @brief Moves the halo columns and corners received into the padding ring
+ *        of the block.
+ *
+ * Buffers with no neighbour to receive from are never written and stay
+ * dead, as does the halo along the edges of a bounded world.
+ */
+static void ApplyHalos(cluster_t* cluster) {
+  world_t* world = cluster->current;
+  size_t rows = world->rows;
+  size_t right = world->cols + kPadding;
+  for (size_t i = 0; i < rows; i++) {
+    uint64_t shift = i % kWordBits;
+    SetCell(world, i + kPadding, 0,
+            (int)((cluster->recv_columns[0][i / kWordBits] >> shift) & 1));
+    SetCell(world, i + kPadding, right,
+            (int)((cluster->recv_columns[1][i / kWordBits] >> shift) & 1));
+  }
+  SetCell(world, 0, 0, cluster->recv_corners[kNorthWest]);
+  SetCell(world, 0, right, cluster->recv_corners[kNorthEast]);
+  SetCell(world, rows + kPadding, 0, cluster->recv_corners[kSouthWest]);
+  SetCell(world, rows + kPadding, right, cluster->recv_corners[kSouthEast]);
+}
+
+/**
+ * @brief Gathers one row of blocks on rank 0.
+ *
+ * Every rank of the band sends its block to rank 0, which copies each one
+ * into the columns it covers in `dst`.
+ *
+ * @param cluster The block of the calling rank.
+ * @param band    The row of blocks to gather.
+ * @param dst     The world receiving the band on rank 0, as wide as the
+ *                whole world. Ignored on the other ranks.
+ * @param dst_row The row of `dst` receiving the first row of the band.
+ */
+static void GatherBand(cluster_t* cluster, int band, world_t* dst,
+                       size_t dst_row) {
+  world_t* own = cluster->current;
+  if (cluster->rank != 0) {
+    if (cluster->coords[0] == band) {
+      MPI_Send(WorldRow(own, kPadding), (int)(own->rows * own->stride),
+               MPI_UINT64_T, 0, kBlockTag, cluster->comm);
+    }
+    return;
+  }
+
+  for (int c = 0; c < cluster->dims[1]; c++) {
+    int coords[2] = {band, c};
+    int k;
+    size_t row_offset, rows, col_offset, cols;
+    MPI_Cart_rank(cluster->comm, coords, &k);
+    BlockOf(cluster, coords, &row_offset, &rows, &col_offset, &cols);
+
+    size_t stride = (cols + 2 * kPadding + kWordBits - 1) / kWordBits;
+    const uint64_t* cells = WorldRow(own, kPadding);
+    if (k != 0) {
+      MPI_Recv(cluster->block, (int)(rows * stride), MPI_UINT64_T, k,
+               kBlockTag, cluster->comm, MPI_STATUS_IGNORE);
+      cells = cluster->block;
+    }
+    for (size_t i = 0; i < rows; i++) {
+      CopyColumns(WorldRow(dst, dst_row + i), col_offset + kPadding,
+                  cells + i * stride, kPadding, cols);
+    }
+  }
+}
+
+/**
+ * @brief Gathers the whole world into `cluster->gathered` on rank 0.
+ */
+static void GatherWorld(cluster_t* cluster) {
+  for (int band = 0; band < cluster->dims[0]; band++) {
+    int coords[2] = {band, 0};
+    size_t row_offset, rows, col_offset, cols;
+    BlockOf(cluster, coords, &row_offset, &rows, &col_offset, &cols);
+    GatherBand(cluster, band, cluster->gathered, row_offset + kPadding);
+  }
+}
+
+/**
+ * @brief Writes a checkpoint of the whole world from rank 0.
+ *
+ * The file has the layout of the checkpoints of `SaveCheckpoint`, so either
+ * kind of run can resume from it. Rank 0 gathers and writes one row of
+ * blocks at a time, to a temporary file renamed into place once complete.
+ * A failed write is reported and the game goes on, as with the writer
+ * thread of `PlayGame`.
+ */
+static void WriteClusterCheckpoint(cluster_t* cluster, const config_t* config,
+                                   size_t generation) {
+  int fd = -1;
+  int status = 0;
+  world_t* band = cluster->band;
+  if (cluster->rank == 0) {
+    unsigned char page[kCheckpointHeaderSize];
+    world_t shape = {cluster->world_rows, cluster->world_cols,
+                     band->stride, NULL, 0};
+    PackCheckpointHeader(page, (const world_t*)&shape, &config->rule,
+                         generation);
+    fd = open(cluster->temp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    status = fd >= 0 ? WriteAll(fd, page, sizeof(page)) : -1;
+  }
+
+  // Every rank takes part in the gathers, even after a failed write
+  for (int b = 0; b < cluster->dims[0]; b++) {
+    GatherBand(cluster, b, band, kPadding);
+    if (cluster->rank == 0 && status == 0) {
+      int coords[2] = {b, 0};
+      size_t row_offset, rows, col_offset, cols;
+      BlockOf(cluster, coords, &row_offset, &rows, &col_offset, &cols);
+      status = WriteAll(fd, WorldRow(band, kPadding),
+                        rows * band->stride * sizeof(uint64_t));
+    }
+  }
+
+  if (cluster->rank != 0) {
+    return;
+  }
+  if (status == 0) {
+    status = fsync(fd);
+  }
+  if (fd < 0 || close(fd) != 0 || status != 0 ||
+      rename(cluster->temp, config->checkpoint) != 0) {
+    fprintf(stderr, "Error: Failed to write checkpoint, '%s'\n",
+            config->checkpoint);
+    unlink(cluster->temp);
+  }
+}
+
+/**
+ * @brief Frees a block and the buffers of its rank. It is safe to pass NULL.
+ */
+static void FreeCluster(cluster_t* cluster) {
+  if (!cluster) {
+    return;
+  }
+
+  for (int k = 0; k < 2; k++) {
+    free(cluster->send_columns[k]);
+    free(cluster->recv_columns[k]);
+  }
+  FreeWorldGrid(cluster->current);
+  FreeWorldGrid(cluster->next);
+  FreeWorldGrid(cluster->gathered);
+  FreeWorldGrid(cluster->band);
+  free(cluster->block);
+  free(cluster->temp);
+  MPI_Comm_free(&cluster->comm);
+  free(cluster);
+}
+
+/**
+ * @brief Returns the live rows and columns of the world covered by the
+ *        block at `coords`. Blocks of a row or column of the grid differ in
+ *        size by one cell at most.
+ */
+static void BlockOf(const cluster_t* cluster, const int coords[2],
+                    size_t* row_offset, size_t* rows, size_t* col_offset,
+                    size_t* cols) {
+  size_t r = (size_t)coords[0];
+  size_t c = (size_t)coords[1];
+  size_t dims_rows = (size_t)cluster->dims[0];
+  size_t dims_cols = (size_t)cluster->dims[1];
+  *row_offset = cluster->world_rows * r / dims_rows;
+  *rows = cluster->world_rows * (r + 1) / dims_rows - *row_offset;
+  *col_offset = cluster->world_cols * c / dims_cols;
+  *cols = cluster->world_cols * (c + 1) / dims_cols - *col_offset;
+}
+
+/**
+ * @brief Returns the 64 bits of a row starting at column `col`, reading the
+ *        word after it when `col` is not word-aligned.
+ */
+static inline uint64_t ReadBits(const uint64_t* row, size_t col) {
+  size_t word = col / kWordBits;
+  size_t shift = col % kWordBits;
+  if (shift == 0) {
+    return row[word];
+  }
+  return (row[word] >> shift) | (row[word + 1] << (kWordBits - shift));
+}
+
+/**
+ * @brief Replaces `count` bits of a row, between 1 and 64, starting at
+ *        column `col` with the low bits of `value`.
+ */
+static inline void WriteBits(uint64_t* row, size_t col, uint64_t value,
+                             size_t count) {
+  size_t word = col / kWordBits;
+  size_t shift = col % kWordBits;
+  uint64_t mask = count == kWordBits ? ~(uint64_t)0
+                                     : ((uint64_t)1 << count) - 1;
+  row[word] = (row[word] & ~(mask << shift)) | (value << shift);
+  if (shift && shift + count > kWordBits) {
+    size_t spill = kWordBits - shift;
+    row[word + 1] = (row[word + 1] & ~(mask >> spill)) | (value >> spill);
+  }
+}
+
+/**
+ * @brief Copies `count` columns of a row, from column `src_col` of `src` to
+ *        column `dst_col` of `dst`, a word at a time.
+ *
+ * `src` must have a readable word past the last one copied from.
+ */
+static void CopyColumns(uint64_t* dst, size_t dst_col, const uint64_t* src,
+                        size_t src_col, size_t count) {
+  while (count > 0) {
+    size_t n = count < kWordBits ? count : kWordBits;
+    uint64_t bits = ReadBits(src, src_col);
+    if (n < kWordBits) {
+      bits &= ((uint64_t)1 << n) - 1;
+    }
+    WriteBits(dst, dst_col, bits, n);
+    src_col += n;
+    dst_col += n;
+    count -= n;
+  }
+}
+
+/**
+ * @brief Reads and checks the header of a checkpoint, leaving its cells for
+ *        each rank to read.
+ *
+ * @return Returns 0 on success, -1 if the file cannot be read or is not a
+ *         valid checkpoint, in which case an error message is printed.
+ */
+static int ReadCheckpointHeader(const char* filename,
+                                checkpoint_header_t* header) {
+  int fd = open(filename, O_RDONLY);
+  struct stat info;
+  if (fd < 0 || fstat(fd, &info) != 0) {
+    fprintf(stderr, "Error: Failed to open file, '%s'\n", filename);
+    if (fd >= 0) {
+      close(fd);
+    }
+    return -1;
+  }
+
+  size_t size = (size_t)info.st_size;
+  memset(header, 0, sizeof(*header));
+  if (size >= kCheckpointHeaderSize &&
+      ReadAt(fd, header, sizeof(*header), 0) < 0) {
+    fprintf(stderr, "Error: Failed to read file, '%s'\n", filename);
+    close(fd);
+    return -1;
+  }
+  close(fd);
+  return CheckCheckpointHeader(filename, header, size);
+}
+
+/**
+ * @brief Reads and checks the header of a binary pattern, leaving its cells
+ *        for each rank to read.
+ *
+ * Fills in the size of the world along the dimensions configured as 0 and
+ * the rule of the pattern unless it was set explicitly, as `CreateWorld`
+ * does.
+ *
+ * @return Returns 0 on success, -1 if the file cannot be read, is not a
+ *         binary pattern, is truncated or the size of the world cannot be
+ *         inferred, in which case an error message is printed.
+ */
+static int ReadPatternHeader(config_t* config, uint64_t* pattern_rows,
+                             uint64_t* pattern_cols) {
+  const char* filename = config->filename;
+  int fd = open(filename, O_RDONLY);
+  struct stat info;
+  if (fd < 0 || fstat(fd, &info) != 0) {
+    fprintf(stderr, "Error: Failed to open file, '%s'\n", filename);
+    if (fd >= 0) {
+      close(fd);
+    }
+    return -1;
+  }
+
+  size_t size = (size_t)info.st_size;
+  unsigned char bytes[kBinaryHeaderSize];
+  int status = size >= kBinaryHeaderSize ? ReadAt(fd, bytes, sizeof(bytes), 0)
+                                         : -1;
+  close(fd);
+  if (status < 0 || memcmp(bytes, kBinaryMagic, sizeof(kBinaryMagic)) != 0 ||
+      bytes[4] != kBinaryVersion) {
+    fprintf(stderr, "Error: Invalid binary pattern, '%s'\n", filename);
+    return -1;
+  }
+
+  *pattern_rows = 0;
+  *pattern_cols = 0;
+  for (size_t b = 0; b < 8; b++) {
+    *pattern_rows |= (uint64_t)bytes[8 + b] << (8 * b);
+    *pattern_cols |= (uint64_t)bytes[16 + b] << (8 * b);
+  }
+  uint64_t row_bytes = (*pattern_cols + 7) / 8;
+  if (*pattern_cols > SIZE_MAX - 7 ||
+      (row_bytes &&
+       *pattern_rows > (size - kBinaryHeaderSize) / row_bytes)) {
+    fprintf(stderr, "Error: Truncated binary pattern, '%s'\n", filename);
+    return -1;
+  }
+
+  config->rows = config->rows ? config->rows : (size_t)*pattern_rows;
+  config->cols = config->cols ? config->cols : (size_t)*pattern_cols;
+  if (config->rows == 0 || config->cols == 0) {
+    fprintf(stderr, "Error: Unable to infer the size of the world, '%s' "
+                    "is empty\n", filename);
+    return -1;
+  }
+
+  rule_t rule = {(uint16_t)(bytes[24] | bytes[25] << 8),
+                 (uint16_t)(bytes[26] | bytes[27] << 8)};
+  if (!config->rule_given) {
+    if (rule.birth & 1) {
+      char text[kRuleTextSize];
+      FormatRule(&rule, text);
+      fprintf(stderr, "Error: Rules with B0 are not supported, '%s'\n", text);
+      return -1;
+    }
+    config->rule = rule;
+  }
+  return 0;
+}
+
+/**
+ * @brief Reads the block of the calling rank straight from a binary
+ *        pattern, taking only the bytes that hold its columns from each of
+ *        its rows.
+ *
+ * Rows and columns of the block past the size of the pattern stay dead.
+ *
+ * @return Returns 0 on success, -1 if the file cannot be read or memory
+ *         allocation fails, in which case an error message is printed.
+ */
+static int ReadPatternBlock(cluster_t* cluster, const char* filename) {
+  world_t* block = cluster->current;
+  size_t rows = 0;
+  size_t cols = 0;
+  if (cluster->row_offset < cluster->pattern_rows) {
+    rows = cluster->pattern_rows - cluster->row_offset;
+    rows = rows < block->rows ? rows : block->rows;
+  }
+  if (cluster->col_offset < cluster->pattern_cols) {
+    cols = cluster->pattern_cols - cluster->col_offset;
+    cols = cols < block->cols ? cols : block->cols;
+  }
+  if (rows == 0 || cols == 0) {
+    return 0;
+  }
+
+  // Column `j` of the pattern is bit `j % 8` of byte `j / 8` of its row, so
+  // the bytes read line up as the little-endian words `CopyColumns` reads
+  size_t row_bytes = (cluster->pattern_cols + 7) / 8;
+  size_t first = cluster->col_offset / 8;
+  size_t bytes = (cluster->col_offset + cols - 1) / 8 - first + 1;
+  size_t words = (bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+  uint64_t* row = malloc((words + 1) * sizeof(uint64_t));
+  int fd = open(filename, O_RDONLY);
+  int status = row && fd >= 0 ? 0 : -1;
+  for (size_t i = 0; status == 0 && i < rows; i++) {
+    off_t offset = (off_t)(kBinaryHeaderSize +
+                           (cluster->row_offset + i) * row_bytes + first);
+    memset(row, 0, (words + 1) * sizeof(uint64_t));
+    status = ReadAt(fd, row, bytes, offset);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (size_t w = 0; w < words; w++) {
+      row[w] = __builtin_bswap64(row[w]);
+    }
+#endif
+    CopyColumns(WorldRow(block, kPadding + i), kPadding, row,
+                cluster->col_offset % 8, cols);
+  }
+  if (status < 0) {
+    fprintf(stderr, "Error: Failed to read binary pattern, '%s'\n",
+            filename);
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+  free(row);
+  return status;
+}
+
+/**
+ * @brief Reads exactly `size` bytes at `offset` of a file, retrying short
+ *        and interrupted reads.
+ *
+ * @return Returns 0 on success, -1 on error or at the end of the file.
+ */
+static int ReadAt(int fd, void* data, size_t size, off_t offset) {
+  unsigned char* bytes = data;
+  while (size > 0) {
+    ssize_t count = pread(fd, bytes, size, offset);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return -1;
+    }
+    bytes += count;
+    size -= (size_t)count;
+    offset += count;
+  }
+  return 0;
+}
@@ -0,0 +1,85 @@
+#ifndef CLUSTER_H_
+#define CLUSTER_H_
+
+#include <fcntl.h>
+#include <mpi.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "checkpoint.h"
+#include "engine.h"
+#include "life.h"
+#include "loader.h"
+#include "render.h"
+#include "utils.h"
+#include "world.h"
+#include "writer.h"
+
+// Neighbours of a block, named after the direction a message travels to
+// reach them. Opposite directions differ in their lowest bit only, and each
+// halo message is tagged with the direction it travels.
+enum {
+  kNorth = 0,
+  kSouth,
+  kWest,
+  kEast,
+  kNorthWest,
+  kSouthEast,
+  kNorthEast,
+  kSouthWest,
+  kDirections,
+};
+
+// Tag of the blocks sent to and from rank 0 when loading and gathering
+enum { kBlockTag = kDirections };
+
+// Block of the world simulated by one MPI rank.
+//
+// The ranks are laid out on a grid of `dims[0]` rows by `dims[1]` columns,
+// periodic on a torus, and each one holds the block of the world at its
+// coordinates as a world of its own, `current` and `next`, double-buffered
+// like the whole world in `PlayGame`. The padding ring of a block is its
+// halo: before each generation, its rows are received from the blocks above
+// and below, its columns from the blocks on either side and its corners from
+// the four diagonal blocks. Along the edges of a bounded world there is no
+// block to receive from, and the halo stays dead.
+//
+// Rank 0 also holds the buffers the blocks are gathered into: the whole
+// world when generations are printed or saved, and one row of blocks at a
+// time to write a checkpoint.
+typedef struct {
+  MPI_Comm comm;                      // Cartesian communicator of the ranks
+  int rank;
+  int ranks;
+  int dims[2];                        // Rows and columns of blocks
+  int coords[2];                      // Position of this block
+  int neighbours[kDirections];        // Ranks around this block, or
+                                      // `MPI_PROC_NULL`
+  size_t world_rows;                  // Live rows of the whole world
+  size_t world_cols;                  // Live columns of the whole world
+  size_t pattern_rows;                // Size of the binary pattern every
+  size_t pattern_cols;                // rank reads its block from, if any
+  size_t row_offset;                  // Live rows above this block
+  size_t col_offset;                  // Live columns left of this block
+  world_t* current;
+  world_t* next;
+  size_t column_words;                // Words of a packed halo column
+  uint64_t* send_columns[2];          // West and east edges sent
+  uint64_t* recv_columns[2];          // West and east halos received
+  uint8_t send_corners[kDirections];  // Corner cells sent, per direction
+  uint8_t recv_corners[kDirections];  // Corner cells received
+  MPI_Request requests[2 * kDirections];
+  world_t* gathered;                  // Whole world on rank 0, or NULL
+  world_t* band;                      // Row of blocks on rank 0, or NULL
+  uint64_t* block;                    // Block received by rank 0, or NULL
+  char* temp;                         // Temporary file of the checkpoints
+} cluster_t;
+
+int ClusterSize(void);
+int RunCluster(int argc, char* argv[]);
+
+#endif  // CLUSTER_H_
@@ -0,0 +1,50 @@
+/**
+ * cycle.c
+ *
+ * Implements the detection of worlds that died out, settled into a still
+ * life or became an oscillator, from the hashes of consecutive generations,
+ * so that a run can skip the generations it already knows.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "cycle.h"
+
+/**
+ * @brief Empties the history of a cycle detector.
+ */
+void ClearCycle(cycle_t* cycle) {
+  memset(cycle, 0, sizeof(cycle_t));
+}
+
+/**
+ * @brief Records the hash of the next generation and checks whether the
+ *        world entered a cycle.
+ *
+ * @param cycle The cycle detector.
+ * @param hash  The hash of the generation following the last one recorded.
+ *
+ * @return Returns the period of the cycle once it is confirmed, the shortest
+ *         one if several match, or 0 if none is.
+ */
+size_t RecordGeneration(cycle_t* cycle, uint64_t hash) {
+  size_t period = 0;
+  for (size_t p = 1; p <= cycle->count; p++) {
+    size_t slot = (cycle->next + kCycleHistory - p) % kCycleHistory;
+    if (cycle->hashes[slot] == hash) {
+      period = p;
+      break;
+    }
+  }
+
+  cycle->hashes[cycle->next] = hash;
+  cycle->next = (cycle->next + 1) % kCycleHistory;
+  if (cycle->count < kCycleHistory) {
+    cycle->count++;
+  }
+
+  int confirmed = period != 0 && period == cycle->candidate;
+  cycle->candidate = period;
+  return confirmed ? period : 0;
+}
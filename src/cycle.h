@@ -0,0 +1,29 @@
+#ifndef CYCLE_H_
+#define CYCLE_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// History of the hashes of the last generations, to detect a world that
+// entered a cycle.
+//
+// A world whose hash equals the hash of the generation `P` earlier is taken
+// to repeat with period `P` once this holds for two generations in a row,
+// so that a single collision of two 64-bit hashes is not enough to end a run
+// early. Extinct worlds and still lifes have period 1. Periods up to
+// `kCycleHistory` are detected.
+enum { kCycleHistory = 64 };
+
+typedef struct {
+  uint64_t hashes[kCycleHistory];  // Ring of the hashes of past generations
+  size_t count;                    // Number of hashes in the ring
+  size_t next;                     // Slot of the next hash recorded
+  size_t candidate;                // Period matched by the last generation,
+                                   // or 0
+} cycle_t;
+
+void ClearCycle(cycle_t* cycle);
+size_t RecordGeneration(cycle_t* cycle, uint64_t hash);
+
+#endif  // CYCLE_H_
@@ -0,0 +1,219 @@
+/**
+ * display.c
+ *
+ * Implements the render thread used when the game is watched at a fixed
+ * frame rate. The thread samples the latest generation completed by the
+ * simulation through a triple buffer and draws it with the differential
+ * renderer, dropping every generation completed in between.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "display.h"
+
+static void* DisplayMain(void* arg);
+static void AdvanceDeadline(struct timespec* deadline,
+                            const struct timespec* period);
+
+/**
+ * @brief Creates a display and starts its render thread.
+ *
+ * @param renderer The renderer drawing the frames. It is used by the render
+ *                 thread alone until the display is freed.
+ * @param rows     The number of live rows of the world.
+ * @param cols     The number of live columns of the world.
+ * @param fps      The number of frames drawn per second.
+ *
+ * @return Returns a pointer to the new display on success, or NULL if memory
+ *         allocation or the creation of the thread fails.
+ *
+ * @note The returned display must be released with `FreeDisplay`.
+ */
+display_t* CreateDisplay(renderer_t* renderer, size_t rows, size_t cols,
+                         size_t fps) {
+  display_t* display = calloc(1, sizeof(display_t));
+  if (!display) {
+    return NULL;
+  }
+
+  for (size_t i = 0; i < 3; i++) {
+    display->slots[i] = CreateWorldGrid(rows, cols);
+    if (!display->slots[i]) {
+      for (size_t j = 0; j < i; j++) {
+        FreeWorldGrid(display->slots[j]);
+      }
+      free(display);
+      return NULL;
+    }
+  }
+
+  display->back = 0;
+  display->middle = 1;
+  display->front = 2;
+  display->renderer = renderer;
+  long nanoseconds = 1000000000L / (long)fps;
+  display->period.tv_sec = nanoseconds / 1000000000L;
+  display->period.tv_nsec = nanoseconds % 1000000000L;
+  pthread_mutex_init(&display->lock, NULL);
+  pthread_cond_init(&display->ready, NULL);
+
+  if (pthread_create(&display->thread, NULL, DisplayMain, display) != 0) {
+    pthread_cond_destroy(&display->ready);
+    pthread_mutex_destroy(&display->lock);
+    for (size_t i = 0; i < 3; i++) {
+      FreeWorldGrid(display->slots[i]);
+    }
+    free(display);
+    return NULL;
+  }
+  return display;
+}
+
+/**
+ * @brief Stops the render thread and frees the display.
+ *
+ * The thread draws the frame left in the triple buffer, if any, before
+ * exiting, so the last generation offered with `last` set is always shown.
+ *
+ * @param display The display to free. It is safe to pass NULL.
+ */
+void FreeDisplay(display_t* display) {
+  if (!display) {
+    return;
+  }
+
+  pthread_mutex_lock(&display->lock);
+  display->stop = 1;
+  pthread_cond_signal(&display->ready);
+  pthread_mutex_unlock(&display->lock);
+  pthread_join(display->thread, NULL);
+
+  pthread_cond_destroy(&display->ready);
+  pthread_mutex_destroy(&display->lock);
+  for (size_t i = 0; i < 3; i++) {
+    FreeWorldGrid(display->slots[i]);
+  }
+  free(display);
+}
+
+/**
+ * @brief Returns whether the render thread is waiting for a frame.
+ *
+ * Lets callers skip the work of producing a generation in displayable form,
+ * such as storing the window of an unbounded universe, when it would be
+ * dropped anyway.
+ */
+int WantsFrame(display_t* display) {
+  pthread_mutex_lock(&display->lock);
+  int wanted = display->wanted;
+  pthread_mutex_unlock(&display->lock);
+  return wanted;
+}
+
+/**
+ * @brief Offers a completed generation to the render thread.
+ *
+ * The world is only copied if the render thread is waiting for a frame, or
+ * if `last` is set, in which case the generation replaces any frame not
+ * drawn yet.
+ *
+ * @param display The display to offer the generation to.
+ * @param world   The completed generation.
+ * @param gen     The generation number of `world`.
+ * @param last    Whether `world` is the last generation of the game.
+ */
+void OfferFrame(display_t* display, const world_t* world, size_t gen,
+                int last) {
+  if (!last && !WantsFrame(display)) {
+    return;
+  }
+
+  // `back` belongs to the simulation, so it is filled outside the lock
+  CopyWorldGrid(display->slots[display->back], world);
+  display->gens[display->back] = gen;
+
+  pthread_mutex_lock(&display->lock);
+  size_t filled = display->back;
+  display->back = display->middle;
+  display->middle = filled;
+  display->fresh = 1;
+  display->wanted = 0;
+  pthread_cond_signal(&display->ready);
+  pthread_mutex_unlock(&display->lock);
+}
+
+/**
+ * @brief Main loop of the render thread.
+ *
+ * At every tick, asks the simulation for a frame, waits for it and draws it,
+ * then sleeps until the next tick. Ticks missed while drawing are skipped
+ * rather than drawn back to back.
+ *
+ * @param arg A pointer to the `display_t` to draw.
+ *
+ * @return Always NULL.
+ */
+static void* DisplayMain(void* arg) {
+  display_t* display = arg;
+  struct timespec deadline;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+  for (;;) {
+    pthread_mutex_lock(&display->lock);
+    display->wanted = 1;
+    while (!display->fresh && !display->stop) {
+      pthread_cond_wait(&display->ready, &display->lock);
+    }
+    int drawing = display->fresh;
+    if (drawing) {
+      size_t shown = display->front;
+      display->front = display->middle;
+      display->middle = shown;
+      display->fresh = 0;
+    }
+    int stop = display->stop;
+    pthread_mutex_unlock(&display->lock);
+
+    if (drawing) {
+      RenderFrame(display->renderer,
+                  (const world_t*)display->slots[display->front],
+                  display->gens[display->front]);
+    }
+    if (stop) {
+      // A frame offered after the last one drawn is still waiting
+      pthread_mutex_lock(&display->lock);
+      drawing = display->fresh;
+      pthread_mutex_unlock(&display->lock);
+      if (!drawing) {
+        break;
+      }
+      continue;
+    }
+
+    AdvanceDeadline(&deadline, &display->period);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Moves a deadline one period ahead, or to the current time if the
+ *        next tick has already passed.
+ */
+static void AdvanceDeadline(struct timespec* deadline,
+                            const struct timespec* period) {
+  deadline->tv_sec += period->tv_sec;
+  deadline->tv_nsec += period->tv_nsec;
+  if (deadline->tv_nsec >= 1000000000L) {
+    deadline->tv_sec++;
+    deadline->tv_nsec -= 1000000000L;
+  }
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if (now.tv_sec > deadline->tv_sec ||
+      (now.tv_sec == deadline->tv_sec && now.tv_nsec > deadline->tv_nsec)) {
+    *deadline = now;
+  }
+}
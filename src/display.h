@@ -0,0 +1,43 @@
+#ifndef DISPLAY_H_
+#define DISPLAY_H_
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "render.h"
+#include "world.h"
+
+// Render thread drawing the game at a fixed frame rate.
+//
+// The simulation and the render thread share a triple buffer of worlds. At
+// every tick, the render thread asks for a frame; the simulation copies the
+// next generation it completes into `back` and swaps it with `middle`, and
+// the render thread swaps `middle` with `front` before drawing it. Neither
+// side ever waits for the other to finish with a buffer, and generations
+// completed between two ticks are never copied, so the simulation runs at
+// full speed however large the world is.
+typedef struct {
+  world_t* slots[3];
+  size_t gens[3];          // Generation held by each slot
+  size_t back;             // Slot written by the simulation
+  size_t middle;           // Slot handed over to the render thread
+  size_t front;            // Slot drawn by the render thread
+  int wanted;              // Whether the render thread is waiting for a frame
+  int fresh;               // Whether `middle` holds a frame not drawn yet
+  int stop;                // Whether the render thread should exit
+  struct timespec period;  // Time between two frames
+  renderer_t* renderer;    // Renderer of the frames, owned by the thread
+  pthread_mutex_t lock;
+  pthread_cond_t ready;
+  pthread_t thread;
+} display_t;
+
+display_t* CreateDisplay(renderer_t* renderer, size_t rows, size_t cols,
+                         size_t fps);
+void FreeDisplay(display_t* display);
+int WantsFrame(display_t* display);
+void OfferFrame(display_t* display, const world_t* world, size_t gen,
+                int last);
+
+#endif  // DISPLAY_H_
@@ -0,0 +1,191 @@
+/**
+ * engine.c
+ *
+ * Implements the generation engines used to advance the world: the scalar
+ * engine, which inspects the neighbourhood of one cell at a time, and the
+ * SWAR engine, which computes 64 cells at once with bitwise arithmetic on
+ * packed words. The vectorized engines live in simd.c and the lookup table
+ * engine in lut.c; this file also picks the widest of them the CPU supports.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "engine.h"
+
+const engine_t kScalarEngine = {"scalar", StepScalar, NULL};
+const engine_t kSwarEngine = {"swar", StepSwar, NULL};
+static const engine_t kLutEngine = {"lut", StepLut, NULL};
+#ifdef LIFE_HAVE_X86_SIMD
+static const engine_t kAvx2Engine = {"avx2", StepAvx2, HasAvx2};
+static const engine_t kAvx512Engine = {"avx512", StepAvx512, HasAvx512};
+#endif
+#ifdef LIFE_HAVE_NEON
+static const engine_t kNeonEngine = {"neon", StepNeon, HasNeon};
+#endif
+
+// Engines usable with --engine, from the widest to the narrowest
+static const engine_t* const kEngines[] = {
+#ifdef LIFE_HAVE_X86_SIMD
+  &kAvx512Engine,
+  &kAvx2Engine,
+#endif
+#ifdef LIFE_HAVE_NEON
+  &kNeonEngine,
+#endif
+  &kSwarEngine,
+  &kLutEngine,
+  &kScalarEngine,
+};
+
+/**
+ * @brief Selects the widest engine supported by the running CPU.
+ *
+ * @return Returns a pointer to the first supported engine in `kEngines`,
+ *         falling back to the portable SWAR engine.
+ */
+const engine_t* BestEngine(void) {
+  for (size_t i = 0; i < sizeof(kEngines) / sizeof(kEngines[0]); i++) {
+    if (IsEngineSupported(kEngines[i])) {
+      return kEngines[i];
+    }
+  }
+  return &kSwarEngine;
+}
+
+/**
+ * @brief Looks up a generation engine by name.
+ *
+ * @param name The name of the engine, as given on the command line. The name
+ *             "auto" selects the result of `BestEngine`.
+ *
+ * @return Returns a pointer to the matching engine, or NULL if no engine has
+ *         the given name.
+ */
+const engine_t* FindEngine(const char* name) {
+  if (strcmp(name, "auto") == 0) {
+    return BestEngine();
+  }
+  for (size_t i = 0; i < sizeof(kEngines) / sizeof(kEngines[0]); i++) {
+    if (strcmp(kEngines[i]->name, name) == 0) {
+      return kEngines[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Reports whether an engine can run on the current CPU.
+ *
+ * @param engine The engine to check.
+ *
+ * @return 1 if the engine is supported, 0 otherwise.
+ */
+int IsEngineSupported(const engine_t* engine) {
+  return !engine->supported || engine->supported();
+}
+
+/**
+ * @brief Computes the next state of a cell based on its neighbors.
+ *
+ * Determines the next state of a cell at a given position (`row`, `col`) in
+ * the world by looking its neighbor count up in the birth or survival mask of
+ * `rule`. Under the classic rules of the Game of Life, a cell flips from alive
+ * to dead if it has fewer than 2 or more than 3 alive neighbors, and a dead
+ * cell becomes alive if it has exactly 3 alive neighbors.
+ *
+ * @param world The current state of the world as a bit-packed grid.
+ * @param row   The row index of the cell.
+ * @param col   The column index of the cell.
+ * @param rule  The rule deciding births and survivals.
+ *
+ * @return The new state of the cell (1 if alive, 0 if dead).
+ */
+int ComputeCellState(const world_t* world, size_t row, size_t col,
+                     const rule_t* rule) {
+  int neighbor_count = 0;
+
+  // Inspect neighboring cells
+  for (size_t i = row - 1; i <= row + 1; i++) {
+    for (size_t j = col - 1; j <= col + 1; j++) {
+      if (i == row && j == col) {
+        continue;
+      }
+      neighbor_count += GetCell(world, i, j);
+    }
+  }
+
+  return NextCellState(rule, GetCell(world, row, col), neighbor_count);
+}
+
+/**
+ * @brief Advances a region of the world one cell at a time.
+ *
+ * @param src    The world holding the current generation.
+ * @param dst    The world receiving the next generation.
+ * @param region The region of the world to compute.
+ * @param rule   The rule deciding births and survivals.
+ *
+ * @note This function relies on `ComputeCellState` to determine the next state
+ *       of each cell based on its neighbors.
+ */
+void StepScalar(const world_t* src, world_t* dst, const region_t* region,
+                const rule_t* rule) {
+  size_t col_begin = region->word_begin * kWordBits;
+  size_t col_end = region->word_end * kWordBits;
+  if (col_begin < kPadding) {
+    col_begin = kPadding;
+  }
+  if (col_end > src->cols + kPadding) {
+    col_end = src->cols + kPadding;
+  }
+
+  for (size_t i = region->row_begin; i < region->row_end; i++) {
+    for (size_t j = col_begin; j < col_end; j++) {
+      SetCell(dst, i, j, ComputeCellState(src, i, j, rule));
+    }
+  }
+}
+
+/**
+ * @brief Advances a region of the world 64 cells at a time.
+ *
+ * Computes every word of the region with `SwarStepWord`, then clears the
+ * padding columns at both ends of each row so the border stays dead.
+ *
+ * @param src     The world holding the current generation.
+ * @param dst     The world receiving the next generation.
+ * @param region  The region of the world to compute.
+ * @param birth   The birth mask of the rule.
+ * @param survive The survival mask of the rule.
+ */
+__attribute__((always_inline))
+static inline void StepSwarRule(const world_t* src, world_t* dst,
+                                const region_t* region, unsigned birth,
+                                unsigned survive) {
+  for (size_t i = region->row_begin; i < region->row_end; i++) {
+    const uint64_t* up = WorldRow(src, i - 1);
+    const uint64_t* mid = WorldRow(src, i);
+    const uint64_t* down = WorldRow(src, i + 1);
+    uint64_t* out = WorldRow(dst, i);
+
+    for (size_t k = region->word_begin; k < region->word_end; k++) {
+      out[k] = SwarStepWord(&up[k], &mid[k], &down[k], birth, survive);
+    }
+    ClearPaddingColumns(src, out, region);
+  }
+}
+
+/**
+ * @brief Advances a region of the world 64 cells at a time, with a copy of
+ *        the kernel specialized for each of the common rules.
+ *
+ * @param src    The world holding the current generation.
+ * @param dst    The world receiving the next generation.
+ * @param region The region of the world to compute.
+ * @param rule   The rule deciding births and survivals.
+ */
+void StepSwar(const world_t* src, world_t* dst, const region_t* region,
+              const rule_t* rule) {
+  LIFE_STEP_RULE(StepSwarRule, src, dst, region, rule);
+}
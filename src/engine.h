@@ -0,0 +1,110 @@
+#ifndef ENGINE_H_
+#define ENGINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rule.h"
+#include "swar.h"
+#include "world.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LIFE_HAVE_X86_SIMD 1
+#endif
+
+#if defined(__aarch64__)
+#define LIFE_HAVE_NEON 1
+#endif
+
+// Rectangle of a world made of rows [row_begin, row_end) and of words
+// [word_begin, word_end) of each of those rows, where `word_end` never goes
+// past `LastWord(world) + 1`.
+typedef struct {
+  size_t row_begin;
+  size_t row_end;
+  size_t word_begin;
+  size_t word_end;
+} region_t;
+
+// Computes the next state of `region` of `src` into `dst` under `rule`.
+typedef void (*step_fn_t)(const world_t* src, world_t* dst,
+                          const region_t* region, const rule_t* rule);
+
+// Calls KERNEL(src, dst, region, birth, survive), passing the masks of `rule`
+// as compile-time constants when it is one of `LIFE_SPECIALIZED_RULES`. Each
+// of those rules thereby gets its own copy of an inlined kernel, while any
+// other rule runs the generic copy.
+#define LIFE_STEP_RULE(KERNEL, src, dst, region, rule)                        \
+  LIFE_SPECIALIZED_RULES(LIFE_STEP_RULE_CASE, KERNEL, src, dst, region, rule) \
+  KERNEL(src, dst, region, (rule)->birth, (rule)->survive)
+
+#define LIFE_STEP_RULE_CASE(BIRTH, SURVIVE, KERNEL, src, dst, region, rule)   \
+  if ((rule)->birth == (BIRTH) && (rule)->survive == (SURVIVE)) {             \
+    KERNEL(src, dst, region, BIRTH, SURVIVE);                                 \
+  } else
+
+// Generation engine selectable from the command line
+typedef struct {
+  const char* name;
+  step_fn_t step;
+  int (*supported)(void);  // NULL if the engine runs on any CPU
+} engine_t;
+
+extern const engine_t kScalarEngine;
+extern const engine_t kSwarEngine;
+
+const engine_t* BestEngine(void);
+const engine_t* FindEngine(const char* name);
+int IsEngineSupported(const engine_t* engine);
+int ComputeCellState(const world_t* world, size_t row, size_t col,
+                     const rule_t* rule);
+void StepScalar(const world_t* src, world_t* dst, const region_t* region,
+                const rule_t* rule);
+void StepSwar(const world_t* src, world_t* dst, const region_t* region,
+              const rule_t* rule);
+void StepLut(const world_t* src, world_t* dst, const region_t* region,
+             const rule_t* rule);
+
+#ifdef LIFE_HAVE_X86_SIMD
+int HasAvx2(void);
+int HasAvx512(void);
+int HasPopcount(void);
+void StepAvx2(const world_t* src, world_t* dst, const region_t* region,
+              const rule_t* rule);
+void StepAvx512(const world_t* src, world_t* dst, const region_t* region,
+                const rule_t* rule);
+#endif
+
+#ifdef LIFE_HAVE_NEON
+int HasNeon(void);
+void StepNeon(const world_t* src, world_t* dst, const region_t* region,
+              const rule_t* rule);
+#endif
+
+/**
+ * @brief Returns the region covering every live cell of `world`.
+ */
+static inline region_t WorldRegion(const world_t* world) {
+  region_t region = {kPadding, world->rows + kPadding, 0, LastWord(world) + 1};
+  return region;
+}
+
+/**
+ * @brief Clears the padding columns a kernel wrote within `region` of `row`.
+ *
+ * Word-parallel kernels compute whole words, including the bits of the dead
+ * columns at both ends of a row. This restores those bits so the border
+ * stays dead.
+ */
+static inline void ClearPaddingColumns(const world_t* world, uint64_t* row,
+                                       const region_t* region) {
+  if (region->word_begin == 0) {
+    row[0] &= ~(uint64_t)1;
+  }
+  if (region->word_end > LastWord(world)) {
+    row[LastWord(world)] &= LastWordMask(world);
+  }
+}
+
+#endif  // ENGINE_H_
@@ -0,0 +1,271 @@
+/**
+ * gpu.cu
+ *
+ * Implements the gpu engine, which keeps the world resident on a CUDA device
+ * and computes its generations there. Each block of device threads stages
+ * its words and the ring of words around them in shared memory, then
+ * computes 64 cells per thread with the same SWAR arithmetic as the swar
+ * engine, so the generations match the other engines bit for bit.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include <cuda_runtime.h>
+
+#include "gpu.h"
+#include "swar.h"
+
+static int CheckCuda(cudaError_t status);
+
+/**
+ * @brief Reads a word of a device buffer laid out like a `world_t`, or 0
+ *        past the rows and words of the buffer.
+ *
+ * Rows [0, rows + 1] and words [-1, stride] of each row are readable, since
+ * the buffer keeps a guard word on either side.
+ */
+__device__ static inline uint64_t LoadWord(const uint64_t* cells, size_t row,
+                                           long long word, size_t rows,
+                                           size_t stride) {
+  if (row > rows + kPadding || word > (long long)stride) {
+    return 0;
+  }
+  return cells[(long long)(row * stride) + word];
+}
+
+/**
+ * @brief Computes one generation of a block of words.
+ *
+ * Each thread stages its word in `tile`, and the threads along the edges of
+ * the block also stage the ring of words around it, so every word the block
+ * reads from the device memory is read once. The words of a row past the
+ * live columns are cleared, since they never hold live cells.
+ */
+__global__ static void StepKernel(const uint64_t* src, uint64_t* dst,
+                                  size_t rows, size_t stride, size_t words,
+                                  uint64_t last_mask, unsigned birth,
+                                  unsigned survive) {
+  __shared__ uint64_t tile[kGpuBlockRows + 2][kGpuBlockWords + 2];
+  size_t tx = threadIdx.x + 1;
+  size_t ty = threadIdx.y + 1;
+  long long k = (long long)(blockIdx.x * kGpuBlockWords + threadIdx.x);
+  size_t i = kPadding + blockIdx.y * kGpuBlockRows + threadIdx.y;
+
+  tile[ty][tx] = LoadWord(src, i, k, rows, stride);
+  if (threadIdx.y == 0) {
+    tile[0][tx] = LoadWord(src, i - 1, k, rows, stride);
+  }
+  if (threadIdx.y == kGpuBlockRows - 1) {
+    tile[ty + 1][tx] = LoadWord(src, i + 1, k, rows, stride);
+  }
+  if (threadIdx.x == 0) {
+    tile[ty][0] = LoadWord(src, i, k - 1, rows, stride);
+    if (threadIdx.y == 0) {
+      tile[0][0] = LoadWord(src, i - 1, k - 1, rows, stride);
+    }
+    if (threadIdx.y == kGpuBlockRows - 1) {
+      tile[ty + 1][0] = LoadWord(src, i + 1, k - 1, rows, stride);
+    }
+  }
+  if (threadIdx.x == kGpuBlockWords - 1) {
+    tile[ty][tx + 1] = LoadWord(src, i, k + 1, rows, stride);
+    if (threadIdx.y == 0) {
+      tile[0][tx + 1] = LoadWord(src, i - 1, k + 1, rows, stride);
+    }
+    if (threadIdx.y == kGpuBlockRows - 1) {
+      tile[ty + 1][tx + 1] = LoadWord(src, i + 1, k + 1, rows, stride);
+    }
+  }
+  __syncthreads();
+
+  if (i > rows || k >= (long long)stride) {
+    return;
+  }
+  uint64_t out = 0;
+  if (k < (long long)words) {
+    out = SwarStepWord(&tile[ty - 1][tx], &tile[ty][tx], &tile[ty + 1][tx],
+                       birth, survive);
+    if (k == 0) {
+      out &= ~(uint64_t)1;
+    }
+    if (k == (long long)words - 1) {
+      out &= last_mask;
+    }
+  }
+  dst[i * stride + k] = out;
+}
+
+/**
+ * @brief Copies the last live column of every row into its left padding
+ *        column and the first one into its right padding column, as
+ *        `FillHalo` does.
+ */
+__global__ static void FillDeviceHaloColumns(uint64_t* cells, size_t rows,
+                                             size_t cols, size_t stride) {
+  size_t i = kPadding + blockIdx.x * blockDim.x + threadIdx.x;
+  if (i > rows) {
+    return;
+  }
+
+  uint64_t* row = cells + i * stride;
+  size_t right = cols + kPadding;
+  uint64_t last = (row[cols / kWordBits] >> (cols % kWordBits)) & 1;
+  uint64_t first = (row[0] >> kPadding) & 1;
+  row[0] = (row[0] & ~(uint64_t)1) | last;
+  uint64_t bit = (uint64_t)1 << (right % kWordBits);
+  row[right / kWordBits] = (row[right / kWordBits] & ~bit) |
+                           (first ? bit : 0);
+}
+
+/**
+ * @brief Copies the last live row, padding included, into the top padding
+ *        row and the first one into the bottom padding row, as `FillHalo`
+ *        does once the padding columns are filled.
+ */
+__global__ static void FillDeviceHaloRows(uint64_t* cells, size_t rows,
+                                          size_t stride) {
+  size_t k = blockIdx.x * blockDim.x + threadIdx.x;
+  if (k >= stride) {
+    return;
+  }
+  cells[k] = cells[rows * stride + k];
+  cells[(rows + kPadding) * stride + k] = cells[kPadding * stride + k];
+}
+
+/**
+ * @brief Copies a world to the device.
+ *
+ * @param world The initial world.
+ * @param wrap  Non-zero if the world wraps around its edges.
+ *
+ * @return Returns a pointer to the device world, or NULL if memory
+ *         allocation or the copy fails. An error message is printed if the
+ *         device fails.
+ *
+ * @note The returned world must be released with `FreeGpuWorld`.
+ */
+gpu_world_t* CreateGpuWorld(const world_t* world, int wrap) {
+  gpu_world_t* gpu = (gpu_world_t*)calloc(1, sizeof(gpu_world_t));
+  if (!gpu) {
+    return NULL;
+  }
+  gpu->rows = world->rows;
+  gpu->cols = world->cols;
+  gpu->stride = world->stride;
+  gpu->wrap = wrap;
+
+  // Each buffer has the guard words of a `world_t` around it
+  size_t words = (world->rows + 2 * kPadding) * world->stride + 2;
+  size_t bytes = words * sizeof(uint64_t);
+  if (!CheckCuda(cudaMalloc((void**)&gpu->buffers, 2 * bytes))) {
+    free(gpu);
+    return NULL;
+  }
+  gpu->current = gpu->buffers + 1;
+  gpu->next = gpu->buffers + words + 1;
+  if (!CheckCuda(cudaMemset(gpu->buffers, 0, 2 * bytes)) ||
+      !CheckCuda(cudaMemcpy(gpu->current - 1, world->cells - 1, bytes,
+                            cudaMemcpyHostToDevice))) {
+    FreeGpuWorld(gpu);
+    return NULL;
+  }
+  return gpu;
+}
+
+/**
+ * @brief Frees a device world created by `CreateGpuWorld`.
+ *
+ * @param gpu The device world to free. It is safe to pass NULL.
+ */
+void FreeGpuWorld(gpu_world_t* gpu) {
+  if (gpu) {
+    cudaFree(gpu->buffers);
+    free(gpu);
+  }
+}
+
+/**
+ * @brief Advances a device world by a number of generations.
+ *
+ * The kernels of every generation are queued back to back without waiting
+ * for them, and the host only waits once they are all queued.
+ *
+ * @param gpu         The device world to advance.
+ * @param rule        The rule deciding births and survivals.
+ * @param generations The number of generations to compute.
+ *
+ * @return Returns 0 on success, -1 if the device fails, in which case an
+ *         error message is printed.
+ */
+int StepGpuWorld(gpu_world_t* gpu, const rule_t* rule, size_t generations) {
+  size_t words = gpu->cols / kWordBits + 1;
+  size_t bits = gpu->cols % kWordBits + 1;
+  uint64_t last_mask = bits == kWordBits ? ~(uint64_t)0
+                                         : ((uint64_t)1 << bits) - 1;
+  dim3 block(kGpuBlockWords, kGpuBlockRows);
+  dim3 grid((unsigned)((gpu->stride + kGpuBlockWords - 1) / kGpuBlockWords),
+            (unsigned)((gpu->rows + kGpuBlockRows - 1) / kGpuBlockRows));
+  unsigned halo_threads = 256;
+  unsigned row_blocks = (unsigned)((gpu->rows + halo_threads - 1) /
+                                   halo_threads);
+  unsigned word_blocks = (unsigned)((gpu->stride + halo_threads - 1) /
+                                    halo_threads);
+
+  for (size_t g = 0; g < generations; g++) {
+    if (gpu->wrap) {
+      FillDeviceHaloColumns<<<row_blocks, halo_threads>>>(
+          gpu->current, gpu->rows, gpu->cols, gpu->stride);
+      FillDeviceHaloRows<<<word_blocks, halo_threads>>>(
+          gpu->current, gpu->rows, gpu->stride);
+    }
+    StepKernel<<<grid, block>>>(gpu->current, gpu->next, gpu->rows,
+                                gpu->stride, words, last_mask, rule->birth,
+                                rule->survive);
+
+    uint64_t* tmp = gpu->current;
+    gpu->current = gpu->next;
+    gpu->next = tmp;
+  }
+  if (!CheckCuda(cudaGetLastError()) ||
+      !CheckCuda(cudaDeviceSynchronize())) {
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Copies the current generation of a device world to the host.
+ *
+ * Only the live rows are copied; the padding rows of `world` are left dead.
+ *
+ * @param gpu   The device world.
+ * @param world The host world receiving the generation, of the same size.
+ *
+ * @return Returns 0 on success, -1 if the copy fails, in which case an error
+ *         message is printed.
+ */
+int DownloadGpuWorld(const gpu_world_t* gpu, world_t* world) {
+  size_t bytes = gpu->rows * gpu->stride * sizeof(uint64_t);
+  if (!CheckCuda(cudaMemcpy(WorldRow(world, kPadding),
+                            gpu->current + kPadding * gpu->stride, bytes,
+                            cudaMemcpyDeviceToHost))) {
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Reports a failed CUDA call.
+ *
+ * @return Returns 1 if `status` is a success, 0 otherwise, in which case an
+ *         error message is printed.
+ */
+static int CheckCuda(cudaError_t status) {
+  if (status != cudaSuccess) {
+    fprintf(stderr, "Error: The gpu engine failed, '%s'\n",
+            cudaGetErrorString(status));
+    return 0;
+  }
+  return 1;
+}
@@ -0,0 +1,49 @@
+#ifndef GPU_H_
+#define GPU_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "rule.h"
+#include "world.h"
+
+// World resident in the memory of a CUDA device.
+//
+// `current` and `next` are laid out exactly like the cells of a `world_t`,
+// guard words included, so a world moves between the host and the device
+// with a single copy. The generations are computed on the device from one
+// buffer into the other, and the host only sees a generation when it asks
+// for one with `DownloadGpuWorld`.
+typedef struct {
+  size_t rows;
+  size_t cols;
+  size_t stride;      // Words per row, as in `world_t`
+  int wrap;           // Whether the world wraps around its edges
+  uint64_t* buffers;  // Both device buffers, guard words included
+  uint64_t* current;  // Device cells of the current generation
+  uint64_t* next;     // Device cells receiving the next generation
+} gpu_world_t;
+
+// Words and rows of the world computed by one block of device threads, one
+// word per thread
+enum {
+  kGpuBlockWords = 32,
+  kGpuBlockRows = 8,
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+gpu_world_t* CreateGpuWorld(const world_t* world, int wrap);
+void FreeGpuWorld(gpu_world_t* gpu);
+int StepGpuWorld(gpu_world_t* gpu, const rule_t* rule, size_t generations);
+int DownloadGpuWorld(const gpu_world_t* gpu, world_t* world);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // GPU_H_
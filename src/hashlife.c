@@ -0,0 +1,644 @@
+/**
+ * hashlife.c
+ *
+ * Implements Gosper's HashLife algorithm. The universe is a quadtree whose
+ * nodes are hash-consed, and every node memoizes the centre of its square
+ * 2^k generations later. Repetitive patterns, in space or in time, are then
+ * computed once, which lets a single step jump over an enormous number of
+ * generations.
+ *
+ * Unlike the other engines, the HashLife universe has no border: patterns
+ * leaving the rows x cols window of the world keep evolving outside it.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "hashlife.h"
+
+// Number of nodes allocated at once
+#define kSlabNodes 4096
+
+struct node_slab_t {
+  node_slab_t* next;
+  node_t nodes[kSlabNodes];
+};
+
+static const size_t kInitialTableSize = (size_t)1 << 16;
+// Level of the blocks `BuildNode` checks for emptiness in a single pass
+static const uint8_t kBlockLevel = 6;
+// Marks a node without a memoized result
+static const uint8_t kNoResult = 0xFF;
+
+static node_t* JoinNodes(hashlife_t* life, node_t* nw, node_t* ne, node_t* sw,
+                         node_t* se);
+static node_t* EmptyNode(hashlife_t* life, uint8_t level);
+static node_t* AdvanceNode(hashlife_t* life, node_t* node, uint8_t step_log);
+
+/**
+ * @brief Creates an empty HashLife universe.
+ *
+ * @param memory_limit The memory, in bytes, the nodes and the hash table of
+ *                     the universe may take. A step reaching it collects the
+ *                     garbage and goes on in smaller steps, and fails if the
+ *                     universe still does not fit.
+ * @param rule         The rule the universe evolves under. It must not
+ *                     include B0, which would fill the empty plane.
+ *
+ * @return Returns a pointer to the new universe, or NULL if memory allocation
+ *         fails.
+ *
+ * @note The returned universe must be released with `FreeHashLife`.
+ */
+hashlife_t* CreateHashLife(size_t memory_limit, const rule_t* rule) {
+  hashlife_t* life = calloc(1, sizeof(hashlife_t));
+  if (!life) {
+    return NULL;
+  }
+
+  life->memory_limit = memory_limit;
+  life->rule = *rule;
+  life->table_size = kInitialTableSize;
+  life->table = calloc(life->table_size, sizeof(node_t*));
+  if (!life->table) {
+    free(life);
+    return NULL;
+  }
+
+  for (int i = 0; i < 2; i++) {
+    life->leaves[i].population = (uint64_t)i;
+    life->leaves[i].result_log = kNoResult;
+  }
+  life->empty[0] = &life->leaves[0];
+  life->root = EmptyNode(life, 3);
+  if (!life->root) {
+    FreeHashLife(life);
+    return NULL;
+  }
+
+  return life;
+}
+
+/**
+ * @brief Frees a universe created by `CreateHashLife`.
+ *
+ * @param life The universe to free. It is safe to pass NULL.
+ */
+void FreeHashLife(hashlife_t* life) {
+  if (life) {
+    while (life->slabs) {
+      node_slab_t* next = life->slabs->next;
+      free(life->slabs);
+      life->slabs = next;
+    }
+    free(life->table);
+    free(life);
+  }
+}
+
+/**
+ * @brief Returns the memory held by the live nodes of a universe and its hash
+ *        table, in bytes.
+ */
+size_t HashLifeMemory(const hashlife_t* life) {
+  return life->node_count * sizeof(node_t) +
+         life->table_size * sizeof(node_t*);
+}
+
+/**
+ * @brief Hashes the four children of a node.
+ */
+static inline size_t HashChildren(const node_t* nw, const node_t* ne,
+                                  const node_t* sw, const node_t* se) {
+  uint64_t h = (uint64_t)(uintptr_t)nw;
+  h = h * 0x9E3779B97F4A7C15ULL + (uint64_t)(uintptr_t)ne;
+  h = h * 0x9E3779B97F4A7C15ULL + (uint64_t)(uintptr_t)sw;
+  h = h * 0x9E3779B97F4A7C15ULL + (uint64_t)(uintptr_t)se;
+  return (size_t)(h ^ (h >> 29));
+}
+
+/**
+ * @brief Doubles the number of buckets of the hash table.
+ *
+ * @return Returns 0 on success, -1 if memory allocation fails, in which case
+ *         the table is left as it was.
+ */
+static int GrowTable(hashlife_t* life) {
+  size_t size = life->table_size * 2;
+  node_t** table = calloc(size, sizeof(node_t*));
+  if (!table) {
+    return -1;
+  }
+
+  for (size_t i = 0; i < life->table_size; i++) {
+    node_t* node = life->table[i];
+    while (node) {
+      node_t* next = node->next;
+      size_t bucket = HashChildren(node->nw, node->ne, node->sw, node->se) &
+                      (size - 1);
+      node->next = table[bucket];
+      table[bucket] = node;
+      node = next;
+    }
+  }
+
+  free(life->table);
+  life->table = table;
+  life->table_size = size;
+  return 0;
+}
+
+/**
+ * @brief Takes a node from the free list, allocating a new slab if needed.
+ *
+ * @return Returns a pointer to an unused node, or NULL if memory allocation
+ *         fails.
+ */
+static node_t* AllocateNode(hashlife_t* life) {
+  if (!life->free_nodes) {
+    node_slab_t* slab = malloc(sizeof(node_slab_t));
+    if (!slab) {
+      return NULL;
+    }
+    slab->next = life->slabs;
+    life->slabs = slab;
+    for (size_t i = 0; i < kSlabNodes; i++) {
+      slab->nodes[i].next = life->free_nodes;
+      life->free_nodes = &slab->nodes[i];
+    }
+  }
+
+  node_t* node = life->free_nodes;
+  life->free_nodes = node->next;
+  return node;
+}
+
+/**
+ * @brief Returns the canonical node with the given four children.
+ *
+ * Looks the children up in the hash table and returns the existing node if
+ * there is one, creating and inserting it otherwise.
+ *
+ * @return Returns a pointer to the node, or NULL if memory allocation fails
+ *         or a new node would take the universe past its memory limit, in
+ *         which case `life->exhausted` is set.
+ */
+static node_t* JoinNodes(hashlife_t* life, node_t* nw, node_t* ne, node_t* sw,
+                         node_t* se) {
+  if (!nw || !ne || !sw || !se) {
+    return NULL;
+  }
+
+  size_t bucket = HashChildren(nw, ne, sw, se) & (life->table_size - 1);
+  for (node_t* node = life->table[bucket]; node; node = node->next) {
+    if (node->nw == nw && node->ne == ne && node->sw == sw && node->se == se) {
+      return node;
+    }
+  }
+
+  if (HashLifeMemory(life) + sizeof(node_t) > life->memory_limit) {
+    life->exhausted = 1;
+    return NULL;
+  }
+  node_t* node = AllocateNode(life);
+  if (!node) {
+    return NULL;
+  }
+  node->nw = nw;
+  node->ne = ne;
+  node->sw = sw;
+  node->se = se;
+  node->result = NULL;
+  node->population = nw->population + ne->population + sw->population +
+                     se->population;
+  node->level = nw->level + 1;
+  node->result_log = kNoResult;
+  node->marked = 0;
+  node->next = life->table[bucket];
+  life->table[bucket] = node;
+
+  // A table that fails to grow, or would not fit under the cap, only gets
+  // slower
+  if (++life->node_count > life->table_size &&
+      HashLifeMemory(life) + life->table_size * 2 * sizeof(node_t*) <=
+          life->memory_limit) {
+    GrowTable(life);
+  }
+  return node;
+}
+
+/**
+ * @brief Returns the empty node of the given level.
+ *
+ * @return Returns a pointer to the node, or NULL if memory allocation fails.
+ */
+static node_t* EmptyNode(hashlife_t* life, uint8_t level) {
+  if (!life->empty[level]) {
+    node_t* child = EmptyNode(life, level - 1);
+    life->empty[level] = JoinNodes(life, child, child, child, child);
+  }
+  return life->empty[level];
+}
+
+/**
+ * @brief Returns the node one level up with `node` at its centre.
+ *
+ * @return Returns a pointer to the node, or NULL if memory allocation fails.
+ */
+static node_t* ExpandNode(hashlife_t* life, node_t* node) {
+  node_t* empty = EmptyNode(life, node->level - 1);
+  if (!empty) {
+    return NULL;
+  }
+  return JoinNodes(life,
+                   JoinNodes(life, empty, empty, empty, node->nw),
+                   JoinNodes(life, empty, empty, node->ne, empty),
+                   JoinNodes(life, empty, node->sw, empty, empty),
+                   JoinNodes(life, node->se, empty, empty, empty));
+}
+
+/**
+ * @brief Checks whether every live cell of a node lies in its centre half.
+ */
+static int IsCentred(const node_t* node) {
+  return node->population == node->nw->se->population +
+                             node->ne->sw->population +
+                             node->sw->ne->population +
+                             node->se->nw->population;
+}
+
+/**
+ * @brief Returns the centre half of a node, one level down.
+ */
+static node_t* CentreNode(hashlife_t* life, const node_t* node) {
+  return JoinNodes(life, node->nw->se, node->ne->sw, node->sw->ne,
+                   node->se->nw);
+}
+
+/**
+ * @brief Computes the centre 2x2 cells of a 4x4 node one generation later.
+ *
+ * @return Returns a pointer to the level 1 result, or NULL if memory
+ *         allocation fails.
+ */
+static node_t* AdvanceBlock(hashlife_t* life, const node_t* node) {
+  // Bit (4 * y + x) holds the cell in row y and column x of the block
+  const node_t* quads[4] = {node->nw, node->ne, node->sw, node->se};
+  unsigned bits = 0;
+  for (int q = 0; q < 4; q++) {
+    const node_t* cells[4] = {quads[q]->nw, quads[q]->ne, quads[q]->sw,
+                              quads[q]->se};
+    for (int c = 0; c < 4; c++) {
+      int y = (q / 2) * 2 + c / 2;
+      int x = (q % 2) * 2 + c % 2;
+      bits |= (unsigned)cells[c]->population << (4 * y + x);
+    }
+  }
+
+  node_t* next[4];
+  for (int c = 0; c < 4; c++) {
+    int y = 1 + c / 2;
+    int x = 1 + c % 2;
+    int neighbor_count = 0;
+    for (int i = y - 1; i <= y + 1; i++) {
+      for (int j = x - 1; j <= x + 1; j++) {
+        if (i != y || j != x) {
+          neighbor_count += (bits >> (4 * i + j)) & 1;
+        }
+      }
+    }
+    int alive = (bits >> (4 * y + x)) & 1;
+    next[c] = &life->leaves[NextCellState(&life->rule, alive, neighbor_count)];
+  }
+
+  return JoinNodes(life, next[0], next[1], next[2], next[3]);
+}
+
+/**
+ * @brief Computes the centre of a node 2^step_log generations later.
+ *
+ * Splits the node into nine overlapping sub-squares one level down and
+ * reduces each of them to its centre, then advances the four squares made
+ * from those centres. When the step covers the full 2^(level - 2)
+ * generations the node allows, each half of the step is spent in one of the
+ * two stages; otherwise the sub-squares are not advanced at all. Results are
+ * memoized in the node.
+ *
+ * @param life     The universe the node belongs to.
+ * @param node     The node to advance.
+ * @param step_log The base 2 logarithm of the number of generations to
+ *                 advance by, at most `node->level - 2`.
+ *
+ * @return Returns a pointer to the result, one level below `node`, or NULL if
+ *         memory allocation fails.
+ */
+static node_t* AdvanceNode(hashlife_t* life, node_t* node, uint8_t step_log) {
+  if (node->result && node->result_log == step_log) {
+    return node->result;
+  }
+
+  node_t* result;
+  if (node->population == 0) {
+    result = EmptyNode(life, node->level - 1);
+  } else if (node->level == 2) {
+    result = AdvanceBlock(life, node);
+  } else {
+    node_t* parts[9] = {
+      node->nw,
+      JoinNodes(life, node->nw->ne, node->ne->nw, node->nw->se, node->ne->sw),
+      node->ne,
+      JoinNodes(life, node->nw->sw, node->nw->se, node->sw->nw, node->sw->ne),
+      CentreNode(life, node),
+      JoinNodes(life, node->ne->sw, node->ne->se, node->se->nw, node->se->ne),
+      node->sw,
+      JoinNodes(life, node->sw->ne, node->se->nw, node->sw->se, node->se->sw),
+      node->se,
+    };
+
+    // Whether the first half of the step happens in the nine sub-squares
+    int full_step = step_log + 2 == node->level;
+    uint8_t quad_log = full_step ? step_log - 1 : step_log;
+    for (int i = 0; i < 9; i++) {
+      if (!parts[i]) {
+        return NULL;
+      }
+      parts[i] = full_step ? AdvanceNode(life, parts[i], quad_log)
+                           : CentreNode(life, parts[i]);
+      if (!parts[i]) {
+        return NULL;
+      }
+    }
+
+    node_t* quads[4] = {
+      JoinNodes(life, parts[0], parts[1], parts[3], parts[4]),
+      JoinNodes(life, parts[1], parts[2], parts[4], parts[5]),
+      JoinNodes(life, parts[3], parts[4], parts[6], parts[7]),
+      JoinNodes(life, parts[4], parts[5], parts[7], parts[8]),
+    };
+    for (int i = 0; i < 4; i++) {
+      quads[i] = quads[i] ? AdvanceNode(life, quads[i], quad_log) : NULL;
+      if (!quads[i]) {
+        return NULL;
+      }
+    }
+    result = JoinNodes(life, quads[0], quads[1], quads[2], quads[3]);
+  }
+
+  if (result) {
+    node->result = result;
+    node->result_log = step_log;
+  }
+  return result;
+}
+
+/**
+ * @brief Marks a node and every node below it as reachable.
+ */
+static void MarkNode(node_t* node) {
+  if (node->marked || node->level == 0) {
+    return;
+  }
+  node->marked = 1;
+  MarkNode(node->nw);
+  MarkNode(node->ne);
+  MarkNode(node->sw);
+  MarkNode(node->se);
+}
+
+/**
+ * @brief Frees every node not reachable from the root.
+ *
+ * Drops every memoized result, since results may point to nodes that are
+ * about to be freed, then keeps only the root, its descendants and the empty
+ * nodes, returning every other node to the free list.
+ */
+static void CollectGarbage(hashlife_t* life) {
+  MarkNode(life->root);
+  for (int level = 0; level <= kHashLifeMaxLevel; level++) {
+    if (life->empty[level]) {
+      MarkNode(life->empty[level]);
+    }
+  }
+
+  for (size_t i = 0; i < life->table_size; i++) {
+    node_t** link = &life->table[i];
+    while (*link) {
+      node_t* node = *link;
+      if (node->marked) {
+        node->marked = 0;
+        node->result = NULL;
+        node->result_log = kNoResult;
+        link = &node->next;
+      } else {
+        *link = node->next;
+        node->next = life->free_nodes;
+        life->free_nodes = node;
+        life->node_count--;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Builds the node covering a square of a world.
+ *
+ * @param life  The universe the node belongs to.
+ * @param world The world to read the cells from.
+ * @param level The level of the node to build.
+ * @param x     The column of the world, without padding, of the left edge.
+ * @param y     The row of the world, without padding, of the top edge.
+ *
+ * @return Returns a pointer to the node, or NULL if memory allocation fails.
+ */
+static node_t* BuildNode(hashlife_t* life, const world_t* world, uint8_t level,
+                         size_t x, size_t y) {
+  if (x >= world->cols || y >= world->rows) {
+    return EmptyNode(life, level);
+  }
+  if (level == 0) {
+    return &life->leaves[GetCell(world, y + kPadding, x + kPadding)];
+  }
+
+  // Skip empty blocks without visiting each of their cells
+  if (level == kBlockLevel) {
+    size_t size = (size_t)1 << level;
+    size_t word = (x + kPadding) / kWordBits;
+    uint64_t any = 0;
+    for (size_t i = y; i < y + size && i < world->rows; i++) {
+      const uint64_t* row = WorldRow(world, i + kPadding);
+      any |= row[word] | (word + 1 < world->stride ? row[word + 1] : 0);
+    }
+    if (!any) {
+      return EmptyNode(life, level);
+    }
+  }
+
+  size_t half = (size_t)1 << (level - 1);
+  return JoinNodes(life, BuildNode(life, world, level - 1, x, y),
+                   BuildNode(life, world, level - 1, x + half, y),
+                   BuildNode(life, world, level - 1, x, y + half),
+                   BuildNode(life, world, level - 1, x + half, y + half));
+}
+
+/**
+ * @brief Replaces the universe with the live cells of a world.
+ *
+ * The top-left live cell of the world is placed at the origin of the plane,
+ * with the world extending towards positive coordinates.
+ *
+ * @param life  The universe to load into.
+ * @param world The world to load.
+ *
+ * @return Returns 0 on success, -1 if memory allocation fails or the world
+ *         does not fit under the memory limit, in which case
+ *         `life->exhausted` is set.
+ */
+int LoadHashLife(hashlife_t* life, const world_t* world) {
+  uint8_t level = 3;
+  while ((size_t)1 << (level - 1) < world->rows ||
+         (size_t)1 << (level - 1) < world->cols) {
+    level++;
+  }
+
+  node_t* empty = EmptyNode(life, level - 1);
+  node_t* se = BuildNode(life, world, level - 1, 0, 0);
+  node_t* root = JoinNodes(life, empty, empty, empty, se);
+  if (!root) {
+    return -1;
+  }
+
+  life->root = root;
+  return 0;
+}
+
+/**
+ * @brief Advances the root of the universe by 2^step_log generations.
+ *
+ * @return Returns 0 on success, -1 if memory allocation fails or the nodes
+ *         of the step do not fit under the memory limit, in which case
+ *         `life->exhausted` is set and the root is left as it was.
+ */
+static int AdvanceRoot(hashlife_t* life, uint8_t step_log) {
+  // Pad the root so the pattern cannot outgrow the result of the step
+  node_t* root = life->root;
+  while (root && (root->level < step_log + 2 || !IsCentred(root))) {
+    root = ExpandNode(life, root);
+  }
+  root = root ? ExpandNode(life, root) : NULL;
+  if (!root || root->level > kHashLifeMaxLevel) {
+    return -1;
+  }
+
+  // The root is only replaced once the step succeeds, so that a failed one
+  // leaves it as it was, and garbage is only collected between steps
+  root = AdvanceNode(life, root, step_log);
+  if (!root) {
+    return -1;
+  }
+  life->root = root;
+  return 0;
+}
+
+/**
+ * @brief Advances the universe by 2^step_log generations without taking more
+ *        memory than its limit.
+ *
+ * A step reaching the limit is abandoned, and every node but those of the
+ * current generation is collected before the step is tried again. If it
+ * still does not fit, it is split into two steps of half as many
+ * generations, down to single generations.
+ *
+ * @return Returns 0 on success, -1 if memory allocation fails or a single
+ *         generation does not fit under the limit, in which case
+ *         `life->exhausted` is set.
+ */
+static int AdvancePowerOfTwo(hashlife_t* life, uint8_t step_log) {
+  for (int attempt = 0; attempt < 2; attempt++) {
+    if (AdvanceRoot(life, step_log) == 0) {
+      return 0;
+    }
+    if (!life->exhausted) {
+      return -1;
+    }
+    life->exhausted = 0;
+    CollectGarbage(life);
+  }
+
+  if (step_log == 0) {
+    life->exhausted = 1;
+    return -1;
+  }
+  for (int half = 0; half < 2; half++) {
+    if (AdvancePowerOfTwo(life, step_log - 1) < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Advances the universe by any number of generations.
+ *
+ * Splits `generations` into powers of two and advances the universe by each
+ * of them in turn.
+ *
+ * @param life        The universe to advance.
+ * @param generations The number of generations to advance by.
+ *
+ * @return Returns 0 on success, -1 if memory allocation fails or the
+ *         universe does not fit under its memory limit, in which case
+ *         `life->exhausted` is set.
+ */
+int StepHashLife(hashlife_t* life, size_t generations) {
+  for (uint8_t bit = 0; generations >> bit; bit++) {
+    if ((generations >> bit) & 1) {
+      if (AdvancePowerOfTwo(life, bit) < 0) {
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Writes the cells of a node that fall inside a world.
+ */
+static void StoreNode(const node_t* node, world_t* world, size_t x, size_t y) {
+  if (node->population == 0 || x >= world->cols || y >= world->rows) {
+    return;
+  }
+  if (node->level == 0) {
+    SetCell(world, y + kPadding, x + kPadding, 1);
+    return;
+  }
+
+  size_t half = (size_t)1 << (node->level - 1);
+  StoreNode(node->nw, world, x, y);
+  StoreNode(node->ne, world, x + half, y);
+  StoreNode(node->sw, world, x, y + half);
+  StoreNode(node->se, world, x + half, y + half);
+}
+
+/**
+ * @brief Copies the window of the universe covered by a world into it.
+ *
+ * The window starts at the origin of the plane, where `LoadHashLife` placed
+ * the top-left cell of the world it loaded. Cells outside the window are not
+ * copied.
+ *
+ * @param life  The universe to read.
+ * @param world The world receiving the cells.
+ */
+void StoreHashLife(const hashlife_t* life, world_t* world) {
+  memset(world->cells, 0,
+         sizeof(uint64_t) * (world->rows + 2 * kPadding) * world->stride);
+
+  // Walk down to the smallest node starting at the origin that still covers
+  // the whole window, so coordinates never exceed the size of the window
+  const node_t* node = life->root->se;
+  while (node->level > 0 && ((size_t)1 << (node->level - 1)) >= world->rows &&
+         ((size_t)1 << (node->level - 1)) >= world->cols) {
+    node = node->nw;
+  }
+  StoreNode(node, world, 0, 0);
+}
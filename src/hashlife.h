@@ -0,0 +1,59 @@
+#ifndef HASHLIFE_H_
+#define HASHLIFE_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rule.h"
+#include "world.h"
+
+// Deepest quadtree level a universe may reach
+enum { kHashLifeMaxLevel = 96 };
+
+// Quadtree node covering a 2^level x 2^level square of the plane.
+//
+// Nodes are hash-consed: two nodes with the same children are the same node,
+// so identical regions of the universe are stored once. Level 0 nodes are
+// single cells.
+typedef struct node_t node_t;
+struct node_t {
+  node_t* nw;
+  node_t* ne;
+  node_t* sw;
+  node_t* se;
+  node_t* result;       // Memoized centre after 2^result_log generations
+  node_t* next;         // Next node in the same hash table bucket
+  uint64_t population;  // Number of live cells
+  uint8_t level;
+  uint8_t result_log;
+  uint8_t marked;       // Set while collecting garbage
+};
+
+typedef struct node_slab_t node_slab_t;
+
+// HashLife universe: an unbounded plane stored as a quadtree of hash-consed
+// nodes with memoized results.
+typedef struct {
+  node_t* root;           // Centred on the origin of the plane
+  node_t** table;         // Hash table of every interior node
+  size_t table_size;      // Number of buckets, always a power of two
+  size_t node_count;      // Number of nodes in the table
+  size_t memory_limit;    // Cap on the memory of the nodes and the table,
+                          // in bytes
+  int exhausted;          // Set once a node did not fit under the cap
+  rule_t rule;            // Rule the universe evolves under
+  node_slab_t* slabs;     // Blocks the nodes are carved from
+  node_t* free_nodes;     // Nodes released by garbage collection
+  node_t leaves[2];       // The dead and alive cells
+  node_t* empty[kHashLifeMaxLevel + 1];  // Empty node of each level
+} hashlife_t;
+
+hashlife_t* CreateHashLife(size_t memory_limit, const rule_t* rule);
+void FreeHashLife(hashlife_t* life);
+int LoadHashLife(hashlife_t* life, const world_t* world);
+int StepHashLife(hashlife_t* life, size_t generations);
+void StoreHashLife(const hashlife_t* life, world_t* world);
+size_t HashLifeMemory(const hashlife_t* life);
+
+#endif  // HASHLIFE_H_
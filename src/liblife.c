@@ -0,0 +1,307 @@
+/**
+ * liblife.c
+ *
+ * Implements the public interface of liblife. A handle wraps the same
+ * machinery `PlayGame` runs on, a configuration, two world buffers stepped
+ * back and forth, a tile map keeping the counters of every tile and a pool of
+ * workers, and keeps it alive between calls, so that a program embedding the
+ * simulator steps its worlds in place instead of starting the game over and
+ * parsing its output.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "liblife.h"
+#include "life.h"
+
+// World kept warm in memory, behind the opaque `life_t` of the interface
+struct life_t {
+  config_t config;    // Settings the world is stepped with, as in the game
+  world_t* current;   // The current generation
+  world_t* next;      // The buffer receiving the next generation
+  tiles_t* tiles;
+  pool_t* pool;
+  size_t generation;  // Generations stepped since the world was created
+  int edited;         // Whether cells were set since the tiles were counted
+};
+
+static int ConfigureLife(config_t* config, size_t rows, size_t cols,
+                         const life_options_t* options);
+static life_t* CreateLife(world_t* world, const config_t* config);
+static void RecountLife(life_t* life);
+
+/**
+ * @brief Creates a handle holding a dead world.
+ *
+ * @param rows    The number of rows of the world.
+ * @param cols    The number of columns of the world.
+ * @param options The settings of the handle, or NULL for the defaults.
+ *
+ * @return Returns a pointer to the new handle, or NULL if the size is 0, an
+ *         option is invalid or memory allocation or thread creation fails.
+ *         An error message is printed for invalid options.
+ *
+ * @note The returned handle must be released with `LifeFree`.
+ */
+life_t* LifeCreate(size_t rows, size_t cols, const life_options_t* options) {
+  config_t config;
+  if (rows == 0 || cols == 0 ||
+      ConfigureLife(&config, rows, cols, options) < 0) {
+    return NULL;
+  }
+
+  world_t* world = CreateWorldGrid(rows, cols);
+  if (!world) {
+    return NULL;
+  }
+  return CreateLife(world, (const config_t*)&config);
+}
+
+/**
+ * @brief Creates a handle holding a world loaded from a pattern file.
+ *
+ * The file is read as with -f: text, RLE or binary by the extension of its
+ * name, with the rule of the pattern unless `options->rule` is set.
+ *
+ * @param filename The pattern file.
+ * @param rows     The number of rows of the world, or 0 to use the size of
+ *                 the pattern.
+ * @param cols     The number of columns of the world, or 0 to use the size
+ *                 of the pattern.
+ * @param options  The settings of the handle, or NULL for the defaults.
+ *
+ * @return Returns a pointer to the new handle, or NULL if an option is
+ *         invalid, the file cannot be loaded or memory allocation or thread
+ *         creation fails. An error message is printed for invalid options
+ *         and files.
+ *
+ * @note The returned handle must be released with `LifeFree`.
+ */
+life_t* LifeLoad(const char* filename, size_t rows, size_t cols,
+                 const life_options_t* options) {
+  config_t config;
+  if (ConfigureLife(&config, rows, cols, options) < 0) {
+    return NULL;
+  }
+
+  config.filename = (char*)filename;
+  world_t* world = CreateWorld(&config);
+  if (!world) {
+    return NULL;
+  }
+  return CreateLife(world, (const config_t*)&config);
+}
+
+/**
+ * @brief Frees a handle and its world, and stops its workers.
+ *
+ * @param life The handle to free. It is safe to pass NULL.
+ */
+void LifeFree(life_t* life) {
+  if (life) {
+    FreePool(life->pool);
+    FreeTiles(life->tiles);
+    FreeWorldGrid(life->next);
+    FreeWorldGrid(life->current);
+    free(life);
+  }
+}
+
+/**
+ * @brief Advances the world by a number of generations, in place.
+ *
+ * Each generation is computed like a generation of the game, skipping the
+ * tiles that stayed the same, and counted on the way.
+ *
+ * @param life        The handle of the world.
+ * @param generations The number of generations to advance.
+ */
+void LifeStep(life_t* life, size_t generations) {
+  if (life->edited) {
+    RecountLife(life);
+  }
+  for (size_t g = 0; g < generations; g++) {
+    SimulateGeneration(life->current, life->next, life->tiles, &life->config,
+                       life->pool);
+    world_t* tmp = life->current;
+    life->current = life->next;
+    life->next = tmp;
+  }
+  life->generation += generations;
+}
+
+/**
+ * @brief Returns the number of generations stepped since the world was
+ *        created.
+ */
+size_t LifeGeneration(const life_t* life) {
+  return life->generation;
+}
+
+/**
+ * @brief Returns the number of rows of the world.
+ */
+size_t LifeRows(const life_t* life) {
+  return life->current->rows;
+}
+
+/**
+ * @brief Returns the number of columns of the world.
+ */
+size_t LifeColumns(const life_t* life) {
+  return life->current->cols;
+}
+
+/**
+ * @brief Returns the cells of the current generation, without copying them.
+ *
+ * @param life   The handle of the world.
+ * @param stride Receives the number of words of each row.
+ *
+ * @return A pointer to the first word of the first row, laid out as
+ *         described in `liblife.h`.
+ */
+const uint64_t* LifeCells(const life_t* life, size_t* stride) {
+  *stride = life->current->stride;
+  return WorldRow((const world_t*)life->current, kPadding);
+}
+
+/**
+ * @brief Returns 1 if the cell at (`row`, `col`), counted from 0, is alive,
+ *        0 if it is dead or outside the world.
+ */
+int LifeGetCell(const life_t* life, size_t row, size_t col) {
+  if (row >= life->current->rows || col >= life->current->cols) {
+    return 0;
+  }
+  return GetCell((const world_t*)life->current, row + kPadding,
+                 col + kPadding);
+}
+
+/**
+ * @brief Sets the cell at (`row`, `col`), counted from 0, alive or dead.
+ *
+ * Cells outside the world are ignored. The whole world is recomputed and
+ * counted again by the next step, and the counters read before it count no
+ * births or deaths.
+ *
+ * @param life  The handle of the world.
+ * @param row   The row of the cell.
+ * @param col   The column of the cell.
+ * @param alive Non-zero to make the cell alive, 0 to make it dead.
+ */
+void LifeSetCell(life_t* life, size_t row, size_t col, int alive) {
+  if (row >= life->current->rows || col >= life->current->cols) {
+    return;
+  }
+  SetCell(life->current, row + kPadding, col + kPadding, alive);
+  life->edited = 1;
+}
+
+/**
+ * @brief Reads the counters of the current generation, which every step
+ *        keeps up to date without an extra pass over the world.
+ *
+ * @param life  The handle of the world.
+ * @param stats Receives the counters.
+ */
+void LifeGetStats(life_t* life, life_stats_t* stats) {
+  if (life->edited) {
+    RecountLife(life);
+  }
+
+  cell_stats_t counts;
+  WorldStats((const tiles_t*)life->tiles, &counts);
+  stats->population = counts.population;
+  stats->births = counts.births;
+  stats->deaths = counts.deaths;
+  stats->top = counts.top;
+  stats->left = counts.left;
+  stats->bottom = counts.bottom;
+  stats->right = counts.right;
+}
+
+/**
+ * @brief Fills a game configuration from the options of a handle.
+ *
+ * @return Returns 0 on success, -1 if an option is invalid, in which case an
+ *         error message is printed.
+ */
+static int ConfigureLife(config_t* config, size_t rows, size_t cols,
+                         const life_options_t* options) {
+  life_options_t defaults = {NULL, NULL, 0, 0};
+  if (!options) {
+    options = &defaults;
+  }
+
+  *config = kDefaults;
+  config->rows = rows;
+  config->cols = cols;
+  config->wrap = options->wrap;
+  config->threads = options->threads ? options->threads : 1;
+  config->engine = BestEngine();
+  if (options->engine) {
+    config->engine = FindEngine(options->engine);
+    if (!config->engine) {
+      fprintf(stderr, "Error: Unknown engine, '%s'\n", options->engine);
+      return -1;
+    }
+    if (!IsEngineSupported(config->engine)) {
+      fprintf(stderr, "Error: Engine '%s' is not supported by this CPU\n",
+              options->engine);
+      return -1;
+    }
+  }
+  if (options->rule) {
+    if (ParseRule(options->rule, &config->rule) < 0) {
+      fprintf(stderr, "Error: Invalid rule, '%s'\n", options->rule);
+      return -1;
+    }
+    if (config->rule.birth & 1) {
+      fprintf(stderr, "Error: Rules with B0 are not supported, '%s'\n",
+              options->rule);
+      return -1;
+    }
+    config->rule_given = 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Creates a handle around a world, taking ownership of it.
+ *
+ * @return Returns a pointer to the new handle, or NULL if memory allocation
+ *         or thread creation fails, in which case `world` is freed.
+ */
+static life_t* CreateLife(world_t* world, const config_t* config) {
+  life_t* life = calloc(1, sizeof(life_t));
+  if (!life) {
+    FreeWorldGrid(world);
+    return NULL;
+  }
+
+  life->config = *config;
+  life->current = world;
+  life->next = CreateWorldGrid(world->rows, world->cols);
+  life->tiles = CreateTiles((const world_t*)world, config->wrap);
+  life->pool = CreatePool(config->threads);
+  if (!life->next || !life->tiles || !life->pool ||
+      EnableTileStats(life->tiles, (const world_t*)world) < 0) {
+    LifeFree(life);
+    return NULL;
+  }
+  return life;
+}
+
+/**
+ * @brief Recomputes every tile on the next step and counts the world again
+ *        after its cells were set.
+ *
+ * The counters are already allocated, so counting them again cannot fail.
+ */
+static void RecountLife(life_t* life) {
+  MarkAllTilesChanged(life->tiles);
+  EnableTileStats(life->tiles, (const world_t*)life->current);
+  life->edited = 0;
+}
@@ -0,0 +1,71 @@
+#ifndef LIBLIFE_H_
+#define LIBLIFE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Public interface of liblife, the simulator built as a library for programs
+// that embed it. A `life_t` keeps a world and everything needed to step it
+// warm in memory between calls: both generation buffers, the tile map, the
+// counters of the last generation and the pool of worker threads. The cells
+// are read in place, in the bit-packed layout the engines compute on.
+//
+// `LifeCells` returns the live rows of the world, `LifeRows` of them, each
+// `stride` words long. Column `c` of a row is bit `(c + 1) % 64` of its word
+// `(c + 1) / 64`; the bits on either side of the columns are always dead.
+// The cells stay valid until the next call that steps or edits the world.
+//
+// A handle may be used by one thread at a time; distinct handles are
+// independent of each other.
+typedef struct life_t life_t;
+
+// Settings of a new handle. A zeroed struct selects the defaults.
+typedef struct {
+  const char* engine;  // Name of the engine, as with -e, or NULL for the
+                       // widest one the CPU supports
+  const char* rule;    // Rule in B/S notation, or NULL for the rule of the
+                       // pattern file, if any, or B3/S23
+  size_t threads;      // Number of worker threads, or 0 for one
+  int wrap;            // Whether the world wraps around its edges
+} life_options_t;
+
+// Counters of the current generation, as written by --stats. The bounding
+// box holds the live cells within rows [`top`, `bottom`] and columns
+// [`left`, `right`], counted from 0, and is empty when `population` is 0.
+typedef struct {
+  size_t population;
+  size_t births;   // Cells born since the previous generation
+  size_t deaths;   // Cells dead since the previous generation
+  size_t top;
+  size_t left;
+  size_t bottom;
+  size_t right;
+} life_stats_t;
+
+// Marks the functions exported by liblife.so, which hides every other symbol
+// of the simulator from the programs linking it
+#define LIFE_API __attribute__((visibility("default")))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+LIFE_API life_t* LifeCreate(size_t rows, size_t cols,
+                            const life_options_t* options);
+LIFE_API life_t* LifeLoad(const char* filename, size_t rows, size_t cols,
+                          const life_options_t* options);
+LIFE_API void LifeFree(life_t* life);
+LIFE_API void LifeStep(life_t* life, size_t generations);
+LIFE_API size_t LifeGeneration(const life_t* life);
+LIFE_API size_t LifeRows(const life_t* life);
+LIFE_API size_t LifeColumns(const life_t* life);
+LIFE_API const uint64_t* LifeCells(const life_t* life, size_t* stride);
+LIFE_API int LifeGetCell(const life_t* life, size_t row, size_t col);
+LIFE_API void LifeSetCell(life_t* life, size_t row, size_t col, int alive);
+LIFE_API void LifeGetStats(life_t* life, life_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBLIFE_H_
@@ -4,15 +4,6 @@
  * Implements the logic for simulating Conway's Game of Life, including
  * functions for setting up the game environment, simulating generations,
  * and printing the state of the game world.
- * 
- * Usage: ./life [options]
- * Options:
- *   -r, --rows NUM           Set the number of rows (default: 10)
- *   -c, --columns NUM        Set the number of columns (default: 10)
- *   -f, --filename FILENAME  Specify the filename to use (default: life.txt)
- *   -n, --generations NUM    Set the number of generations (default: 10)
- *   --debug                  Enable debug mode
- *   -h, --help               Print this message
  *
  * Author: Juan Diego Becerra
  * Date: 2024-03-16
@@ -20,174 +11,820 @@
 
 #include "life.h"
 
-int main(int argc, char* argv[]) {
-  config_t config;
-  if (ConfigureGame(&config, argc, argv) != 0) {
-    return 1;
+static inline void PrintUsage(void);
+static void SimulateBand(void* arg, size_t worker, size_t workers);
+static world_t* PlaceWorld(world_t* world, tiles_t* tiles,
+                           const config_t* config, pool_t* pool);
+static void CopyBand(void* arg, size_t worker, size_t workers);
+static size_t NextNeededGeneration(const config_t* config, size_t gen,
+                                   size_t due, int detecting);
+static FILE* OpenStats(const char* filename);
+static int WriteStats(FILE* file, const tiles_t* tiles, size_t gen);
+static int CloseStats(FILE* file, const char* filename);
+
+/**
+ * @brief Simulates the game for the specified number of generations.
+ *
+ * Simulates the game evolution over the configured number of generations,
+ * updating the world state in each generation. It prints the world state
+ * at the generation steps selected by `PrintsGeneration`, and only steps
+ * over the others.
+ *
+ * The simulation alternates between two buffers: each generation is computed
+ * from the current buffer into the other one, and the two pointers are then
+ * swapped, so no generation needs to be copied. A tile map of the world
+ * tracks which parts of it changed so that quiet areas are skipped.
+ *
+ * With `config->checkpoint_every` set, every generation that is a multiple
+ * of it is handed over to a writer thread, which saves it as a checkpoint in
+ * the background. A generation due while the previous checkpoint is still
+ * being written is deferred to the first generation after it finishes.
+ * With `config->output` set, the generations it selects are also streamed
+ * to that file.
+ *
+ * With `config->detect_cycles` set, the tile map also hashes the world, and
+ * once it repeats with some period, the game skips the whole periods left
+ * before the last generation, which is the same as one of the generations
+ * already seen. The period is reported on the standard error.
+ *
+ * The rows of both buffers are first written by the worker computing them,
+ * so that on a NUMA machine each band of the world sits on the node of its
+ * worker; see `PlaceWorld`. With `config->huge_pages` set, both buffers are
+ * also backed by transparent huge pages.
+ *
+ * With `config->temporal_block` above 1, the generations that are neither
+ * printed, drawn, streamed, checkpointed nor hashed are advanced up to that
+ * many at a time by `StepTemporal`, which passes over the memory of the
+ * world once for all of them. Every tile is then marked changed, since the
+ * pass does not track them.
+ *
+ * With `config->stats` set, the tile map also counts the population, the
+ * births, the deaths and the bounding box of every generation while it
+ * compares the tiles it computed, and one line of them per generation is
+ * written to that file. The generations skipped over by `--detect-cycles`
+ * have no line.
+ *
+ * With `config->metrics_port` set, the generation the game is at is
+ * published to a metrics server after every generation, and the population
+ * once a scrape asked for it.
+ *
+ * @param world  A pointer to the current world state. On return, it points
+ *               to the buffer holding the last generation.
+ * @param config A constant pointer to the game configuration.
+ * @return Returns 0 on successful completion of the game, -1 if memory
+ *         allocation for the second buffer or the tile map, the creation of
+ *         the worker pool or of the writer thread, the output stream or the
+ *         stats file fails.
+ *
+ * @note This function creates a second world buffer, a tile map, a pool of
+ *       `config->threads` workers and a checkpoint writer thread if needed,
+ *       which are freed before the function
+ *       returns. The buffer freed may be the one `world` pointed to on entry.
+ *       When the HashLife engine, the gpu engine or the unbounded mode is
+ *       selected, the game is delegated to `PlayHashLife`, `PlayGpu` or
+ *       `PlayUnbounded` instead.
+ */
+int PlayGame(world_t** world, const config_t* config) {
+  if (config->hashlife) {
+    return PlayHashLife(*world, config);
+  }
+#ifdef LIFE_HAVE_CUDA
+  if (config->gpu) {
+    return PlayGpu(*world, config);
+  }
+#endif
+  if (config->unbounded) {
+    return PlayUnbounded(*world, config);
   }
 
-  char** world = CreateWorld((const config_t*)&config);
-  if (!world) {
-    fprintf(stderr, "Error: Unable to create world, memory allocation failed.\n");
-    return 1;
+  world_t* next = CreateWorldGrid(config->rows, config->cols);
+  tiles_t* tiles = CreateTiles((const world_t*)*world, config->wrap);
+  pool_t* pool = CreatePool(config->threads);
+  renderer_t* renderer = NULL;
+  if (DrawsFrames(config)) {
+    renderer = CreateRenderer(config->rows, config->cols, kAliveChar,
+                              kDeadChar);
+  }
+  display_t* display = NULL;
+  if (renderer && config->fps) {
+    display = CreateDisplay(renderer, config->rows, config->cols,
+                            config->fps);
+  }
+  checkpointer_t* checkpointer = NULL;
+  if (config->checkpoint_every) {
+    checkpointer = CreateCheckpointer(config->checkpoint, config->rows,
+                                      config->cols, &config->rule);
+  }
+  stream_t* stream = NULL;
+  if (config->output) {
+    stream = CreateStream(config->output, config->rows, config->cols,
+                          &config->rule, config->output_every);
+  }
+  temporal_t* temporal = NULL;
+  if (config->temporal_block > 1) {
+    temporal = CreateTemporal((const world_t*)*world, config->temporal_block,
+                              config->threads);
+  }
+  FILE* stats = NULL;
+  if (config->stats) {
+    stats = OpenStats(config->stats);
+  }
+  metrics_t* metrics = NULL;
+  if (config->metrics_port) {
+    metrics = CreateMetrics(config->metrics_port, config->first_generation,
+                            config->generations);
+  }
+  if (!next || !tiles || !pool || (DrawsFrames(config) && !renderer) ||
+      (config->fps && !display) ||
+      (config->checkpoint_every && !checkpointer) ||
+      (config->output && !stream) ||
+      (config->temporal_block > 1 && !temporal) ||
+      (config->stats && !stats) || (config->metrics_port && !metrics) ||
+      (config->detect_cycles &&
+       EnableTileHashes(tiles, (const world_t*)*world) < 0) ||
+      (config->stats &&
+       EnableTileStats(tiles, (const world_t*)*world) < 0)) {
+    FreeMetrics(metrics);
+    CloseStats(stats, config->stats);
+    FreeTemporal(temporal);
+    CloseStream(stream);
+    FreeCheckpointer(checkpointer);
+    FreeDisplay(display);
+    FreeRenderer(renderer);
+    FreePool(pool);
+    FreeTiles(tiles);
+    FreeWorldGrid(next);
+    return -1;
   }
 
-  if (PlayGame(world, (const config_t*)&config) < 0) {
-    fprintf(stderr, "Error: Unable to copy world, memory allocation failed.\n");
-    FreeGrid(world, config.rows + kPadding + 1);
-    return 1;
+  if (config->huge_pages) {
+    AdviseHugePages((const world_t*)next);
   }
+  int status = 0;
+  world_t* current = PlaceWorld(*world, tiles, config, pool);
+  size_t every = config->checkpoint_every;
+  size_t due = every ? (config->first_generation / every + 1) * every : 0;
+  int detecting = config->detect_cycles;
+  cycle_t cycle;
+  ClearCycle(&cycle);
+  if (detecting) {
+    RecordGeneration(&cycle, WorldHash((const tiles_t*)tiles));
+  }
+  for (size_t gen = config->first_generation; gen <= config->generations;
+       gen++) {
+    int last = gen == config->generations;
+    if (metrics) {
+      PublishGeneration(metrics, gen);
+      if (WantsPopulation(metrics)) {
+        PublishPopulation(metrics, gen,
+                          CountPopulation((const world_t*)current));
+      }
+    }
+    if ((stream && WriteFrame(stream, (const world_t*)current, gen, last) <
+                       0) ||
+        (stats && WriteStats(stats, (const tiles_t*)tiles, gen) < 0)) {
+      status = -1;
+      break;
+    }
+    if (display) {
+      OfferFrame(display, (const world_t*)current, gen, last);
+    } else if (PrintsGeneration(config, gen)) {
+      PrintWorld((const world_t*)current, config, gen, renderer);
+    }
+    if (gen < config->generations) {
+      size_t steps = 1;
+      if (temporal) {
+        steps = NextNeededGeneration(config, gen, due, detecting) - gen;
+        steps = steps < config->temporal_block ? steps : config->temporal_block;
+      }
+      if (steps > 1) {
+        StepTemporal(temporal, config->engine, &config->rule,
+                     (const world_t*)current, next, steps, config->wrap,
+                     pool);
+        MarkAllTilesChanged(tiles);
+      } else {
+        SimulateGeneration(current, next, tiles, config, pool);
+      }
 
-  FreeGrid(world, config.rows + kPadding + 1);
-  return 0;
+      world_t* tmp = current;
+      current = next;
+      next = tmp;
+      // The loop goes on from the last generation advanced
+      gen += steps - 1;
+
+      if (checkpointer && gen + 1 >= due &&
+          OfferCheckpoint(checkpointer, (const world_t*)current, gen + 1) ==
+              0) {
+        due = ((gen + 1) / every + 1) * every;
+      }
+
+      size_t period = 0;
+      if (detecting) {
+        period = RecordGeneration(&cycle, WorldHash((const tiles_t*)tiles));
+      }
+      if (period) {
+        size_t skipped = (config->generations - gen - 1) / period * period;
+        fprintf(stderr, "Cycle of period %zu reached at generation %zu, "
+                        "skipping to generation %zu\n", period, gen + 1,
+                gen + 1 + skipped);
+        gen += skipped;
+        detecting = 0;
+      }
+    }
+  }
+
+  *world = current;
+  if (CloseStream(stream) < 0 || CloseStats(stats, config->stats) < 0) {
+    status = -1;
+  }
+  FreeMetrics(metrics);
+  FreeTemporal(temporal);
+  FreeCheckpointer(checkpointer);
+  FreeDisplay(display);
+  FreeRenderer(renderer);
+  FreePool(pool);
+  FreeTiles(tiles);
+  FreeWorldGrid(next);
+  return status;
 }
 
 /**
- * @brief Simulates the game for the specified number of generations.
+ * @brief Simulates the game with the HashLife engine.
  *
- * Simulates the game evolution over the configured number of generations,
- * updating the world state in each generation. It prints the world state
- * at each generation step.
+ * Loads the world into a HashLife universe, jumps straight to the last
+ * generation and prints it, streaming it to `config->output` if set. The
+ * universe is unbounded, so patterns reaching the edge of the world keep
+ * evolving beyond it instead of dying against the padding.
  *
- * @param world  A pointer to the current world state.
+ * @param world  A pointer to the initial world state. On return, it holds
+ *               the window of the universe covered by the world at the last
+ *               generation.
  * @param config A constant pointer to the game configuration.
+ *
+ * The universe collects its garbage, and splits the jump into smaller
+ * steps, whenever it reaches `config->memory_limit`.
+ *
  * @return Returns 0 on successful completion of the game, -1 if memory
- *         allocation for the world copy fails.
+ *         allocation fails, a single generation of the universe does not fit
+ *         in its memory limit, in which case an error message is printed, or
+ *         the output stream fails.
+ */
+int PlayHashLife(world_t* world, const config_t* config) {
+  hashlife_t* life = CreateHashLife(config->memory_limit << 20, &config->rule);
+  renderer_t* renderer = NULL;
+  if (DrawsFrames(config)) {
+    renderer = CreateRenderer(config->rows, config->cols, kAliveChar,
+                              kDeadChar);
+  }
+  uint64_t start = ProfileClock();
+  if (!life || (DrawsFrames(config) && !renderer) ||
+      LoadHashLife(life, (const world_t*)world) < 0 ||
+      StepHashLife(life, config->generations - config->first_generation) <
+          0) {
+    if (life && life->exhausted) {
+      fprintf(stderr, "Error: The HashLife universe does not fit in %zu MB, "
+                      "raise it with -m\n", config->memory_limit);
+    }
+    FreeRenderer(renderer);
+    FreeHashLife(life);
+    return -1;
+  }
+
+  StoreHashLife(life, world);
+  ProfileSince(kPhaseCompute, 0, start);
+  FreeHashLife(life);
+  int status = 0;
+  if (config->output) {
+    stream_t* stream = CreateStream(config->output, config->rows,
+                                    config->cols, &config->rule, 0);
+    if (!stream ||
+        WriteFrame(stream, (const world_t*)world, config->generations, 1) <
+            0) {
+      status = -1;
+    }
+    if (CloseStream(stream) < 0) {
+      status = -1;
+    }
+  }
+  PrintWorld((const world_t*)world, config, config->generations, renderer);
+  FreeRenderer(renderer);
+  return status;
+}
+
+#ifdef LIFE_HAVE_CUDA
+/**
+ * @brief Simulates the game with the gpu engine.
+ *
+ * Copies the world to the CUDA device once and computes every generation
+ * there. A generation is only copied back when the host needs it: to print
+ * it, to draw it as a frame of the display, to stream it to
+ * `config->output`, to offer it as a checkpoint, or because it is the last
+ * one. The generations in between are queued on the device in a single
+ * batch, so a run that prints nothing, like `--bench`, copies the world back
+ * once at the end.
  *
- * @note This function creates a copy of the world for the simulation process,
- *       which is freed before the function returns.
+ * @param world  A pointer to the initial world state. On return, it holds
+ *               the last generation.
+ * @param config A constant pointer to the game configuration.
+ *
+ * @return Returns 0 on successful completion of the game, -1 if memory
+ *         allocation, the device, the creation of the writer thread or the
+ *         output stream fails.
  */
-int PlayGame(char** world, const config_t* config) {
-  char** world_cpy = CreateCharGrid(config->rows + kPadding + 1,
-                                    config->cols + kPadding + 1, kDeadChar);
-  if (!world_cpy) {
+int PlayGpu(world_t* world, const config_t* config) {
+  gpu_world_t* gpu = CreateGpuWorld((const world_t*)world, config->wrap);
+  renderer_t* renderer = NULL;
+  if (DrawsFrames(config)) {
+    renderer = CreateRenderer(config->rows, config->cols, kAliveChar,
+                              kDeadChar);
+  }
+  display_t* display = NULL;
+  if (renderer && config->fps) {
+    display = CreateDisplay(renderer, config->rows, config->cols,
+                            config->fps);
+  }
+  checkpointer_t* checkpointer = NULL;
+  if (config->checkpoint_every) {
+    checkpointer = CreateCheckpointer(config->checkpoint, config->rows,
+                                      config->cols, &config->rule);
+  }
+  stream_t* stream = NULL;
+  if (config->output) {
+    stream = CreateStream(config->output, config->rows, config->cols,
+                          &config->rule, config->output_every);
+  }
+  if (!gpu || (DrawsFrames(config) && !renderer) ||
+      (config->fps && !display) ||
+      (config->checkpoint_every && !checkpointer) ||
+      (config->output && !stream)) {
+    CloseStream(stream);
+    FreeCheckpointer(checkpointer);
+    FreeDisplay(display);
+    FreeRenderer(renderer);
+    FreeGpuWorld(gpu);
     return -1;
   }
 
-  for (size_t gen = 0; gen <= config->generations; gen++) {
-    PrintWorld((const char**)world, config, gen);
-    SimulateGeneration(world, world_cpy, config);
+  int status = 0;
+  size_t every = config->checkpoint_every;
+  size_t due = every ? (config->first_generation / every + 1) * every : 0;
+  size_t gen = config->first_generation;
+  for (;;) {
+    int last = gen == config->generations;
+    int shown = display ? last || WantsFrame(display)
+                        : !config->bench && PrintsGeneration(config, gen);
+    int streamed = stream && StreamsGeneration(stream, gen, last);
+    int offered = checkpointer && gen >= due;
+    uint64_t start = ProfileClock();
+    if ((shown || streamed || offered || last) &&
+        DownloadGpuWorld((const gpu_world_t*)gpu, world) < 0) {
+      status = -1;
+      break;
+    }
+    ProfileSince(kPhaseCopy, 0, start);
+    if (streamed && WriteFrame(stream, (const world_t*)world, gen, last) < 0) {
+      status = -1;
+      break;
+    }
+    if (offered &&
+        OfferCheckpoint(checkpointer, (const world_t*)world, gen) == 0) {
+      due = (gen / every + 1) * every;
+    }
+    if (display && shown) {
+      OfferFrame(display, (const world_t*)world, gen, last);
+    } else if (shown) {
+      PrintWorld((const world_t*)world, config, gen, renderer);
+    }
+    if (last) {
+      break;
+    }
+
+    size_t target = NextNeededGeneration(config, gen, due, 0);
+    start = ProfileClock();
+    if (StepGpuWorld(gpu, &config->rule, target - gen) < 0) {
+      status = -1;
+      break;
+    }
+    ProfileSince(kPhaseCompute, 0, start);
+    gen = target;
   }
 
-  FreeGrid(world_cpy, config->rows + kPadding + 1);
-  return 0;
+  if (CloseStream(stream) < 0) {
+    status = -1;
+  }
+  FreeCheckpointer(checkpointer);
+  FreeDisplay(display);
+  FreeRenderer(renderer);
+  FreeGpuWorld(gpu);
+  return status;
 }
+#endif
 
 /**
- * @brief Simulates a single generation step in the game.
+ * @brief Simulates the game in an unbounded universe.
  *
- * Updates the state of the world for one generation. This function copies the
- * current world state, then uses it as a reference to update the original
- * world based on the cell state computation rules.
+ * Loads the world into a universe that allocates chunks of cells as the
+ * pattern spreads, so nothing dies against the edge of the world. Each
+ * generation prints the window of the universe covered by the world, and
+ * the generations selected by `config->output` stream it.
  *
- * @param world     A pointer to the current world state.
- * @param world_cpy A pointer to the copy of the world used for reference.
- * @param config    A constant pointer to the game configuration detailing the
- *                  world size.
+ * @param world  A pointer to the initial world state. On return, it holds
+ *               the window of the universe covered by the world at the last
+ *               generation.
+ * @param config A constant pointer to the game configuration.
  *
- * @note This function relies on `ComputeCellState` to determine the next state
- *       of each cell based on its neighbors.
+ * @return Returns 0 on successful completion of the game, -1 if memory
+ *         allocation, the creation of the worker pool or the output stream
+ *         fails.
  */
-void SimulateGeneration(char** world, char** world_cpy,
-                        const config_t* config) {
-  // Copy original world for reference
-  for (size_t i = kPadding; i <= config->rows; i++) {
-    memcpy(world_cpy[i], world[i], sizeof(char) * config->cols + kPadding + 1);
+int PlayUnbounded(world_t* world, const config_t* config) {
+  universe_t* universe = CreateUniverse(&config->rule);
+  pool_t* pool = CreatePool(config->threads);
+  renderer_t* renderer = NULL;
+  if (DrawsFrames(config)) {
+    renderer = CreateRenderer(config->rows, config->cols, kAliveChar,
+                              kDeadChar);
+  }
+  display_t* display = NULL;
+  if (renderer && config->fps) {
+    display = CreateDisplay(renderer, config->rows, config->cols,
+                            config->fps);
+  }
+  stream_t* stream = NULL;
+  if (config->output) {
+    stream = CreateStream(config->output, config->rows, config->cols,
+                          &config->rule, config->output_every);
+  }
+  if (!universe || !pool || (DrawsFrames(config) && !renderer) ||
+      (config->fps && !display) ||
+      (config->output && !stream) ||
+      LoadUniverse(universe, (const world_t*)world) < 0) {
+    CloseStream(stream);
+    FreeDisplay(display);
+    FreeRenderer(renderer);
+    FreePool(pool);
+    FreeUniverse(universe);
+    return -1;
   }
 
-  for (size_t i = kPadding; i <= config->rows; i++) {
-    for (size_t j = kPadding; j <= config->cols; j++) {
-      world[i][j] = ComputeCellState((const char**)world_cpy, i, j);
+  int status = 0;
+  for (size_t gen = config->first_generation; gen <= config->generations;
+       gen++) {
+    int last = gen == config->generations;
+    int shown = display ? last || WantsFrame(display)
+                        : PrintsGeneration(config, gen);
+    int streamed = stream && StreamsGeneration(stream, gen, last);
+    if (shown || streamed) {
+      StoreUniverse((const universe_t*)universe, world);
+    }
+    if (streamed &&
+        WriteFrame(stream, (const world_t*)world, gen, last) < 0) {
+      status = -1;
+      break;
+    }
+    if (display && shown) {
+      OfferFrame(display, (const world_t*)world, gen, last);
+    } else if (shown) {
+      PrintWorld((const world_t*)world, config, gen, renderer);
     }
+    if (gen < config->generations && StepUniverse(universe, pool) < 0) {
+      status = -1;
+      break;
+    }
+  }
+
+  if (CloseStream(stream) < 0) {
+    status = -1;
   }
+  FreeDisplay(display);
+  FreeRenderer(renderer);
+  FreePool(pool);
+  FreeUniverse(universe);
+  return status;
 }
 
 /**
- * @brief Computes the next state of a cell based on its neighbors.
+ * @brief Moves the initial world into a buffer written band by band by the
+ *        workers of the pool.
  *
- * Determines the next state of a cell at a given position (`row`, `col`) in
- * the world, according to the classic rules of the Game of Life: A cell flips
- * from alive to dead if it has fewer than 2 or more than 3 alive neighbors,
- * and a dead cell becomes alive if it has exactly 3 alive neighbors.
+ * The pages of a world mapped by `CreateWorldGrid` are placed on the NUMA
+ * node of the thread that first writes them, which for the initial world is
+ * the thread that loaded it. Copying it into a fresh buffer by the bands of
+ * `SimulateBand` places each band with the worker that computes it instead,
+ * like the bands of the second buffer, which the workers write first when
+ * they compute the first generation.
  *
- * @param world The current state of the world as a 2D grid of characters.
- * @param row   The row index of the cell.
- * @param col   The column index of the cell.
+ * @param world  The initial world.
+ * @param tiles  The tile map of the world, which sets the bands.
+ * @param config A constant pointer to the game configuration.
+ * @param pool   The pool of workers computing the generations.
  *
- * @return The new state of the cell ('alive' or 'dead').
+ * @return Returns the world in its new buffer, once the old one is freed, or
+ *         `world` itself if the game runs on a single thread, the world is
+ *         not mapped, or memory allocation fails.
  */
-char ComputeCellState(const char** world, size_t row, size_t col) {
-  int neighbor_count = 0;
-
-  // Inspect neighboring cells
-  for (size_t i = row - 1; i <= row + 1; i++) {
-    for (size_t j = col - 1; j <= col + 1; j++) {
-      if (i == row && j == col) {
-        continue;
-      }
-      if (IsAlive(world[i][j])) {
-        neighbor_count++;
-      }
+static world_t* PlaceWorld(world_t* world, tiles_t* tiles,
+                           const config_t* config, pool_t* pool) {
+  world_t* placed = NULL;
+  if (config->threads > 1 && world->mapped) {
+    placed = CreateWorldGrid(world->rows, world->cols);
+  }
+  if (!placed) {
+    if (config->huge_pages) {
+      AdviseHugePages((const world_t*)world);
     }
+    return world;
   }
 
-  char new_state = world[row][col];
-  if (IsAlive(world[row][col])) {
-    if (neighbor_count < 2 || neighbor_count > 3) {
-      new_state = kDeadChar;
+  if (config->huge_pages) {
+    AdviseHugePages((const world_t*)placed);
+  }
+  generation_t copy = {(const world_t*)world, placed, tiles, config};
+  RunPool(pool, CopyBand, &copy);
+  FreeWorldGrid(world);
+  return placed;
+}
+
+/**
+ * @brief Copies one worker's band of rows of a world, split as in
+ *        `SimulateBand`.
+ *
+ * @param arg     A pointer to the `generation_t` holding both worlds.
+ * @param worker  The index of the calling worker.
+ * @param workers The number of workers sharing the copy.
+ */
+static void CopyBand(void* arg, size_t worker, size_t workers) {
+  generation_t* copy = arg;
+  size_t rows = copy->tiles->rows;
+  size_t begin = kPadding + rows * worker / workers * kTileRows;
+  size_t end = kPadding + rows * (worker + 1) / workers * kTileRows;
+  if (end > copy->src->rows + kPadding) {
+    end = copy->src->rows + kPadding;
+  }
+  if (begin < end) {
+    uint64_t start = ProfileClock();
+    memcpy(WorldRow(copy->dst, begin), WorldRow(copy->src, begin),
+           (end - begin) * copy->src->stride * sizeof(uint64_t));
+    ProfileSince(kPhaseCopy, worker, start);
+  }
+}
+
+/**
+ * @brief Returns the first generation after `gen` the game needs to see.
+ *
+ * The generations up to it can be computed in one go, since none of them is
+ * printed, drawn, streamed, checkpointed, counted or hashed. Every
+ * generation is needed while generations are drawn by the display, which
+ * only decides on a frame once it is due, counted by `--stats` or hashed to
+ * detect cycles.
+ *
+ * @param config    A constant pointer to the game configuration.
+ * @param gen       The generation the game is at.
+ * @param due       The generation of the next checkpoint, or 0 if there is
+ *                  none. A checkpoint refused at `due` or later is offered
+ *                  again on the next generation.
+ * @param detecting Whether the generations are hashed to detect cycles.
+ *
+ * @return The next generation needed, at most `config->generations`.
+ */
+static size_t NextNeededGeneration(const config_t* config, size_t gen,
+                                   size_t due, int detecting) {
+  if (config->fps || config->stats || detecting || (due && due <= gen)) {
+    return gen + 1;
+  }
+
+  size_t needed = config->generations;
+  int printing = !config->bench &&
+                 !(config->output &&
+                   strcmp(config->output, kStandardStream) == 0);
+  if (printing && config->print_every) {
+    size_t shown = config->skip_to;
+    if (gen >= config->skip_to) {
+      size_t every = config->print_every;
+      shown += ((gen - config->skip_to) / every + 1) * every;
     }
-  } else if (IsDead(world[row][col]) && neighbor_count == 3) {
-    new_state = kAliveChar;
+    needed = shown < needed ? shown : needed;
+  }
+  if (config->output && config->output_every) {
+    size_t frame = (gen / config->output_every + 1) * config->output_every;
+    needed = frame < needed ? frame : needed;
+  }
+  if (due && due < needed) {
+    needed = due;
+  }
+  return needed;
+}
+
+/**
+ * @brief Opens the file the counters of the generations are written to, and
+ *        writes the header of its columns.
+ *
+ * @param filename The name of the file, or `kStandardStream` for the
+ *                 standard output.
+ *
+ * @return Returns the open file, or NULL if it cannot be opened, in which
+ *         case an error message is printed.
+ */
+static FILE* OpenStats(const char* filename) {
+  FILE* file = stdout;
+  if (strcmp(filename, kStandardStream) != 0) {
+    file = fopen(filename, "w");
   }
+  if (!file) {
+    fprintf(stderr, "Error: Failed to open file for writing, '%s'\n",
+            filename);
+    return NULL;
+  }
+
+  fputs("generation,population,births,deaths,top,left,bottom,right\n", file);
+  return file;
+}
+
+/**
+ * @brief Writes the counters of a generation as one line of CSV.
+ *
+ * The bounding box is left empty once the world has no live cell.
+ *
+ * @param file  The stats file.
+ * @param tiles The tile map of the world, keeping the counters of the last
+ *              generation computed.
+ * @param gen   The number of that generation.
+ *
+ * @return Returns 0 on success, -1 if the line cannot be written.
+ */
+static int WriteStats(FILE* file, const tiles_t* tiles, size_t gen) {
+  cell_stats_t stats;
+  WorldStats(tiles, &stats);
 
-  return new_state;
+  int written;
+  if (stats.population) {
+    written = fprintf(file, "%zu,%zu,%zu,%zu,%zu,%zu,%zu,%zu\n", gen,
+                      stats.population, stats.births, stats.deaths,
+                      stats.top, stats.left, stats.bottom, stats.right);
+  } else {
+    written = fprintf(file, "%zu,0,%zu,%zu,,,,\n", gen, stats.births,
+                      stats.deaths);
+  }
+  return written < 0 ? -1 : 0;
+}
+
+/**
+ * @brief Closes the stats file, reporting any line that failed to be
+ *        written.
+ *
+ * @param file     The stats file. It is safe to pass NULL.
+ * @param filename The name the file was opened with.
+ *
+ * @return Returns 0 on success, -1 if writing the file failed, in which case
+ *         an error message is printed.
+ */
+static int CloseStats(FILE* file, const char* filename) {
+  if (!file) {
+    return 0;
+  }
+
+  int failed = fflush(file) != 0 || ferror(file);
+  if (file != stdout && fclose(file) != 0) {
+    failed = 1;
+  }
+  if (failed) {
+    fprintf(stderr, "Error: Failed to write the stats, '%s'\n", filename);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Simulates a single generation step in the game.
+ *
+ * Computes the generation following `world` into `next` with the engine
+ * selected in the configuration. The rows are split into one band per worker
+ * of `pool`. `world` keeps the current generation.
+ *
+ * When the world wraps around, its padding ring is filled with the opposite
+ * edges for the duration of the step, and cleared again afterwards.
+ *
+ * Only the tiles that `tiles` reports as active are recomputed; the others
+ * already hold their next state in `next`, which must therefore hold the
+ * generation before `world`.
+ *
+ * @param world  A pointer to the current world state.
+ * @param next   A pointer to the world receiving the next generation.
+ * @param tiles  The tile map of the world, updated with the tiles that
+ *               changed.
+ * @param config A constant pointer to the game configuration detailing the
+ *               world size.
+ * @param pool   The pool of workers computing the generation.
+ */
+void SimulateGeneration(world_t* world, world_t* next, tiles_t* tiles,
+                        const config_t* config, pool_t* pool) {
+  if (config->wrap) {
+    uint64_t start = ProfileClock();
+    FillHalo(world);
+    ProfileSince(kPhaseCopy, 0, start);
+  }
+
+  generation_t generation = {(const world_t*)world, next, tiles, config};
+  RunPool(pool, SimulateBand, &generation);
+  SwapTiles(tiles);
+
+  if (config->wrap) {
+    uint64_t start = ProfileClock();
+    ClearHalo(world);
+    ProfileSince(kPhaseCopy, 0, start);
+  }
+}
+
+/**
+ * @brief Computes one worker's band of rows of a generation.
+ *
+ * Splits the rows between `kPadding` and `config->rows` into `workers` bands
+ * of nearly equal height and computes the band of `worker`. Bands are made of
+ * whole tile rows so that no tile is shared between two workers.
+ *
+ * @param arg     A pointer to the `generation_t` being computed.
+ * @param worker  The index of the calling worker.
+ * @param workers The number of workers sharing the generation.
+ */
+void SimulateBand(void* arg, size_t worker, size_t workers) {
+  generation_t* generation = arg;
+  size_t rows = generation->tiles->rows;
+  size_t begin = rows * worker / workers;
+  size_t end = rows * (worker + 1) / workers;
+
+  uint64_t start = ProfileClock();
+  StepTileRows(generation->config->engine, &generation->config->rule,
+               generation->src, generation->dst, generation->tiles, begin, end);
+  ProfileSince(kPhaseCompute, worker, start);
 }
 
 /**
  * @brief Creates the initial game world from a file.
  *
- * Reads the world configuration from a file and initializes the game world
- * grid. The grid is extended with padding as specified by the configuration.
- * Cells are set to alive or dead based on the file contents.
+ * Maps the file into memory and packs it into the game world grid, which is
+ * extended with padding. Cells are set to alive wherever the file holds
+ * `kAliveChar`; every other character, and any cell past the end of a line,
+ * is left dead. RLE and binary files, chosen by the extension of their name,
+ * are decoded instead. A size of 0 rows or columns in the configuration is
+ * replaced with the size of the pattern held by the file, and the rule of
+ * the pattern, if the file has one, replaces the configured rule unless it
+ * was set explicitly.
  *
- * @param config A constant pointer to the game configuration.
- * 
- * @return Returns a pointer to the created 2D world grid or NULL if memory
+ * When resuming, the world, its rule and its generation number are loaded
+ * from the checkpoint `config->resume` instead, and the configured size, if
+ * any, must match the size of the checkpoint.
+ *
+ * @param config A pointer to the game configuration.
+ *
+ * @return Returns a pointer to the created world grid, or NULL if the file
+ *         cannot be loaded, does not fit the configuration or memory
  *         allocation fails.
  *
  * @note This function allocates memory for the world grid that must be freed
- *       by calling `FreeGrid`.
+ *       by calling `FreeWorldGrid`.
  */
-char** CreateWorld(const config_t* config) {
-  char** world = CreateCharGrid(config->rows + kPadding + 1,
-                                config->cols + kPadding + 1, kDeadChar);
-  if (!world) {
-    return NULL;
+world_t* CreateWorld(config_t* config) {
+  rule_t rule = config->rule;
+  world_t* world;
+  if (config->resume) {
+    world = LoadCheckpoint(config->resume, &rule, &config->first_generation);
+  } else {
+    world = LoadWorld(config->filename, config->rows, config->cols,
+                      kAliveChar, &rule);
   }
-
-  FILE* fd = fopen(config->filename, "r");
-  if (!fd) {
-    fprintf(stderr, "Error: Failed to open file, '%s'\n", config->filename);
+  if (!world) {
     return NULL;
   }
 
-  char* line = NULL;
-  size_t n = 0;
-  for (size_t i = kPadding; i <= config->rows; i++) {
-    if (getline(&line, &n, fd) < 0) {
-      break;
+  if (config->resume) {
+    if ((config->rows && config->rows != world->rows) ||
+        (config->cols && config->cols != world->cols)) {
+      fprintf(stderr, "Error: The size of the checkpoint, %zux%zu, does not "
+                      "match the size of the world\n", world->rows,
+              world->cols);
+      FreeWorldGrid(world);
+      return NULL;
     }
-    for (size_t j = kPadding; j <= config->cols; j++) {
-      char linechar = line[j - kPadding];
-      if (linechar != kAliveChar) {
-        continue;
-      }
-      world[i][j] = linechar;
+    if (config->first_generation > config->generations) {
+      fprintf(stderr, "Error: The checkpoint is past the last generation, "
+                      "%zu\n", config->first_generation);
+      FreeWorldGrid(world);
+      return NULL;
     }
   }
 
-  free(line);
-  fclose(fd);
+  if (!config->rule_given) {
+    if (rule.birth & 1) {
+      char text[kRuleTextSize];
+      FormatRule(&rule, text);
+      fprintf(stderr, "Error: Rules with B0 are not supported, '%s'\n", text);
+      FreeWorldGrid(world);
+      return NULL;
+    }
+    config->rule = rule;
+  }
+  config->rows = world->rows;
+  config->cols = world->cols;
   return world;
 }
 
@@ -197,7 +834,11 @@ char** CreateWorld(const config_t* config) {
  * Initializes the game configuration based on command-line arguments. If
  * arguments are provided, they override the default settings. Validates
  * input for number of rows, columns, filename for the world configuration,
- * and number of generations.
+ * number of generations, generation engine, number of worker threads, the
+ * memory limit of the HashLife engine, whether the universe is unbounded or
+ * wraps around, the rule of the automaton, the benchmark mode, the debug
+ * mode, the checkpoints written and resumed from, the stream of generations
+ * written out, and the detection of cycles.
  *
  * @param config Pointer to the game configuration structure to be initialized.
  * @param argc   The number of command-line arguments.
@@ -212,23 +853,83 @@ int ConfigureGame(config_t* config, int argc, char* args[]) {
   config->cols = kDefaults.cols;
   config->filename = kDefaults.filename;
   config->generations = kDefaults.generations;
+  config->engine = kDefaults.engine ? kDefaults.engine : BestEngine();
+  config->threads = kDefaults.threads;
+  config->hashlife = kDefaults.hashlife;
+  config->memory_limit = kDefaults.memory_limit;
+  config->unbounded = kDefaults.unbounded;
+  config->wrap = kDefaults.wrap;
+  config->rule = kDefaults.rule;
+  config->bench = kDefaults.bench;
+  config->debug = kDefaults.debug;
+  config->rule_given = kDefaults.rule_given;
+  config->fps = kDefaults.fps;
+  config->save = kDefaults.save;
+  config->checkpoint_every = kDefaults.checkpoint_every;
+  config->checkpoint = kDefaults.checkpoint;
+  config->resume = kDefaults.resume;
+  config->first_generation = kDefaults.first_generation;
+  config->output = kDefaults.output;
+  config->output_every = kDefaults.output_every;
+  config->detect_cycles = kDefaults.detect_cycles;
+  config->batch = kDefaults.batch;
+  config->gpu = kDefaults.gpu;
+  config->temporal_block = kDefaults.temporal_block;
+  config->huge_pages = kDefaults.huge_pages;
+  config->stats = kDefaults.stats;
+  config->profile = kDefaults.profile;
+  config->print_every = kDefaults.print_every;
+  config->skip_to = kDefaults.skip_to;
+  config->metrics_port = kDefaults.metrics_port;
 
   static struct option longopts[] = {
     {"rows",        required_argument, 0,           'r'},
     {"columns",     required_argument, 0,           'c'},
     {"filename",    required_argument, 0,           'f'},
     {"generations", required_argument, 0,           'n'},
-    {"debug",       no_argument,       &debug_flag,  1 },
+    {"engine",      required_argument, 0,           'e'},
+    {"threads",     required_argument, 0,           't'},
+    {"memory-limit", required_argument, 0,          'm'},
+    {"unbounded",   no_argument,       0,           'u'},
+    {"wrap",        no_argument,       0,           'w'},
+    {"rule",        required_argument, 0,           kRuleOption},
+    {"bench",       optional_argument, 0,           kBenchOption},
+    {"fps",         required_argument, 0,           kFpsOption},
+    {"save",        required_argument, 0,           kSaveOption},
+    {"checkpoint",  required_argument, 0,           kCheckpointOption},
+    {"checkpoint-every", required_argument, 0,      kCheckpointEveryOption},
+    {"resume",      required_argument, 0,           kResumeOption},
+    {"output",      required_argument, 0,           kOutputOption},
+    {"output-every", required_argument, 0,          kOutputEveryOption},
+    {"detect-cycles", no_argument,     0,           kDetectCyclesOption},
+    {"batch",       required_argument, 0,           kBatchOption},
+    {"temporal-block", required_argument, 0,        kTemporalBlockOption},
+    {"huge-pages",  no_argument,       0,           kHugePagesOption},
+    {"stats",       required_argument, 0,           kStatsOption},
+    {"profile",     no_argument,       0,           kProfileOption},
+    {"print-every", required_argument, 0,           kPrintEveryOption},
+    {"print-final", no_argument,       0,           kPrintFinalOption},
+    {"skip-to",     required_argument, 0,           kSkipToOption},
+    {"metrics",     required_argument, 0,           kMetricsOption},
+    {"debug",       no_argument,       0,           'd'},
     {"help",        no_argument,       0,           'h'},
     {0, 0, 0, 0}
   };
 
   int opt;
-  char* optstring = "dhr:c:f:n:";
+  char* optstring = "dhuwr:c:f:n:e:t:m:";
   while ((opt = getopt_long(argc, args, optstring, longopts, 0)) != -1) {
     switch (opt) {
       case 'd':
-        debug_flag = 1;
+        config->debug = 1;
+        break;
+
+      case 'u':
+        config->unbounded = 1;
+        break;
+
+      case 'w':
+        config->wrap = 1;
         break;
 
       case 'r':
@@ -256,6 +957,185 @@ int ConfigureGame(config_t* config, int argc, char* args[]) {
         }
         break;
 
+      case 'e':
+        if (strcmp(optarg, kHashLifeEngine) == 0) {
+          config->hashlife = 1;
+          config->gpu = 0;
+          break;
+        }
+        if (strcmp(optarg, kGpuEngine) == 0) {
+#ifdef LIFE_HAVE_CUDA
+          config->hashlife = 0;
+          config->gpu = 1;
+          break;
+#else
+          fprintf(stderr, "Error: The gpu engine is not available, rebuild "
+                          "with 'make CUDA=1'\n");
+          return -1;
+#endif
+        }
+        config->hashlife = 0;
+        config->gpu = 0;
+        config->engine = FindEngine(optarg);
+        if (!config->engine) {
+          fprintf(stderr, "Error: Unknown engine, '%s'\n", optarg);
+          return -1;
+        }
+        if (!IsEngineSupported(config->engine)) {
+          fprintf(stderr, "Error: Engine '%s' is not supported by this CPU\n",
+                  optarg);
+          return -1;
+        }
+        break;
+
+      case 't':
+        if (ParseLong(&config->threads, optarg) < 0) {
+          fprintf(stderr, "Error: Invalid input for threads, '%s'\n", optarg);
+          return -1;
+        }
+        break;
+
+      case 'm':
+        if (ParseLong(&config->memory_limit, optarg) < 0) {
+          fprintf(stderr, "Error: Invalid input for memory limit, '%s'\n",
+                  optarg);
+          return -1;
+        }
+        break;
+
+      case kRuleOption:
+        if (ParseRule(optarg, &config->rule) < 0) {
+          fprintf(stderr, "Error: Invalid rule, '%s'\n", optarg);
+          return -1;
+        }
+        if (config->rule.birth & 1) {
+          fprintf(stderr, "Error: Rules with B0 are not supported, '%s'\n",
+                  optarg);
+          return -1;
+        }
+        config->rule_given = 1;
+        break;
+
+      case kSaveOption:
+        config->save = optarg;
+        break;
+
+      case kCheckpointOption:
+        config->checkpoint = optarg;
+        break;
+
+      case kCheckpointEveryOption:
+        if (ParseLong(&config->checkpoint_every, optarg) < 0 ||
+            config->checkpoint_every == 0) {
+          fprintf(stderr, "Error: Invalid input for checkpoint interval, "
+                          "'%s'\n", optarg);
+          return -1;
+        }
+        break;
+
+      case kResumeOption:
+        config->resume = optarg;
+        break;
+
+      case kDetectCyclesOption:
+        config->detect_cycles = 1;
+        break;
+
+      case kBatchOption:
+        config->batch = optarg;
+        break;
+
+      case kHugePagesOption:
+        config->huge_pages = 1;
+        break;
+
+      case kStatsOption:
+        config->stats = optarg;
+        break;
+
+      case kProfileOption:
+#ifdef LIFE_NO_PROFILE
+        fprintf(stderr, "Error: Profiling is not available, rebuild without "
+                        "'make PROFILE=0'\n");
+        return -1;
+#else
+        config->profile = 1;
+        break;
+#endif
+
+      case kPrintEveryOption:
+        if (ParseLong(&config->print_every, optarg) < 0 ||
+            config->print_every == 0) {
+          fprintf(stderr, "Error: Invalid input for print interval, '%s'\n",
+                  optarg);
+          return -1;
+        }
+        break;
+
+      case kPrintFinalOption:
+        config->print_every = 0;
+        break;
+
+      case kSkipToOption:
+        if (ParseCount(&config->skip_to, optarg) < 0) {
+          fprintf(stderr, "Error: Invalid input for skip-to, '%s'\n",
+                  optarg);
+          return -1;
+        }
+        break;
+
+      case kMetricsOption:
+        if (ParseLong(&config->metrics_port, optarg) < 0 ||
+            config->metrics_port == 0 || config->metrics_port > 65535) {
+          fprintf(stderr, "Error: Invalid input for metrics port, '%s'\n",
+                  optarg);
+          return -1;
+        }
+        break;
+
+      case kTemporalBlockOption:
+        if (ParseLong(&config->temporal_block, optarg) < 0 ||
+            config->temporal_block == 0 ||
+            config->temporal_block > kMaxTemporalDepth) {
+          fprintf(stderr, "Error: Invalid input for temporal block, '%s'\n",
+                  optarg);
+          return -1;
+        }
+        break;
+
+      case kOutputOption:
+        config->output = optarg;
+        break;
+
+      case kOutputEveryOption:
+        if (strcmp(optarg, "last") == 0) {
+          config->output_every = 0;
+        } else if (ParseLong(&config->output_every, optarg) < 0) {
+          fprintf(stderr, "Error: Invalid input for output interval, '%s'\n",
+                  optarg);
+          return -1;
+        }
+        break;
+
+      case kBenchOption:
+        if (!optarg || strcmp(optarg, "json") == 0) {
+          config->bench = kBenchJson;
+        } else if (strcmp(optarg, "csv") == 0) {
+          config->bench = kBenchCsv;
+        } else {
+          fprintf(stderr, "Error: Unknown benchmark format, '%s'\n", optarg);
+          return -1;
+        }
+        break;
+
+      case kFpsOption:
+        if (ParseLong(&config->fps, optarg) < 0 || config->fps == 0) {
+          fprintf(stderr, "Error: Invalid input for frame rate, '%s'\n",
+                  optarg);
+          return -1;
+        }
+        break;
+
       case 'h':
       case '?': 
         PrintUsage();
@@ -263,34 +1143,245 @@ int ConfigureGame(config_t* config, int argc, char* args[]) {
     }
   }
 
+  if (config->wrap && (config->hashlife || config->unbounded)) {
+    fprintf(stderr, "Error: --wrap cannot be combined with an unbounded "
+                    "universe\n");
+    return -1;
+  }
+
+  if (config->checkpoint_every && (config->hashlife || config->unbounded)) {
+    fprintf(stderr, "Error: --checkpoint-every cannot be combined with an "
+                    "unbounded universe\n");
+    return -1;
+  }
+
+  if (config->detect_cycles && (config->hashlife || config->unbounded)) {
+    fprintf(stderr, "Error: --detect-cycles cannot be combined with an "
+                    "unbounded universe\n");
+    return -1;
+  }
+
+  // The world lives on the device, and only the generations the host needs
+  // are copied back, so no hash of every generation is available
+  if (config->gpu && (config->unbounded || config->detect_cycles)) {
+    fprintf(stderr, "Error: The gpu engine cannot be combined with -u or "
+                    "--detect-cycles\n");
+    return -1;
+  }
+
+  if (config->temporal_block > 1 &&
+      (config->hashlife || config->gpu || config->unbounded)) {
+    fprintf(stderr, "Error: --temporal-block cannot be combined with an "
+                    "unbounded universe or the gpu engine\n");
+    return -1;
+  }
+
+  // The counters are kept by the tile map of a bounded world, which the
+  // other engines do not step
+  if (config->stats &&
+      (config->hashlife || config->gpu || config->unbounded)) {
+    fprintf(stderr, "Error: --stats cannot be combined with an unbounded "
+                    "universe or the gpu engine\n");
+    return -1;
+  }
+
+  // Only the game of a bounded world publishes its progress
+  if (config->metrics_port &&
+      (config->hashlife || config->gpu || config->unbounded)) {
+    fprintf(stderr, "Error: --metrics cannot be combined with an unbounded "
+                    "universe or the gpu engine\n");
+    return -1;
+  }
+
+  // Batch mode prints only the summary of its worlds, each simulated on a
+  // single thread of a bounded world
+  if (config->batch &&
+      (config->hashlife || config->gpu || config->unbounded ||
+       config->bench || config->fps || config->save || config->output ||
+       config->resume || config->checkpoint_every ||
+       config->temporal_block > 1 || config->stats || config->profile ||
+       config->print_every != 1 || config->skip_to ||
+       config->metrics_port)) {
+    fprintf(stderr, "Error: --batch cannot be combined with an unbounded "
+                    "universe, the gpu engine, --bench, --fps, --save, "
+                    "--output, --resume, --checkpoint-every, "
+                    "--temporal-block, --stats, --profile, --print-every, "
+                    "--print-final, --skip-to or --metrics\n");
+    return -1;
+  }
+
+  // The stream owns the standard output, so nothing else may print to it
+  if (config->output && strcmp(config->output, kStandardStream) == 0 &&
+      (config->bench || config->fps)) {
+    fprintf(stderr, "Error: --output - cannot be combined with --bench or "
+                    "--fps\n");
+    return -1;
+  }
+
+  // Likewise for the stats, which replace the printed generations
+  if (config->stats && strcmp(config->stats, kStandardStream) == 0 &&
+      (config->bench || config->fps ||
+       (config->output && strcmp(config->output, kStandardStream) == 0))) {
+    fprintf(stderr, "Error: --stats - cannot be combined with --bench, --fps "
+                    "or --output -\n");
+    return -1;
+  }
+
+  if (config->skip_to > config->generations) {
+    fprintf(stderr, "Error: --skip-to is past the last generation\n");
+    return -1;
+  }
+
+  // The display picks its own frames by the clock
+  if (config->fps && (config->print_every != 1 || config->skip_to)) {
+    fprintf(stderr, "Error: --fps cannot be combined with --print-every, "
+                    "--print-final or --skip-to\n");
+    return -1;
+  }
+
+  if (config->fps && (config->debug || config->bench)) {
+    fprintf(stderr, "Error: --fps cannot be combined with --debug or "
+                    "--bench\n");
+    return -1;
+  }
+
   return 0;
 }
 
+/**
+ * @brief Returns whether generation `gen` is printed.
+ *
+ * The last generation is always printed. Before it, generations are printed
+ * from `config->skip_to` on, every `config->print_every` generations, and
+ * none when `config->print_every` is 0. The game steps over the others
+ * without formatting them or pausing between them.
+ *
+ * @param config A constant pointer to the game configuration.
+ * @param gen    The generation to print.
+ *
+ * @return 1 if the generation is printed, 0 otherwise.
+ */
+int PrintsGeneration(const config_t* config, size_t gen) {
+  if (gen == config->generations) {
+    return 1;
+  }
+  if (gen < config->skip_to || !config->print_every) {
+    return 0;
+  }
+  return (gen - config->skip_to) % config->print_every == 0;
+}
+
+/**
+ * @brief Returns whether the generations are printed to standard output.
+ *
+ * Nothing is printed in benchmark mode, so that neither the output nor the
+ * pause between frames is part of the timing, nor when the generations are
+ * streamed, or their stats written, to the standard output.
+ */
+int PrintsWorld(const config_t* config) {
+  return !config->bench &&
+         !(config->output && strcmp(config->output, kStandardStream) == 0) &&
+         !(config->stats && strcmp(config->stats, kStandardStream) == 0);
+}
+
+/**
+ * @brief Returns whether the generations are drawn by a renderer, either on
+ *        the terminal outside of debug mode or at a fixed rate with `--fps`.
+ *
+ * The game only creates a renderer, which holds a copy of the world and a
+ * buffer of a whole frame, when this is set.
+ */
+int DrawsFrames(const config_t* config) {
+  return config->fps || (!config->debug && PrintsWorld(config));
+}
+
 /**
  * @brief Prints the current state of the world to standard output.
  *
- * @param world  The current state of the world as a 2D grid of characters.
- * @param config The game configuration containing the size of the world.
- * @param gen    The current generation number being printed.
+ * In debug mode, every generation is printed in full below the previous one.
+ * Otherwise, the renderer redraws only the cells that changed since the last
+ * frame, then the game pauses before the next generation.
+ *
+ * @param world    The current state of the world as a bit-packed grid.
+ * @param config   The game configuration containing the size of the world.
+ * @param gen      The current generation number being printed.
+ * @param renderer The renderer holding the frame on screen, or NULL when
+ *                 `DrawsFrames` is not set.
+ *
+ * @note Nothing is printed unless `PrintsWorld` is set.
  */
-void PrintWorld(const char** world, const config_t* config, int gen) {
-  if (!debug_flag) { system(CLEAR); }
+void PrintWorld(const world_t* world, const config_t* config, size_t gen,
+                renderer_t* renderer) {
+  if (!PrintsWorld(config)) {
+    return;
+  }
 
-  printf("Generation %d:\n", gen);
+  uint64_t start = ProfileClock();
+  if (!config->debug) {
+    fflush(stdout);
+    RenderFrame(renderer, world, gen);
+    ProfileSince(kPhaseRender, 0, start);
+    usleep(kInterval);
+    return;
+  }
+
+  printf("Generation %zu:\n", gen);
   for (size_t i = kPadding; i <= config->rows; i++) {
     for (size_t j = kPadding; j <= config->cols; j++) {
-      printf("%c", world[i][j]);
+      putchar(GetCell(world, i, j) ? kAliveChar : kDeadChar);
       if (j == config->cols) {
         putchar('\n');
       }
     }
   }
   puts("================================");
-  
-  if (!debug_flag) {
-    fflush(stdout);
-    usleep(kInterval);
+  ProfileSince(kPhaseRender, 0, start);
+}
+
+/**
+ * @brief Prints the results of a benchmark run to standard output.
+ *
+ * Reports the engine and the shape of the run along with its wall time, the
+ * generations computed per second and the cell updates per second, counting
+ * every cell of the world once per generation. A resumed run only counts the
+ * generations computed since its checkpoint. The report is a single JSON
+ * object, or a CSV header followed by one row, as selected by
+ * `config->bench`.
+ *
+ * @param config  The game configuration of the run.
+ * @param seconds The wall time of the run, in seconds.
+ */
+void PrintBenchmark(const config_t* config, double seconds) {
+  const char* engine = config->hashlife ? kHashLifeEngine
+                       : config->gpu    ? kGpuEngine
+                                        : config->engine->name;
+  const char* mode = config->hashlife || config->unbounded ? "unbounded"
+                     : config->wrap                        ? "wrap"
+                                                           : "bounded";
+  char rule[kRuleTextSize];
+  FormatRule(&config->rule, rule);
+
+  size_t steps = config->generations - config->first_generation;
+  double generations = (double)steps;
+  double cells = (double)config->rows * (double)config->cols;
+  double rate = seconds > 0 ? generations / seconds : 0;
+
+  if (config->bench == kBenchCsv) {
+    printf("engine,mode,rule,rows,columns,generations,threads,seconds,"
+           "generations_per_second,cell_updates_per_second\n");
+    printf("%s,%s,%s,%zu,%zu,%zu,%zu,%.6f,%.1f,%.1f\n", engine, mode, rule,
+           config->rows, config->cols, steps, config->threads,
+           seconds, rate, rate * cells);
+    return;
   }
+
+  printf("{\"engine\": \"%s\", \"mode\": \"%s\", \"rule\": \"%s\", "
+         "\"rows\": %zu, \"columns\": %zu, \"generations\": %zu, "
+         "\"threads\": %zu, \"seconds\": %.6f, "
+         "\"generations_per_second\": %.1f, "
+         "\"cell_updates_per_second\": %.1f}\n",
+         engine, mode, rule, config->rows, config->cols, steps,
+         config->threads, seconds, rate, rate * cells);
 }
 
 /**
@@ -299,31 +1390,49 @@ void PrintWorld(const char** world, const config_t* config, int gen) {
 void PrintUsage() {
   fprintf(stderr, "Usage: ./life [options]\n");
   fprintf(stderr, "Options:\n");
-  fprintf(stderr, "  -r, --rows NUM           Set the number of rows (default: %ld)\n", kDefaults.rows);
-  fprintf(stderr, "  -c, --columns NUM        Set the number of columns (default: %ld)\n", kDefaults.cols);
+  fprintf(stderr, "  -r, --rows NUM           Set the number of rows (default: lines of the file)\n");
+  fprintf(stderr, "  -c, --columns NUM        Set the number of columns (default: longest line)\n");
   fprintf(stderr, "  -f, --filename FILENAME  Specify the filename to use (default: %s)\n", kDefaults.filename);
   fprintf(stderr, "  -n, --generations NUM    Set the number of generations (default: %ld)\n", kDefaults.generations);
-  fprintf(stderr, "  --debug                  Enable debug mode\n");
+  fprintf(stderr, "  -e, --engine NAME        Select the generation engine: auto, scalar, swar,\n");
+  fprintf(stderr, "                           lut, avx2, avx512, neon, gpu, hashlife\n");
+  fprintf(stderr, "                           (default: auto)\n");
+  fprintf(stderr, "  -t, --threads NUM        Set the number of worker threads (default: %ld)\n", kDefaults.threads);
+  fprintf(stderr, "  -m, --memory-limit MB    Set the memory cap of the HashLife engine (default: %ld)\n", kDefaults.memory_limit);
+  fprintf(stderr, "  -u, --unbounded          Let the universe grow past the world's edges\n");
+  fprintf(stderr, "  -w, --wrap               Wrap the world's edges around into a torus\n");
+  fprintf(stderr, "  --rule <rule>            Rule in B/S notation (default: B3/S23)\n");
+  fprintf(stderr, "  --bench[=FORMAT]         Time the run without printing it, and report\n");
+  fprintf(stderr, "                           the results as json or csv (default: json)\n");
+  fprintf(stderr, "  --save FILE              Save the last generation to FILE\n");
+  fprintf(stderr, "  --checkpoint-every NUM   Save a checkpoint every NUM generations\n");
+  fprintf(stderr, "  --checkpoint FILE        Write the checkpoints to FILE (default: %s)\n", kDefaults.checkpoint);
+  fprintf(stderr, "  --resume FILE            Resume the game from the checkpoint FILE\n");
+  fprintf(stderr, "  --output FILE            Stream the generations to FILE, or - for stdout\n");
+  fprintf(stderr, "  --output-every NUM       Stream every NUM-th generation, or only the\n");
+  fprintf(stderr, "                           last with 'last' (default: %ld)\n", kDefaults.output_every);
+  fprintf(stderr, "  --detect-cycles          Skip ahead once the world dies out, settles\n");
+  fprintf(stderr, "                           or oscillates, and report its period\n");
+  fprintf(stderr, "  --temporal-block NUM     Advance up to NUM generations per pass over the\n");
+  fprintf(stderr, "                           world when they are not shown (default: %ld)\n", kDefaults.temporal_block);
+  fprintf(stderr, "  --huge-pages             Back the large worlds with transparent huge pages\n");
+  fprintf(stderr, "  --stats FILE             Write the population, births, deaths and bounding\n");
+  fprintf(stderr, "                           box of every generation to FILE, or - for stdout\n");
+  fprintf(stderr, "  --profile                Report the time spent in each phase of the run\n");
+  fprintf(stderr, "                           and the hardware counters on exit\n");
+  fprintf(stderr, "  --print-every NUM        Print every NUM-th generation (default: %ld)\n", kDefaults.print_every);
+  fprintf(stderr, "  --print-final            Print only the last generation\n");
+  fprintf(stderr, "  --skip-to NUM            Run at full speed up to generation NUM and print\n");
+  fprintf(stderr, "                           from there on (default: %ld)\n", kDefaults.skip_to);
+  fprintf(stderr, "  --metrics PORT           Serve the progress of the run in the Prometheus\n");
+  fprintf(stderr, "                           format at http://127.0.0.1:PORT/metrics\n");
+  fprintf(stderr, "  --batch MANIFEST         Simulate every world listed in MANIFEST, one\n");
+  fprintf(stderr, "                           per thread, and print a summary of each\n");
+  fprintf(stderr, "  --fps NUM                Run the simulation at full speed and draw NUM\n");
+  fprintf(stderr, "                           frames per second from a render thread\n");
+  fprintf(stderr, "  -d, --debug              Enable debug mode\n");
   fprintf(stderr, "  -h, --help               Print this message\n");
   fprintf(stderr, "\n");
   fprintf(stderr, "Example:\n");
   fprintf(stderr, "  ./life --rows 20 --columns 20 --filename \"world.txt\" -n 100\n");
 }
-
-/**
- * @brief Checks if a cell is alive.
- *
- * @param cell The character representing the cell state.
- *
- * @return 1 if the cell is alive, 0 otherwise.
- */
-inline int IsAlive(char cell) { return cell == kAliveChar; }
-
-/**
- * @brief Checks if a cell is dead.
- *
- * @param cell The character representing the cell state.
- *
- * @return 1 if the cell is dead, 0 otherwise.
- */
-inline int IsDead(char cell) { return cell == kDeadChar; }
\ No newline at end of file
@@ -6,39 +6,144 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "checkpoint.h"
+#include "cycle.h"
+#include "display.h"
+#include "engine.h"
+#ifdef LIFE_HAVE_CUDA
+#include "gpu.h"
+#endif
+#include "hashlife.h"
+#include "loader.h"
+#include "metrics.h"
+#include "pool.h"
+#include "profile.h"
+#include "render.h"
+#include "rule.h"
+#include "stream.h"
+#include "temporal.h"
+#include "tiles.h"
+#include "unbounded.h"
 #include "utils.h"
+#include "world.h"
+#include "writer.h"
 
 #ifdef _WIN32
 #include <windows.h>
-#define CLEAR "cls"
 #else
 #include <unistd.h>
-#define CLEAR "clear"
 #endif
 
+// Formats of the report printed in benchmark mode
+typedef enum {
+  kBenchOff = 0,
+  kBenchJson,
+  kBenchCsv,
+} bench_format_t;
+
 // Struct for storing game configurations
 typedef struct {
   size_t rows;
   size_t cols;
   char* filename;
   size_t generations;
+  const engine_t* engine;
+  size_t threads;
+  int hashlife;         // Run the HashLife engine instead of `engine`
+  size_t memory_limit;  // Memory cap of the HashLife engine, in megabytes
+  int unbounded;        // Let the universe grow past the edges of the world
+  int wrap;             // Wrap the edges of the world around into a torus
+  rule_t rule;          // Birth and survival rule of the automaton
+  int rule_given;       // Whether `rule` overrides the rule of the pattern
+  bench_format_t bench; // Time the run instead of printing generations
+  int debug;            // Print generations without clearing or pausing
+  size_t fps;           // Frames drawn per second by the render thread, or 0
+                        // to draw every generation
+  char* save;           // File the last generation is saved to, or NULL
+  size_t checkpoint_every;  // Generations between two checkpoints, or 0
+  char* checkpoint;     // File the checkpoints are written to
+  char* resume;         // Checkpoint the game resumes from, or NULL
+  size_t first_generation;  // Generation of the initial world, nonzero when
+                            // resuming from a checkpoint
+  char* output;         // File the generations are streamed to, or NULL
+  size_t output_every;  // Generations between two streamed frames, or 0 to
+                        // stream the last one only
+  int detect_cycles;    // Skip ahead once the world repeats itself
+  char* batch;          // Manifest of the worlds simulated in batch mode, or
+                        // NULL
+  int gpu;              // Run the gpu engine instead of `engine`
+  size_t temporal_block;  // Most generations advanced per pass over the
+                          // world while none in between is needed, or 1 to
+                          // step one generation at a time
+  int huge_pages;       // Back the large worlds with transparent huge pages
+  char* stats;          // File the counters of every generation are written
+                        // to, or NULL
+  int profile;          // Time the phases of the run and report them at exit
+  size_t print_every;   // Generations between two printed ones, or 0 to
+                        // print the last one only
+  size_t skip_to;       // First generation printed
+  size_t metrics_port;  // Loopback port the metrics are served on, or 0
 } config_t;
 
-static int debug_flag = 0;
-static const config_t kDefaults = {10, 10, "life.txt", 10};
-static const size_t kPadding = 1;
+// Work shared by the pool workers computing one generation
+typedef struct {
+  const world_t* src;
+  world_t* dst;
+  tiles_t* tiles;
+  const config_t* config;
+} generation_t;
+
+// A NULL engine selects the widest engine supported by the CPU, and 0 rows or
+// columns the size of the world in the file
+static const config_t kDefaults = {0, 0, "life.txt", 10, NULL, 1, 0, 1024,
+                                   0, 0, {kConwayBirth, kConwaySurvive}, 0,
+                                   kBenchOff, 0, 0, NULL, 0, "life.ckpt",
+                                   NULL, 0, NULL, 1, 0, NULL, 0, 1, 0,
+                                   NULL, 0, 1, 0, 0};
+
+// Values returned by `getopt_long` for the options without a short form
+enum {
+  kRuleOption = 256,
+  kBenchOption,
+  kFpsOption,
+  kSaveOption,
+  kCheckpointOption,
+  kCheckpointEveryOption,
+  kResumeOption,
+  kOutputOption,
+  kOutputEveryOption,
+  kDetectCyclesOption,
+  kBatchOption,
+  kTemporalBlockOption,
+  kHugePagesOption,
+  kStatsOption,
+  kProfileOption,
+  kPrintEveryOption,
+  kPrintFinalOption,
+  kSkipToOption,
+  kMetricsOption,
+};
+static const char* const kHashLifeEngine = "hashlife";
+static const char* const kGpuEngine = "gpu";
 static const useconds_t kInterval = 600000;  // microseconds
 static const char kAliveChar = '*';
 static const char kDeadChar = ' ';
 
 int ConfigureGame(config_t* config, int argc, char* args[]);
-char ComputeCellState(const char** world, size_t row, size_t col);
-char** CreateWorld(const config_t* config);
-static inline int IsAlive(char cell);
-static inline int IsDead(char cell);
-int PlayGame(char** world, const config_t* config);
-static inline void PrintUsage(void);
-void PrintWorld(const char** world, const config_t* config, int gen);
-void SimulateGeneration(char** world, char** world_ref, const config_t* config);
+world_t* CreateWorld(config_t* config);
+int PlayGame(world_t** world, const config_t* config);
+int PlayHashLife(world_t* world, const config_t* config);
+#ifdef LIFE_HAVE_CUDA
+int PlayGpu(world_t* world, const config_t* config);
+#endif
+int PlayUnbounded(world_t* world, const config_t* config);
+void PrintBenchmark(const config_t* config, double seconds);
+int PrintsGeneration(const config_t* config, size_t gen);
+int PrintsWorld(const config_t* config);
+int DrawsFrames(const config_t* config);
+void PrintWorld(const world_t* world, const config_t* config, size_t gen,
+                renderer_t* renderer);
+void SimulateGeneration(world_t* world, world_t* next, tiles_t* tiles,
+                        const config_t* config, pool_t* pool);
 
 #endif  // LIFE_H_
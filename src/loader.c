@@ -0,0 +1,584 @@
+/**
+ * loader.c
+ *
+ * Implements the loading of initial worlds from pattern files: plain text,
+ * RLE and a bit-packed binary format. Files are mapped into memory rather
+ * than read line by line. Text lines are found with `memchr` and turned into
+ * cells 64 bytes at a time, comparing the bytes with the live character in
+ * parallel and packing the result straight into the words of the world.
+ * Runs of live RLE cells and rows of binary cells are also written a whole
+ * word at a time.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "loader.h"
+
+// Packs `length` bytes of a line into `row`, setting the cells holding
+// `alive`
+typedef void (*pack_fn_t)(const char* bytes, size_t length, uint64_t* row,
+                          char alive);
+
+static world_t* CreatePatternWorld(const char* filename, size_t rows,
+                                   size_t cols, size_t pattern_rows,
+                                   size_t pattern_cols);
+static world_t* LoadText(const char* filename, const char* data, size_t size,
+                         size_t rows, size_t cols, char alive);
+static world_t* LoadRle(const char* filename, const char* data, size_t size,
+                        size_t rows, size_t cols, rule_t* rule);
+static world_t* LoadBinary(const char* filename, const char* data,
+                           size_t size, size_t rows, size_t cols,
+                           rule_t* rule);
+static int ParseRleHeader(const char* line, size_t length, size_t* rows,
+                          size_t* cols, rule_t* rule);
+static void MeasureWorld(const char* data, size_t size, size_t* rows,
+                         size_t* cols);
+static void SetCellRun(uint64_t* row, size_t begin, size_t end);
+static void PackRowSwar(const char* bytes, size_t length, uint64_t* row,
+                        char alive);
+static void PackTail(const char* bytes, size_t length, uint64_t* row,
+                     size_t offset, char alive);
+#ifdef LIFE_HAVE_X86_SIMD
+static void PackRowAvx2(const char* bytes, size_t length, uint64_t* row,
+                        char alive);
+#endif
+
+// Bytes turned into cells at once, one per bit of a word
+enum { kPackBytes = 64 };
+
+/**
+ * @brief Returns a mask with bit `k` set if byte `k` of `bytes` equals the
+ *        byte repeated in `pattern`.
+ *
+ * Flags the zero bytes of `bytes ^ pattern` without carries between bytes,
+ * then gathers the flag of each byte into the low byte of the result with a
+ * single multiplication.
+ */
+static inline uint64_t MatchBytes(uint64_t bytes, uint64_t pattern) {
+  const uint64_t kLow7 = 0x7F7F7F7F7F7F7F7F;
+  uint64_t x = bytes ^ pattern;
+  uint64_t hits = ~(((x & kLow7) + kLow7) | x) & ~kLow7;
+  return ((hits >> 7) * 0x0102040810204080) >> 56;
+}
+
+/**
+ * @brief Sets the cells flagged in `mask` for the 64 bytes starting at byte
+ *        `offset` of a line.
+ *
+ * Byte `k` of a line is column `k + kPadding`, so the 64 bytes straddle two
+ * words of the row.
+ */
+static inline void StoreMask(uint64_t* row, size_t offset, uint64_t mask) {
+  size_t word = offset / kWordBits;
+  row[word] |= mask << kPadding;
+  if (mask >> (kWordBits - kPadding)) {
+    row[word + 1] |= mask >> (kWordBits - kPadding);
+  }
+}
+
+/**
+ * @brief Returns the format of a pattern file from the extension of its
+ *        name, in any letter case. Unknown extensions are plain text.
+ */
+pattern_format_t PatternFormat(const char* filename) {
+  const char* extension = strrchr(filename, '.');
+  if (extension && strcasecmp(extension, kRleExtension) == 0) {
+    return kFormatRle;
+  }
+  if (extension && strcasecmp(extension, kBinaryExtension) == 0) {
+    return kFormatBinary;
+  }
+  return kFormatText;
+}
+
+/**
+ * @brief Loads a world from a pattern file.
+ *
+ * The format of the file is chosen by `PatternFormat`. In a text file, each
+ * line is a row of the world, and each byte of a line a cell, alive if it is
+ * `alive` and dead otherwise. Rows and columns missing from the file are
+ * dead, and those past the size of the world are ignored.
+ *
+ * @param filename The file to load.
+ * @param rows     The number of rows of the world, or 0 to use the size of
+ *                 the pattern.
+ * @param cols     The number of columns of the world, or 0 to use the size
+ *                 of the pattern.
+ * @param alive    The character of live cells in a text file.
+ * @param rule     The rule replaced with the rule of the pattern, for the
+ *                 formats that store one. It is left untouched otherwise.
+ *
+ * @return Returns a pointer to the new world, or NULL if the file cannot be
+ *         read or parsed, its size cannot be inferred or memory allocation
+ *         fails. An error message is printed in each case.
+ *
+ * @note The returned world must be released with `FreeWorldGrid`.
+ */
+world_t* LoadWorld(const char* filename, size_t rows, size_t cols, char alive,
+                   rule_t* rule) {
+  size_t size;
+  const char* data = MapFile(filename, &size);
+  if (!data) {
+    return NULL;
+  }
+
+  world_t* world;
+  switch (PatternFormat(filename)) {
+    case kFormatRle:
+      world = LoadRle(filename, data, size, rows, cols, rule);
+      break;
+
+    case kFormatBinary:
+      world = LoadBinary(filename, data, size, rows, cols, rule);
+      break;
+
+    default:
+      world = LoadText(filename, data, size, rows, cols, alive);
+      break;
+  }
+
+  UnmapFile(data, size);
+  return world;
+}
+
+/**
+ * @brief Maps a whole file into memory for reading.
+ *
+ * @param filename The file to map.
+ * @param size     Receives the size of the file.
+ *
+ * @return Returns the contents of the file, to be released with `UnmapFile`,
+ *         or NULL if the file cannot be read. An empty file is mapped to a
+ *         valid pointer to no data.
+ */
+const char* MapFile(const char* filename, size_t* size) {
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr, "Error: Failed to open file, '%s'\n", filename);
+    return NULL;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) < 0) {
+    fprintf(stderr, "Error: Failed to read file, '%s'\n", filename);
+    close(fd);
+    return NULL;
+  }
+
+  // An empty file cannot be mapped, but holds an empty pattern all the same
+  *size = (size_t)info.st_size;
+  if (*size == 0) {
+    close(fd);
+    return "";
+  }
+
+  void* map = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    fprintf(stderr, "Error: Failed to read file, '%s'\n", filename);
+    return NULL;
+  }
+  madvise(map, *size, MADV_SEQUENTIAL);
+  return map;
+}
+
+/**
+ * @brief Releases a file mapped by `MapFile`.
+ */
+void UnmapFile(const char* data, size_t size) {
+  if (size > 0) {
+    munmap((void*)data, size);
+  }
+}
+
+/**
+ * @brief Creates a world of the given size, or of the size of the pattern
+ *        along the dimensions given as 0.
+ *
+ * @return Returns the new world, or NULL, with an error message, if either
+ *         dimension ends up 0 or memory allocation fails.
+ */
+static world_t* CreatePatternWorld(const char* filename, size_t rows,
+                                   size_t cols, size_t pattern_rows,
+                                   size_t pattern_cols) {
+  rows = rows ? rows : pattern_rows;
+  cols = cols ? cols : pattern_cols;
+  if (rows == 0 || cols == 0) {
+    fprintf(stderr, "Error: Unable to infer the size of the world, '%s' "
+                    "is empty\n", filename);
+    return NULL;
+  }
+
+  world_t* world = CreateWorldGrid(rows, cols);
+  if (!world) {
+    fprintf(stderr, "Error: Unable to create world, memory allocation "
+                    "failed\n");
+  }
+  return world;
+}
+
+/**
+ * @brief Loads a world from a plain text file.
+ */
+static world_t* LoadText(const char* filename, const char* data, size_t size,
+                         size_t rows, size_t cols, char alive) {
+  size_t file_rows = 0;
+  size_t file_cols = 0;
+  if (rows == 0 || cols == 0) {
+    MeasureWorld(data, size, &file_rows, &file_cols);
+  }
+  world_t* world = CreatePatternWorld(filename, rows, cols, file_rows,
+                                      file_cols);
+  if (!world) {
+    return NULL;
+  }
+
+  pack_fn_t pack = PackRowSwar;
+#ifdef LIFE_HAVE_X86_SIMD
+  if (HasAvx2()) {
+    pack = PackRowAvx2;
+  }
+#endif
+
+  const char* line = data;
+  const char* end = data + size;
+  for (size_t i = kPadding; i <= world->rows && line < end; i++) {
+    const char* newline = memchr(line, '\n', (size_t)(end - line));
+    size_t length = (size_t)((newline ? newline : end) - line);
+    pack(line, length < world->cols ? length : world->cols,
+         WorldRow(world, i), alive);
+    line = newline ? newline + 1 : end;
+  }
+  return world;
+}
+
+/**
+ * @brief Loads a world from a run-length encoded file.
+ *
+ * Skips the `#` comment lines, reads the size and the optional rule from the
+ * `x = .., y = .., rule = ..` header, then decodes the runs of dead (`b`)
+ * and live (`o`) cells and of row ends (`$`) up to the final `!`. Any other
+ * letter is read as a live cell, as in multi-state patterns.
+ */
+static world_t* LoadRle(const char* filename, const char* data, size_t size,
+                        size_t rows, size_t cols, rule_t* rule) {
+  const char* line = data;
+  const char* end = data + size;
+  while (line < end && (*line == '#' || *line == '\n' || *line == '\r')) {
+    const char* newline = memchr(line, '\n', (size_t)(end - line));
+    line = newline ? newline + 1 : end;
+  }
+
+  if (line == end) {
+    fprintf(stderr, "Error: Invalid RLE header in '%s'\n", filename);
+    return NULL;
+  }
+
+  const char* newline = memchr(line, '\n', (size_t)(end - line));
+  const char* body = newline ? newline + 1 : end;
+  size_t pattern_rows, pattern_cols;
+  rule_t pattern_rule = *rule;
+  if (ParseRleHeader(line, (size_t)(body - line), &pattern_rows,
+                     &pattern_cols, &pattern_rule) < 0) {
+    fprintf(stderr, "Error: Invalid RLE header in '%s'\n", filename);
+    return NULL;
+  }
+
+  world_t* world = CreatePatternWorld(filename, rows, cols, pattern_rows,
+                                      pattern_cols);
+  if (!world) {
+    return NULL;
+  }
+
+  size_t i = kPadding;
+  size_t j = kPadding;
+  size_t count = 0;
+  for (const char* c = body; c < end && *c != '!'; c++) {
+    if (isdigit((unsigned char)*c)) {
+      if (count > (SIZE_MAX - 9) / 10) {
+        fprintf(stderr, "Error: Invalid RLE data in '%s'\n", filename);
+        FreeWorldGrid(world);
+        return NULL;
+      }
+      count = count * 10 + (size_t)(*c - '0');
+      continue;
+    }
+    if (isspace((unsigned char)*c)) {
+      continue;
+    }
+
+    size_t run = count ? count : 1;
+    count = 0;
+    if (*c == '$') {
+      i += run;
+      j = kPadding;
+    } else if (*c == 'b' || *c == '.') {
+      j += run;
+    } else if (isalpha((unsigned char)*c)) {
+      if (i <= world->rows && j <= world->cols) {
+        size_t stop = world->cols + 1 - j < run ? world->cols + 1 : j + run;
+        SetCellRun(WorldRow(world, i), j, stop);
+      }
+      j += run;
+    } else {
+      fprintf(stderr, "Error: Invalid RLE data in '%s'\n", filename);
+      FreeWorldGrid(world);
+      return NULL;
+    }
+  }
+
+  *rule = pattern_rule;
+  return world;
+}
+
+/**
+ * @brief Parses the `x = .., y = .., rule = ..` header line of an RLE file.
+ *
+ * @param line   The header line.
+ * @param length The length of the line.
+ * @param rows   Receives the height `y` of the pattern.
+ * @param cols   Receives the width `x` of the pattern.
+ * @param rule   Receives the rule of the pattern, if the header has one.
+ *
+ * @return Returns 0 on success, -1 if the line is not a valid header or its
+ *         size is too large to be allocated.
+ */
+static int ParseRleHeader(const char* line, size_t length, size_t* rows,
+                          size_t* cols, rule_t* rule) {
+  char header[256];
+  if (length >= sizeof(header)) {
+    return -1;
+  }
+
+  // Drop the spaces so that every field reads `key=value`
+  size_t size = 0;
+  for (size_t k = 0; k < length; k++) {
+    if (!isspace((unsigned char)line[k])) {
+      header[size++] = line[k];
+    }
+  }
+  header[size] = '\0';
+
+  int has_rows = 0;
+  int has_cols = 0;
+  char* saveptr;
+  for (char* field = strtok_r(header, ",", &saveptr); field;
+       field = strtok_r(NULL, ",", &saveptr)) {
+    char* value = strchr(field, '=');
+    if (!value) {
+      return -1;
+    }
+    *value++ = '\0';
+
+    if (strcmp(field, "x") == 0 || strcmp(field, "y") == 0) {
+      char* end;
+      errno = 0;
+      unsigned long long number = strtoull(value, &end, 10);
+      if (errno != 0 || end == value || *end != '\0') {
+        return -1;
+      }
+      if (field[0] == 'x') {
+        *cols = (size_t)number;
+        has_cols = 1;
+      } else {
+        *rows = (size_t)number;
+        has_rows = 1;
+      }
+    } else if (strcmp(field, "rule") == 0) {
+      if (ParseRule(value, rule) < 0) {
+        return -1;
+      }
+    }
+  }
+  if (!has_rows || !has_cols) {
+    return -1;
+  }
+
+  // A pattern whose padded rows of words cannot be counted could never be
+  // allocated
+  if (*cols > SIZE_MAX - (2 * kPadding + kWordBits - 1) ||
+      *rows > SIZE_MAX - 2 * kPadding) {
+    return -1;
+  }
+  size_t stride = (*cols + 2 * kPadding + kWordBits - 1) / kWordBits;
+  return *rows + 2 * kPadding > SIZE_MAX / sizeof(uint64_t) / stride ? -1
+                                                                      : 0;
+}
+
+/**
+ * @brief Loads a world from a binary file.
+ */
+static world_t* LoadBinary(const char* filename, const char* data,
+                           size_t size, size_t rows, size_t cols,
+                           rule_t* rule) {
+  const unsigned char* bytes = (const unsigned char*)data;
+  if (size < kBinaryHeaderSize ||
+      memcmp(bytes, kBinaryMagic, sizeof(kBinaryMagic)) != 0 ||
+      bytes[4] != kBinaryVersion) {
+    fprintf(stderr, "Error: Invalid binary pattern, '%s'\n", filename);
+    return NULL;
+  }
+
+  uint64_t pattern_rows = 0;
+  uint64_t pattern_cols = 0;
+  for (size_t b = 0; b < 8; b++) {
+    pattern_rows |= (uint64_t)bytes[8 + b] << (8 * b);
+    pattern_cols |= (uint64_t)bytes[16 + b] << (8 * b);
+  }
+  uint64_t row_bytes = (pattern_cols + 7) / 8;
+  if (pattern_cols > SIZE_MAX - 7 ||
+      (row_bytes && pattern_rows > (size - kBinaryHeaderSize) / row_bytes)) {
+    fprintf(stderr, "Error: Truncated binary pattern, '%s'\n", filename);
+    return NULL;
+  }
+
+  world_t* world = CreatePatternWorld(filename, rows, cols,
+                                      (size_t)pattern_rows,
+                                      (size_t)pattern_cols);
+  if (!world) {
+    return NULL;
+  }
+
+  size_t length = world->cols < pattern_cols ? world->cols
+                                             : (size_t)pattern_cols;
+  const unsigned char* cells = bytes + kBinaryHeaderSize;
+  for (size_t i = kPadding; i <= world->rows && i <= pattern_rows; i++) {
+    uint64_t* row = WorldRow(world, i);
+    for (size_t offset = 0; offset < length; offset += kPackBytes) {
+      size_t count = length - offset < kPackBytes ? length - offset
+                                                  : kPackBytes;
+      uint64_t mask = 0;
+      if (count == kPackBytes) {
+        memcpy(&mask, cells + offset / 8, sizeof(mask));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        mask = __builtin_bswap64(mask);
+#endif
+      } else {
+        for (size_t b = 0; b < (count + 7) / 8; b++) {
+          mask |= (uint64_t)cells[offset / 8 + b] << (8 * b);
+        }
+        mask &= ((uint64_t)1 << count) - 1;
+      }
+      StoreMask(row, offset, mask);
+    }
+    cells += row_bytes;
+  }
+
+  rule->birth = (uint16_t)(bytes[24] | bytes[25] << 8);
+  rule->survive = (uint16_t)(bytes[26] | bytes[27] << 8);
+  return world;
+}
+
+/**
+ * @brief Counts the lines of a file and the length of the longest one.
+ *
+ * A last line missing its newline still counts, and the carriage return of a
+ * CRLF line ending is not part of the line.
+ */
+static void MeasureWorld(const char* data, size_t size, size_t* rows,
+                         size_t* cols) {
+  *rows = 0;
+  *cols = 0;
+  const char* line = data;
+  const char* end = data + size;
+  while (line < end) {
+    const char* newline = memchr(line, '\n', (size_t)(end - line));
+    const char* stop = newline ? newline : end;
+    if (stop > line && stop[-1] == '\r') {
+      stop--;
+    }
+    size_t length = (size_t)(stop - line);
+    *cols = length > *cols ? length : *cols;
+    (*rows)++;
+    line = newline ? newline + 1 : end;
+  }
+}
+
+/**
+ * @brief Sets the cells of columns [`begin`, `end`) of a row alive, a word
+ *        at a time.
+ */
+static void SetCellRun(uint64_t* row, size_t begin, size_t end) {
+  while (begin < end) {
+    size_t bit = begin % kWordBits;
+    size_t count = kWordBits - bit < end - begin ? kWordBits - bit
+                                                 : end - begin;
+    uint64_t mask = count == kWordBits ? ~(uint64_t)0
+                                       : (((uint64_t)1 << count) - 1) << bit;
+    row[begin / kWordBits] |= mask;
+    begin += count;
+  }
+}
+
+/**
+ * @brief Packs a line eight bytes at a time, on any architecture.
+ */
+static void PackRowSwar(const char* bytes, size_t length, uint64_t* row,
+                        char alive) {
+  uint64_t pattern = 0x0101010101010101 * (uint8_t)alive;
+  size_t offset = 0;
+  for (; offset + kPackBytes <= length; offset += kPackBytes) {
+    uint64_t mask = 0;
+    for (size_t b = 0; b < kPackBytes / 8; b++) {
+      uint64_t chunk;
+      memcpy(&chunk, bytes + offset + 8 * b, sizeof(chunk));
+      mask |= MatchBytes(chunk, pattern) << (8 * b);
+    }
+    StoreMask(row, offset, mask);
+  }
+  PackTail(bytes, length, row, offset, alive);
+}
+
+/**
+ * @brief Packs the last bytes of a line, fewer than `kPackBytes`, starting at
+ *        byte `offset`.
+ *
+ * The bytes are copied into a zeroed block first so that no read goes past
+ * the end of the line, which may be the end of the mapping.
+ */
+static void PackTail(const char* bytes, size_t length, uint64_t* row,
+                     size_t offset, char alive) {
+  if (offset >= length) {
+    return;
+  }
+
+  char block[kPackBytes];
+  memset(block, 0, sizeof(block));
+  memcpy(block, bytes + offset, length - offset);
+
+  uint64_t pattern = 0x0101010101010101 * (uint8_t)alive;
+  uint64_t mask = 0;
+  for (size_t b = 0; b < kPackBytes / 8; b++) {
+    uint64_t chunk;
+    memcpy(&chunk, block + 8 * b, sizeof(chunk));
+    mask |= MatchBytes(chunk, pattern) << (8 * b);
+  }
+  // Zero bytes never match, as the live character is printable
+  mask &= ((uint64_t)1 << (length - offset)) - 1;
+  StoreMask(row, offset, mask);
+}
+
+#ifdef LIFE_HAVE_X86_SIMD
+#include <immintrin.h>
+
+/**
+ * @brief Packs a line 32 bytes at a time with AVX2.
+ */
+__attribute__((target("avx2")))
+static void PackRowAvx2(const char* bytes, size_t length, uint64_t* row,
+                        char alive) {
+  __m256i pattern = _mm256_set1_epi8(alive);
+  size_t offset = 0;
+  for (; offset + kPackBytes <= length; offset += kPackBytes) {
+    __m256i low = _mm256_loadu_si256((const __m256i*)(bytes + offset));
+    __m256i high = _mm256_loadu_si256((const __m256i*)(bytes + offset + 32));
+    uint32_t low_mask =
+        (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, pattern));
+    uint32_t high_mask =
+        (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, pattern));
+    StoreMask(row, offset, (uint64_t)high_mask << 32 | low_mask);
+  }
+  PackTail(bytes, length, row, offset, alive);
+}
+#endif
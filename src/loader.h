@@ -0,0 +1,48 @@
+#ifndef LOADER_H_
+#define LOADER_H_
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "engine.h"
+#include "rule.h"
+#include "world.h"
+
+// Formats of pattern files, chosen from the extension of their name.
+//
+// The binary format starts with a header of `kBinaryHeaderSize` bytes: the
+// magic `kBinaryMagic`, a version byte, three reserved bytes, the number of
+// rows and of columns as 64-bit little-endian integers, and the birth and
+// survival masks of the rule as 16-bit little-endian integers, padded with
+// four reserved bytes. Each row follows as `(cols + 7) / 8` bytes, with
+// column `j` in bit `j % 8` of byte `j / 8`.
+typedef enum {
+  kFormatText = 0,  // One line per row and one character per cell
+  kFormatRle,       // Run-length encoded, as shared by the Life community
+  kFormatBinary,    // Bit-packed cells behind a fixed header
+} pattern_format_t;
+
+static const char kRleExtension[] = ".rle";
+static const char kBinaryExtension[] = ".lifb";
+static const char kBinaryMagic[4] = {'L', 'I', 'F', 'B'};
+enum {
+  kBinaryVersion = 1,
+  kBinaryHeaderSize = 32,
+};
+
+pattern_format_t PatternFormat(const char* filename);
+world_t* LoadWorld(const char* filename, size_t rows, size_t cols, char alive,
+                   rule_t* rule);
+const char* MapFile(const char* filename, size_t* size);
+void UnmapFile(const char* data, size_t size);
+
+#endif  // LOADER_H_
@@ -0,0 +1,213 @@
+/**
+ * lut.c
+ *
+ * Implements the lookup table engine, which computes the world in blocks of
+ * 2x2 cells. The 4x4 cells around a block, four bits from each of the four
+ * rows covering it, form a 16-bit index into a table holding the next state
+ * of the block, so each lookup replaces the neighbour counts of four cells.
+ * It needs neither wide registers nor a fast population count, which makes
+ * it a portable middle ground between the scalar engine and the SIMD ones.
+ *
+ * The table depends on the rule, so it is built the first time a rule is
+ * stepped and kept until the program exits, shared by every thread.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "engine.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+// Number of 4x4 neighbourhoods, and of entries in a table
+enum { kLutEntries = 1 << 16 };
+
+// Table of the next state of every 2x2 block under one rule. Entry `index`
+// holds the block inside the 4x4 cells whose row `r` is bits [4r, 4r + 4) of
+// `index`, column `c` of a row being its bit `c`. Bits 0 and 1 of the entry
+// are columns 1 and 2 of row 1, bits 2 and 3 those of row 2.
+typedef struct lut_table_t {
+  rule_t rule;
+  struct lut_table_t* next;  // Table of the rule built before this one
+  uint8_t blocks[kLutEntries];
+} lut_table_t;
+
+static const lut_table_t* FindLutTable(const rule_t* rule);
+static lut_table_t* BuildLutTable(const rule_t* rule);
+
+// Tables built so far, newest first. The list only grows, so readers walk it
+// without the lock, which only serializes the threads adding to it.
+static lut_table_t* lut_tables = NULL;
+static pthread_mutex_t lut_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Returns the index of the 4x4 cells around the block at bit `b` of
+ *        four rows, from their columns `b - 1` to `b + 2`.
+ *
+ * `w0` to `w3` hold each row shifted left by one column, with the last cell
+ * of the word before it in bit 0, so that the columns around the block start
+ * at bit `b` of them. `b` is at most 60, since the block at bit 62 reaches
+ * into the next word.
+ */
+__attribute__((always_inline))
+static inline unsigned LutIndex(uint64_t w0, uint64_t w1, uint64_t w2,
+                                uint64_t w3, unsigned b) {
+  return (unsigned)((w0 >> b) & 0xF) | (unsigned)((w1 >> b) & 0xF) << 4 |
+         (unsigned)((w2 >> b) & 0xF) << 8 | (unsigned)((w3 >> b) & 0xF) << 12;
+}
+
+/**
+ * @brief Computes the next state of one word of two rows from the four rows
+ *        around them.
+ *
+ * @param rows   The row above the two rows, the two rows and the row below
+ *               them, each pointing at the word.
+ * @param blocks The table of the rule.
+ * @param top    Receives the next state of the word of the first row.
+ * @param bottom Receives the next state of the word of the second row.
+ */
+__attribute__((always_inline))
+static inline void LutStepWords(const uint64_t* const rows[4],
+                                const uint8_t* blocks, uint64_t* top,
+                                uint64_t* bottom) {
+  uint64_t w[4];
+  uint64_t edge = 0;
+  for (int r = 0; r < 4; r++) {
+    w[r] = (rows[r][0] << 1) | (rows[r][-1] >> 63);
+    // Columns 61 to 64 of the row, the last of which is column 0 of the next
+    // word
+    edge |= ((rows[r][0] >> 61) | (rows[r][1] & 1) << 3) << (4 * r);
+  }
+
+  uint64_t up = 0;
+  uint64_t down = 0;
+  for (unsigned b = 0; b < 62; b += 2) {
+    uint64_t block = blocks[LutIndex(w[0], w[1], w[2], w[3], b)];
+    up |= (block & 3) << b;
+    down |= (block >> 2) << b;
+  }
+  uint64_t block = blocks[edge];
+  *top = up | (block & 3) << 62;
+  *bottom = down | (block >> 2) << 62;
+}
+
+/**
+ * @brief Advances a region of the world two rows and two columns at a time.
+ *
+ * Every word of the region is computed by looking up its 2x2 blocks, two
+ * rows at a time. A region with an odd number of rows computes its last row
+ * on its own, from the blocks of the rows it spans. The padding columns at
+ * both ends of each row are cleared afterwards, like in the SWAR engine. If
+ * the table of the rule cannot be allocated, the region is computed by the
+ * SWAR engine instead.
+ *
+ * @param src    The world holding the current generation.
+ * @param dst    The world receiving the next generation.
+ * @param region The region of the world to compute.
+ * @param rule   The rule deciding births and survivals.
+ */
+void StepLut(const world_t* src, world_t* dst, const region_t* region,
+             const rule_t* rule) {
+  const lut_table_t* table = FindLutTable(rule);
+  if (!table) {
+    StepSwar(src, dst, region, rule);
+    return;
+  }
+
+  for (size_t i = region->row_begin; i < region->row_end; i += 2) {
+    int pair = i + 1 < region->row_end;
+    uint64_t* out_top = WorldRow(dst, i);
+    uint64_t* out_bottom = pair ? WorldRow(dst, i + 1) : NULL;
+
+    // The row two below a single last row may lie past the bottom padding
+    // row, and only the second row of the blocks depends on it
+    const uint64_t* below = WorldRow(src, pair ? i + 2 : i + 1);
+
+    for (size_t k = region->word_begin; k < region->word_end; k++) {
+      const uint64_t* const rows[4] = {WorldRow(src, i - 1) + k,
+                                       WorldRow(src, i) + k,
+                                       WorldRow(src, i + 1) + k, below + k};
+      uint64_t top, bottom;
+      LutStepWords(rows, table->blocks, &top, &bottom);
+      out_top[k] = top;
+      if (pair) {
+        out_bottom[k] = bottom;
+      }
+    }
+    ClearPaddingColumns(src, out_top, region);
+    if (pair) {
+      ClearPaddingColumns(src, out_bottom, region);
+    }
+  }
+}
+
+/**
+ * @brief Returns the table of a rule, building it if no thread has yet.
+ *
+ * @return Returns a pointer to the table, or NULL if memory allocation
+ *         fails.
+ */
+static const lut_table_t* FindLutTable(const rule_t* rule) {
+  for (const lut_table_t* table = __atomic_load_n(&lut_tables,
+                                                  __ATOMIC_ACQUIRE);
+       table; table = table->next) {
+    if (table->rule.birth == rule->birth &&
+        table->rule.survive == rule->survive) {
+      return table;
+    }
+  }
+
+  pthread_mutex_lock(&lut_lock);
+  lut_table_t* table = lut_tables;
+  while (table && (table->rule.birth != rule->birth ||
+                   table->rule.survive != rule->survive)) {
+    table = table->next;
+  }
+  if (!table) {
+    table = BuildLutTable(rule);
+    if (table) {
+      table->next = lut_tables;
+      __atomic_store_n(&lut_tables, table, __ATOMIC_RELEASE);
+    }
+  }
+  pthread_mutex_unlock(&lut_lock);
+  return table;
+}
+
+/**
+ * @brief Builds the table of a rule, counting the neighbours of the four
+ *        cells of the block of every 4x4 neighbourhood.
+ *
+ * @return Returns a pointer to the new table, or NULL if memory allocation
+ *         fails.
+ */
+static lut_table_t* BuildLutTable(const rule_t* rule) {
+  lut_table_t* table = malloc(sizeof(lut_table_t));
+  if (!table) {
+    return NULL;
+  }
+
+  table->rule = *rule;
+  table->next = NULL;
+  for (unsigned index = 0; index < kLutEntries; index++) {
+    uint8_t block = 0;
+    for (unsigned r = 1; r <= 2; r++) {
+      for (unsigned c = 1; c <= 2; c++) {
+        int neighbor_count = 0;
+        for (unsigned i = r - 1; i <= r + 1; i++) {
+          for (unsigned j = c - 1; j <= c + 1; j++) {
+            if (i != r || j != c) {
+              neighbor_count += (index >> (4 * i + j)) & 1;
+            }
+          }
+        }
+        int alive = (index >> (4 * r + c)) & 1;
+        block |= (uint8_t)(NextCellState(rule, alive, neighbor_count)
+                           << (2 * (r - 1) + (c - 1)));
+      }
+    }
+    table->blocks[index] = block;
+  }
+  return table;
+}
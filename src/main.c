@@ -0,0 +1,140 @@
+/**
+ * main.c
+ *
+ * Entry point of the Game of Life simulator. Parses the command line, loads
+ * the initial world and runs the game, leaving the simulation itself to
+ * liblife, built from life.c and the other modules, so that other programs,
+ * such as the benchmark harness or a service embedding the simulator, can
+ * link against it.
+ *
+ * Usage: ./life [options]
+ * Options:
+ *   -r, --rows NUM           Set the number of rows (default: lines of the
+ *                            file)
+ *   -c, --columns NUM        Set the number of columns (default: longest
+ *                            line)
+ *   -f, --filename FILENAME  Specify the filename to use (default: life.txt)
+ *   -n, --generations NUM    Set the number of generations (default: 10)
+ *   -e, --engine NAME        Select the generation engine, gpu included in
+ *                            CUDA builds (default: auto)
+ *   -t, --threads NUM        Set the number of worker threads (default: 1)
+ *   -m, --memory-limit MB    Set the memory cap of the HashLife engine
+ *                            (default: 1024)
+ *   -u, --unbounded          Let the universe grow past the world's edges
+ *   -w, --wrap               Wrap the world's edges around into a torus
+ *   --rule <rule>            Rule in B/S notation (default: B3/S23)
+ *   --bench[=FORMAT]         Time the run without printing it, and report
+ *                            the results as json or csv (default: json)
+ *   --save FILE              Save the last generation to FILE
+ *   --checkpoint-every NUM   Save a checkpoint every NUM generations
+ *   --checkpoint FILE        Write the checkpoints to FILE (default:
+ *                            life.ckpt)
+ *   --resume FILE            Resume the game from the checkpoint FILE
+ *   --output FILE            Stream the generations to FILE, or - for stdout
+ *   --output-every NUM       Stream every NUM-th generation, or only the
+ *                            last with 'last' (default: 1)
+ *   --detect-cycles          Skip ahead once the world dies out, settles
+ *                            or oscillates, and report its period
+ *   --temporal-block NUM     Advance up to NUM generations per pass over
+ *                            the world when they are not shown (default: 1)
+ *   --huge-pages             Back the large worlds with transparent huge
+ *                            pages
+ *   --stats FILE             Write the population, births, deaths and
+ *                            bounding box of every generation to FILE, or -
+ *                            for stdout
+ *   --profile                Report the time spent in each phase of the run
+ *                            and the hardware counters on exit
+ *   --print-every NUM        Print every NUM-th generation (default: 1)
+ *   --print-final            Print only the last generation
+ *   --skip-to NUM            Run at full speed up to generation NUM and
+ *                            print from there on (default: 0)
+ *   --metrics PORT           Serve the progress of the run in the
+ *                            Prometheus format at
+ *                            http://127.0.0.1:PORT/metrics
+ *   --batch MANIFEST         Simulate every world listed in MANIFEST, one
+ *                            per thread, and print a summary of each
+ *   --fps NUM                Run the simulation at full speed and draw NUM
+ *                            frames per second from a render thread
+ *   -d, --debug              Enable debug mode
+ *   -h, --help               Print this message
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "batch.h"
+#include "life.h"
+
+#ifdef LIFE_HAVE_MPI
+#include "cluster.h"
+#endif
+
+static int RunGame(int argc, char* argv[]);
+
+int main(int argc, char* argv[]) {
+#ifdef LIFE_HAVE_MPI
+  // Started on several ranks, every rank simulates a block of the world
+  MPI_Init(&argc, &argv);
+  int status;
+  if (ClusterSize() > 1) {
+    status = RunCluster(argc, argv) < 0 ? 1 : 0;
+  } else {
+    status = RunGame(argc, argv);
+  }
+  MPI_Finalize();
+  return status;
+#else
+  return RunGame(argc, argv);
+#endif
+}
+
+/**
+ * @brief Runs the game in this process alone.
+ *
+ * @return Returns the exit status of the program.
+ */
+static int RunGame(int argc, char* argv[]) {
+  config_t config;
+  if (ConfigureGame(&config, argc, argv) != 0) {
+    return 1;
+  }
+
+  if (config.batch) {
+    return RunBatch((const config_t*)&config) < 0 ? 1 : 0;
+  }
+
+  if (config.profile && StartProfile(config.threads) < 0) {
+    fprintf(stderr, "Error: Unable to start the profiler, memory allocation "
+                    "failed.\n");
+    return 1;
+  }
+  uint64_t parse = ProfileClock();
+  world_t* world = CreateWorld(&config);
+  ProfileSince(kPhaseParse, 0, parse);
+  if (!world) {
+    StopProfile();
+    return 1;
+  }
+
+  double start = MonotonicSeconds();
+  if (PlayGame(&world, (const config_t*)&config) < 0) {
+    fprintf(stderr, "Error: Unable to run the simulation, memory allocation, "
+                    "thread creation or the output stream failed.\n");
+    FreeWorldGrid(world);
+    StopProfile();
+    return 1;
+  }
+
+  if (config.bench) {
+    PrintBenchmark((const config_t*)&config, MonotonicSeconds() - start);
+  }
+  PrintProfile(stderr);
+  StopProfile();
+  if (config.save && SaveWorld((const world_t*)world, &config.rule,
+                               config.save, kAliveChar, kDeadChar) < 0) {
+    FreeWorldGrid(world);
+    return 1;
+  }
+  FreeWorldGrid(world);
+  return 0;
+}
@@ -0,0 +1,356 @@
+/**
+ * metrics.c
+ *
+ * Implements the metrics server behind `--metrics`, a thread answering HTTP
+ * requests for `/metrics` with the progress of the game in the Prometheus
+ * text format: the generation it is at, the generations computed per second
+ * since the previous scrape, the population and the memory in use. Requests
+ * are served one at a time from the loopback interface, so a scraper polling
+ * a run of several days costs it two atomic operations per generation.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "metrics.h"
+
+static void* MetricsMain(void* arg);
+static void ServeScrape(metrics_t* metrics, int client);
+static size_t FormatMetrics(metrics_t* metrics, char* text, size_t size);
+static uint64_t MetricsClock(void);
+static int ReadResidentBytes(uint64_t* bytes);
+
+/**
+ * @brief Starts serving the metrics of a game on a port of the loopback
+ *        interface.
+ *
+ * @param port             The TCP port to listen on, from 1 to 65535.
+ * @param first_generation The generation the game starts at.
+ * @param last_generation  The generation the game stops at.
+ *
+ * @return Returns a pointer to the new server on success, or NULL if memory
+ *         allocation, the creation of the socket or of the thread fails. An
+ *         error message is printed if the port cannot be listened on.
+ *
+ * @note The returned server must be released with `FreeMetrics`.
+ */
+metrics_t* CreateMetrics(size_t port, size_t first_generation,
+                         size_t last_generation) {
+  metrics_t* metrics = calloc(1, sizeof(metrics_t));
+  if (!metrics) {
+    return NULL;
+  }
+
+  // The game counts the population of its first generation right away
+  metrics->generation = first_generation;
+  metrics->population_wanted = 1;
+  metrics->population_generation = first_generation;
+  metrics->last_generation = last_generation;
+  metrics->scraped_generation = first_generation;
+  metrics->wake[0] = -1;
+  metrics->wake[1] = -1;
+  metrics->listener = socket(AF_INET, SOCK_STREAM, 0);
+  if (metrics->listener < 0 || pipe(metrics->wake) < 0) {
+    fprintf(stderr, "Error: Failed to serve the metrics, '%s'\n",
+            strerror(errno));
+    FreeMetrics(metrics);
+    return NULL;
+  }
+
+  int reuse = 1;
+  setsockopt(metrics->listener, SOL_SOCKET, SO_REUSEADDR, &reuse,
+             sizeof(reuse));
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons((uint16_t)port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (bind(metrics->listener, (const struct sockaddr*)&address,
+           sizeof(address)) < 0 ||
+      listen(metrics->listener, SOMAXCONN) < 0) {
+    fprintf(stderr, "Error: Failed to serve the metrics on port %zu, '%s'\n",
+            port, strerror(errno));
+    FreeMetrics(metrics);
+    return NULL;
+  }
+
+  pthread_mutex_init(&metrics->lock, NULL);
+  metrics->start = MetricsClock();
+  metrics->scraped = metrics->start;
+  if (pthread_create(&metrics->thread, NULL, MetricsMain, metrics) != 0) {
+    pthread_mutex_destroy(&metrics->lock);
+    FreeMetrics(metrics);
+    return NULL;
+  }
+  metrics->running = 1;
+  return metrics;
+}
+
+/**
+ * @brief Stops the server thread, closes its socket and frees the server.
+ *
+ * A scrape being answered is finished first.
+ *
+ * @param metrics The server to free. It is safe to pass NULL.
+ */
+void FreeMetrics(metrics_t* metrics) {
+  if (!metrics) {
+    return;
+  }
+
+  if (metrics->running) {
+    char stop = 0;
+    while (write(metrics->wake[1], &stop, 1) < 0 && errno == EINTR) {
+    }
+    pthread_join(metrics->thread, NULL);
+    pthread_mutex_destroy(&metrics->lock);
+  }
+  for (int i = 0; i < 2; i++) {
+    if (metrics->wake[i] >= 0) {
+      close(metrics->wake[i]);
+    }
+  }
+  if (metrics->listener >= 0) {
+    close(metrics->listener);
+  }
+  free(metrics);
+}
+
+/**
+ * @brief Publishes the generation the game is at.
+ *
+ * A single store, cheap enough to be made after every generation.
+ */
+void PublishGeneration(metrics_t* metrics, size_t gen) {
+  __atomic_store_n(&metrics->generation, (uint64_t)gen, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Returns whether a scrape asked for the population to be counted
+ *        again.
+ */
+int WantsPopulation(metrics_t* metrics) {
+  return __atomic_load_n(&metrics->population_wanted, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Publishes the population of a generation, served by the next
+ *        scrapes.
+ *
+ * @param metrics    The server to publish to.
+ * @param gen        The generation counted.
+ * @param population The number of live cells of that generation.
+ */
+void PublishPopulation(metrics_t* metrics, size_t gen, size_t population) {
+  pthread_mutex_lock(&metrics->lock);
+  metrics->population = population;
+  metrics->population_generation = gen;
+  pthread_mutex_unlock(&metrics->lock);
+  __atomic_store_n(&metrics->population_wanted, 0, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Main loop of the server thread, which answers the scrapes until
+ *        `FreeMetrics` wakes it up.
+ *
+ * @param arg A pointer to the `metrics_t` served.
+ */
+static void* MetricsMain(void* arg) {
+  metrics_t* metrics = arg;
+  struct pollfd fds[2] = {
+      {metrics->listener, POLLIN, 0},
+      {metrics->wake[0], POLLIN, 0},
+  };
+
+  for (;;) {
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    if (fds[1].revents) {
+      break;
+    }
+    if (fds[0].revents & POLLIN) {
+      int client = accept(metrics->listener, NULL, NULL);
+      if (client >= 0) {
+        ServeScrape(metrics, client);
+        close(client);
+      }
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Reads a request from a client and answers it.
+ *
+ * `GET /metrics` is answered with the metrics, and any other request with
+ * 404. A client is given a second in all to send its request, so that a
+ * stalled or trickling one never holds the thread for long.
+ */
+static void ServeScrape(metrics_t* metrics, int client) {
+  uint64_t deadline = MetricsClock() + kMetricsRequestNanos;
+
+  char request[kMetricsRequestSize + 1];
+  size_t length = 0;
+  while (length < kMetricsRequestSize) {
+    // Each read waits at most for the time left until the deadline, which
+    // holds for the whole request rather than for every read of it
+    uint64_t now = MetricsClock();
+    if (now >= deadline) {
+      break;
+    }
+    uint64_t left = deadline - now;
+    struct timeval timeout = {(time_t)(left / 1000000000),
+                              (suseconds_t)(left % 1000000000 / 1000)};
+    if (timeout.tv_sec == 0 && timeout.tv_usec == 0) {
+      timeout.tv_usec = 1;
+    }
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ssize_t received = recv(client, request + length,
+                            kMetricsRequestSize - length, 0);
+    if (received <= 0) {
+      break;
+    }
+    length += (size_t)received;
+    request[length] = '\0';
+    if (strstr(request, "\r\n\r\n") || strstr(request, "\n\n")) {
+      break;
+    }
+  }
+  request[length] = '\0';
+
+  static const char kPath[] = "GET /metrics";
+  size_t path = sizeof(kPath) - 1;
+  int found = strncmp(request, kPath, path) == 0 &&
+              (request[path] == ' ' || request[path] == '?');
+
+  char body[2048];
+  size_t body_length = 0;
+  if (found) {
+    body_length = FormatMetrics(metrics, body, sizeof(body));
+  } else {
+    body_length = (size_t)snprintf(body, sizeof(body), "Not found\n");
+  }
+  char header[256];
+  int header_length = snprintf(
+      header, sizeof(header),
+      "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n"
+      "Connection: close\r\n\r\n",
+      found ? "200 OK" : "404 Not Found",
+      found ? "text/plain; version=0.0.4" : "text/plain", body_length);
+  if (send(client, header, (size_t)header_length, MSG_NOSIGNAL) ==
+      header_length) {
+    send(client, body, body_length, MSG_NOSIGNAL);
+  }
+}
+
+/**
+ * @brief Formats the metrics of the game, and asks the game to count the
+ *        population again for the next scrape.
+ *
+ * @return The length of the text written to `text`.
+ */
+static size_t FormatMetrics(metrics_t* metrics, char* text, size_t size) {
+  uint64_t now = MetricsClock();
+  uint64_t gen = __atomic_load_n(&metrics->generation, __ATOMIC_RELAXED);
+  double elapsed = (double)(now - metrics->scraped) / 1e9;
+  double rate = elapsed > 0
+                    ? (double)(gen - metrics->scraped_generation) / elapsed
+                    : 0;
+  metrics->scraped = now;
+  metrics->scraped_generation = gen;
+
+  pthread_mutex_lock(&metrics->lock);
+  uint64_t population = metrics->population;
+  uint64_t population_generation = metrics->population_generation;
+  pthread_mutex_unlock(&metrics->lock);
+  __atomic_store_n(&metrics->population_wanted, 1, __ATOMIC_RELAXED);
+
+  struct rusage usage;
+  uint64_t peak = 0;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    // Reported in kilobytes on Linux
+    peak = (uint64_t)usage.ru_maxrss * 1024;
+  }
+
+  int written = snprintf(
+      text, size,
+      "# HELP life_generation Generation the game is at.\n"
+      "# TYPE life_generation gauge\n"
+      "life_generation %llu\n"
+      "# HELP life_last_generation Generation the game stops at.\n"
+      "# TYPE life_last_generation gauge\n"
+      "life_last_generation %llu\n"
+      "# HELP life_generations_per_second Generations computed per second "
+      "since the previous scrape.\n"
+      "# TYPE life_generations_per_second gauge\n"
+      "life_generations_per_second %.3f\n"
+      "# HELP life_population Live cells of the generation "
+      "life_population_generation.\n"
+      "# TYPE life_population gauge\n"
+      "life_population %llu\n"
+      "# HELP life_population_generation Generation the population was "
+      "counted at.\n"
+      "# TYPE life_population_generation gauge\n"
+      "life_population_generation %llu\n"
+      "# HELP life_peak_resident_memory_bytes Most memory the process held "
+      "in RAM.\n"
+      "# TYPE life_peak_resident_memory_bytes gauge\n"
+      "life_peak_resident_memory_bytes %llu\n"
+      "# HELP life_uptime_seconds Time since the metrics were first "
+      "served.\n"
+      "# TYPE life_uptime_seconds gauge\n"
+      "life_uptime_seconds %.3f\n",
+      (unsigned long long)gen, (unsigned long long)metrics->last_generation,
+      rate, (unsigned long long)population,
+      (unsigned long long)population_generation, (unsigned long long)peak,
+      (double)(now - metrics->start) / 1e9);
+  size_t length = written > 0 ? (size_t)written : 0;
+
+  uint64_t resident;
+  if (length < size && ReadResidentBytes(&resident) == 0) {
+    written = snprintf(
+        text + length, size - length,
+        "# HELP life_resident_memory_bytes Memory the process holds in "
+        "RAM.\n"
+        "# TYPE life_resident_memory_bytes gauge\n"
+        "life_resident_memory_bytes %llu\n",
+        (unsigned long long)resident);
+    length += written > 0 ? (size_t)written : 0;
+  }
+  return length < size ? length : size - 1;
+}
+
+/**
+ * @brief Returns the monotonic clock in nanoseconds.
+ */
+static uint64_t MetricsClock(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Reads the memory the process currently holds in RAM.
+ *
+ * @return Returns 0 on success, -1 if the system does not report it, as on
+ *         systems without `/proc`.
+ */
+static int ReadResidentBytes(uint64_t* bytes) {
+  FILE* file = fopen("/proc/self/statm", "r");
+  if (!file) {
+    return -1;
+  }
+  unsigned long long size;
+  unsigned long long pages;
+  int read = fscanf(file, "%llu %llu", &size, &pages);
+  fclose(file);
+  if (read != 2) {
+    return -1;
+  }
+  *bytes = (uint64_t)pages * (uint64_t)sysconf(_SC_PAGESIZE);
+  return 0;
+}
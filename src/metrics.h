@@ -0,0 +1,55 @@
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+// Most bytes of a request read before it is answered
+enum { kMetricsRequestSize = 1024 };
+// Time a client is given to send its whole request, in nanoseconds
+static const uint64_t kMetricsRequestNanos = 1000000000;
+
+// Server thread exposing the progress of a running game over HTTP.
+//
+// The game publishes its generation with an atomic store after every
+// generation, and the server thread reads it whenever it is scraped, so
+// monitoring never pauses the simulation. Counting the population takes a
+// pass over the world, so the game only counts it once a scrape asked for
+// it, which is the only time it takes the lock, and the population served is
+// the one of the generation counted after the previous scrape.
+typedef struct {
+  uint64_t generation;             // Generation the game is at
+  int population_wanted;           // Whether a scrape asked for a recount
+  uint64_t population;             // Live cells of `population_generation`
+  uint64_t population_generation;
+  pthread_mutex_t lock;            // Guards the population and its generation
+  uint64_t last_generation;        // Generation the game stops at
+  uint64_t start;                  // Clock when the server started, in ns
+  uint64_t scraped;                // Clock of the previous scrape, in ns
+  uint64_t scraped_generation;     // Generation at the previous scrape
+  int listener;                    // Socket accepting the scrapes
+  int wake[2];                     // Pipe waking the thread up to stop it
+  int running;                     // Whether the thread was started
+  pthread_t thread;
+} metrics_t;
+
+metrics_t* CreateMetrics(size_t port, size_t first_generation,
+                         size_t last_generation);
+void FreeMetrics(metrics_t* metrics);
+void PublishGeneration(metrics_t* metrics, size_t gen);
+int WantsPopulation(metrics_t* metrics);
+void PublishPopulation(metrics_t* metrics, size_t gen, size_t population);
+
+#endif  // METRICS_H_
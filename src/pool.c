@@ -0,0 +1,171 @@
+/**
+ * pool.c
+ *
+ * Implements a persistent pool of worker threads. The threads are created
+ * once and then run one task after another, meeting at a barrier at the end
+ * of each task, so splitting a generation between workers does not pay for
+ * spawning threads every time.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "pool.h"
+
+/**
+ * @brief Main loop of a spawned worker.
+ *
+ * Waits for a new round to start, runs its share of the task, then reports
+ * completion to the thread waiting in `RunPool`, along with the time it did
+ * when profiling.
+ *
+ * @param arg A pointer to the worker's `pool_worker_t`.
+ *
+ * @return Always NULL.
+ */
+static void* PoolWorkerMain(void* arg) {
+  pool_worker_t* worker = arg;
+  pool_t* pool = worker->pool;
+  size_t seen = 0;
+
+  pthread_mutex_lock(&pool->lock);
+  for (;;) {
+    while (pool->round == seen && !pool->stop) {
+      pthread_cond_wait(&pool->start, &pool->lock);
+    }
+    if (pool->stop) {
+      break;
+    }
+    seen = pool->round;
+    pthread_mutex_unlock(&pool->lock);
+
+    pool->task(pool->arg, worker->index, pool->size);
+    worker->finished = ProfileClock();
+
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->pending == 0) {
+      pthread_cond_signal(&pool->done);
+    }
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+/**
+ * @brief Stops and joins the first `count` spawned workers of a pool.
+ */
+static void StopPoolWorkers(pool_t* pool, size_t count) {
+  pthread_mutex_lock(&pool->lock);
+  pool->stop = 1;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->lock);
+
+  for (size_t i = 0; i < count; i++) {
+    pthread_join(pool->workers[i].thread, NULL);
+  }
+}
+
+/**
+ * @brief Creates a pool of `size` workers.
+ *
+ * Spawns `size - 1` threads; the thread calling `RunPool` acts as the
+ * remaining worker, so a pool of size 1 runs every task inline.
+ *
+ * @param size The total number of workers. Must be at least 1.
+ *
+ * @return Returns a pointer to the new pool, or NULL if memory allocation or
+ *         thread creation fails.
+ *
+ * @note The returned pool must be released with `FreePool`.
+ */
+pool_t* CreatePool(size_t size) {
+  pool_t* pool = calloc(1, sizeof(pool_t));
+  if (!pool) {
+    return NULL;
+  }
+
+  pool->size = size;
+  pool->workers = calloc(size, sizeof(pool_worker_t));
+  if (!pool->workers) {
+    free(pool);
+    return NULL;
+  }
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->start, NULL);
+  pthread_cond_init(&pool->done, NULL);
+
+  for (size_t i = 0; i + 1 < size; i++) {
+    pool->workers[i].pool = pool;
+    pool->workers[i].index = i + 1;
+    if (pthread_create(&pool->workers[i].thread, NULL, PoolWorkerMain,
+                       &pool->workers[i]) != 0) {
+      StopPoolWorkers(pool, i);
+      pool->size = 1;
+      FreePool(pool);
+      return NULL;
+    }
+  }
+
+  return pool;
+}
+
+/**
+ * @brief Stops the workers of a pool and frees it.
+ *
+ * @param pool The pool to free. It is safe to pass NULL.
+ */
+void FreePool(pool_t* pool) {
+  if (pool) {
+    StopPoolWorkers(pool, pool->size - 1);
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool);
+  }
+}
+
+/**
+ * @brief Runs a task on every worker of the pool.
+ *
+ * Wakes the spawned workers, runs worker 0's share on the calling thread and
+ * returns once every worker has finished, acting as a barrier between
+ * consecutive tasks. When profiling, the time between each worker finishing
+ * its share and the last one finishing is counted as waiting at the
+ * barrier.
+ *
+ * @param pool The pool to run the task on.
+ * @param task The task to run.
+ * @param arg  The argument passed to every invocation of `task`.
+ */
+void RunPool(pool_t* pool, pool_task_t task, void* arg) {
+  if (pool->size == 1) {
+    task(arg, 0, 1);
+    return;
+  }
+
+  pthread_mutex_lock(&pool->lock);
+  pool->task = task;
+  pool->arg = arg;
+  pool->pending = pool->size - 1;
+  pool->round++;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->lock);
+
+  task(arg, 0, pool->size);
+  uint64_t finished = ProfileClock();
+
+  pthread_mutex_lock(&pool->lock);
+  while (pool->pending > 0) {
+    pthread_cond_wait(&pool->done, &pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+
+  if (finished) {
+    uint64_t now = ProfileClock();
+    ProfileAdd(kPhaseWait, 0, now - finished);
+    for (size_t i = 0; i + 1 < pool->size; i++) {
+      ProfileAdd(kPhaseWait, i + 1, now - pool->workers[i].finished);
+    }
+  }
+}
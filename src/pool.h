@@ -0,0 +1,42 @@
+#ifndef POOL_H_
+#define POOL_H_
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "profile.h"
+
+// Work run by every worker of a pool: `worker` is the index of the calling
+// worker in [0, workers), where worker 0 is the thread calling `RunPool`.
+typedef void (*pool_task_t)(void* arg, size_t worker, size_t workers);
+
+typedef struct pool_t pool_t;
+
+// Persistent worker thread of a pool
+typedef struct {
+  pool_t* pool;
+  size_t index;
+  pthread_t thread;
+  uint64_t finished;  // `ProfileClock` when the worker finished its share of
+                      // the last task
+} pool_worker_t;
+
+// Fixed set of worker threads reused for every task run on the pool
+struct pool_t {
+  size_t size;             // Number of workers, including the caller
+  pool_worker_t* workers;  // The `size - 1` spawned workers
+  pthread_mutex_t lock;
+  pthread_cond_t start;
+  pthread_cond_t done;
+  size_t round;            // Incremented every time a task is started
+  size_t pending;          // Spawned workers still running the current task
+  int stop;
+  pool_task_t task;
+  void* arg;
+};
+
+pool_t* CreatePool(size_t size);
+void FreePool(pool_t* pool);
+void RunPool(pool_t* pool, pool_task_t task, void* arg);
+
+#endif  // POOL_H_
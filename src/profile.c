@@ -0,0 +1,245 @@
+/**
+ * profile.c
+ *
+ * Implements the profiler behind `--profile`, which times the phases of a
+ * run and reports where its time went once it ends. Each timed scope reads
+ * the monotonic clock when it starts and adds the time elapsed to the slot
+ * of its thread when it ends, so the cost of a scope is two clock reads,
+ * which the vDSO serves from the time stamp counter without a system call,
+ * and nothing at all while the profiler is off. Built with `make PROFILE=0`,
+ * the scopes compile to nothing.
+ *
+ * On Linux, the profiler also opens hardware counters of the cycles, the
+ * instructions and the cache misses of the whole process, when the kernel
+ * and the machine provide them.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "profile.h"
+
+#ifndef LIFE_NO_PROFILE
+
+static void OpenCounters(void);
+static void CloseCounters(void);
+static int ReadCounter(profile_counter_t counter, uint64_t* value);
+
+// Names of the phases, in the order of `profile_phase_t`
+static const char* const kPhaseNames[kProfilePhases] = {
+    "parse", "copy", "compute", "wait", "render",
+};
+
+static profiler_t profiler = {0, 0, NULL, 0, {-1, -1, -1, -1}, 0};
+
+/**
+ * @brief Starts profiling the run.
+ *
+ * @param threads The number of workers of the pool, each timed on its own.
+ *
+ * @return Returns 0 on success, -1 if memory allocation fails. Hardware
+ *         counters that cannot be opened are only reported by
+ *         `PrintProfile`.
+ *
+ * @note Profiling must be stopped with `StopProfile`.
+ */
+int StartProfile(size_t threads) {
+  profiler.slots = aligned_alloc(sizeof(profile_slot_t),
+                                 threads * sizeof(profile_slot_t));
+  if (!profiler.slots) {
+    return -1;
+  }
+  memset(profiler.slots, 0, threads * sizeof(profile_slot_t));
+  profiler.threads = threads;
+  profiler.enabled = 1;
+  OpenCounters();
+  profiler.start = ProfileClock();
+  return 0;
+}
+
+/**
+ * @brief Stops profiling and releases the slots and the counters.
+ */
+void StopProfile(void) {
+  CloseCounters();
+  free(profiler.slots);
+  profiler.slots = NULL;
+  profiler.threads = 0;
+  profiler.enabled = 0;
+}
+
+/**
+ * @brief Returns the monotonic clock in nanoseconds, or 0 while the profiler
+ *        is off, which marks the scope as not timed.
+ */
+uint64_t ProfileClock(void) {
+  if (!profiler.enabled) {
+    return 0;
+  }
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Adds time to a phase of a thread.
+ *
+ * @param phase       The phase the time was spent in.
+ * @param thread      The index of the worker, 0 for the main thread.
+ * @param nanoseconds The time spent.
+ */
+void ProfileAdd(profile_phase_t phase, size_t thread, uint64_t nanoseconds) {
+  if (!profiler.enabled || thread >= profiler.threads) {
+    return;
+  }
+  profiler.slots[thread].nanoseconds[phase] += nanoseconds;
+  profiler.slots[thread].scopes[phase]++;
+}
+
+/**
+ * @brief Ends a scope of a phase started at `begin`, as returned by
+ *        `ProfileClock`.
+ */
+void ProfileSince(profile_phase_t phase, size_t thread, uint64_t begin) {
+  if (begin) {
+    ProfileAdd(phase, thread, ProfileClock() - begin);
+  }
+}
+
+/**
+ * @brief Prints the time spent in each phase since profiling started.
+ *
+ * Each phase is reported over all threads, along with its share of the time
+ * the threads were running, the wall time times the number of threads. With
+ * more than one thread, the compute and wait time of each thread follows,
+ * which shows how evenly the bands were shared. The hardware counters, if
+ * any, come last.
+ *
+ * @param file The file to print to.
+ */
+void PrintProfile(FILE* file) {
+  if (!profiler.enabled) {
+    return;
+  }
+  double wall = (double)(ProfileClock() - profiler.start) / 1e9;
+  double capacity = wall * (double)profiler.threads;
+
+  fprintf(file, "Profile: %.6f seconds on %zu thread%s\n", wall,
+          profiler.threads, profiler.threads == 1 ? "" : "s");
+  fprintf(file, "  %-8s %12s %7s %12s\n", "phase", "seconds", "share",
+          "scopes");
+  for (size_t p = 0; p < kProfilePhases; p++) {
+    uint64_t nanoseconds = 0;
+    uint64_t scopes = 0;
+    for (size_t t = 0; t < profiler.threads; t++) {
+      nanoseconds += profiler.slots[t].nanoseconds[p];
+      scopes += profiler.slots[t].scopes[p];
+    }
+    double seconds = (double)nanoseconds / 1e9;
+    fprintf(file, "  %-8s %12.6f %6.1f%% %12llu\n", kPhaseNames[p], seconds,
+            capacity > 0 ? 100 * seconds / capacity : 0,
+            (unsigned long long)scopes);
+  }
+
+  if (profiler.threads > 1) {
+    fprintf(file, "  %-8s %12s %12s\n", "thread", "compute", "wait");
+    for (size_t t = 0; t < profiler.threads; t++) {
+      fprintf(file, "  %-8zu %12.6f %12.6f\n", t,
+              (double)profiler.slots[t].nanoseconds[kPhaseCompute] / 1e9,
+              (double)profiler.slots[t].nanoseconds[kPhaseWait] / 1e9);
+    }
+  }
+
+  uint64_t values[kProfileCounters];
+  int available = 1;
+  for (size_t c = 0; c < kProfileCounters; c++) {
+    available &= ReadCounter((profile_counter_t)c, &values[c]) == 0;
+  }
+  if (!available) {
+    fprintf(file, "  Hardware counters unavailable, '%s'\n",
+            strerror(profiler.counters_error ? profiler.counters_error
+                                             : ENOSYS));
+    return;
+  }
+  double cycles = (double)values[kCounterCycles];
+  double references = (double)values[kCounterCacheReferences];
+  fprintf(file, "  %llu cycles, %llu instructions, %.2f IPC\n",
+          (unsigned long long)values[kCounterCycles],
+          (unsigned long long)values[kCounterInstructions],
+          cycles > 0 ? (double)values[kCounterInstructions] / cycles : 0);
+  fprintf(file, "  %llu cache misses of %llu references, %.1f%%\n",
+          (unsigned long long)values[kCounterCacheMisses],
+          (unsigned long long)values[kCounterCacheReferences],
+          references > 0
+              ? 100 * (double)values[kCounterCacheMisses] / references
+              : 0);
+}
+
+/**
+ * @brief Opens the hardware counters of the process.
+ *
+ * The counters are inherited by the threads created afterwards, like the
+ * workers of the pool, which fold their counts into those of the process
+ * when they are joined. Only the user space of the process is counted, so
+ * that the counters open under the default `perf_event_paranoid` setting.
+ */
+static void OpenCounters(void) {
+#ifdef __linux__
+  static const uint64_t kEvents[kProfileCounters] = {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_REFERENCES,
+      PERF_COUNT_HW_CACHE_MISSES,
+  };
+  for (size_t c = 0; c < kProfileCounters; c++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = kEvents[c];
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    profiler.counters[c] = (int)syscall(SYS_perf_event_open, &attr, 0, -1,
+                                        -1, 0);
+    if (profiler.counters[c] < 0 && !profiler.counters_error) {
+      profiler.counters_error = errno;
+    }
+  }
+#endif
+}
+
+/**
+ * @brief Closes the hardware counters opened by `OpenCounters`.
+ */
+static void CloseCounters(void) {
+  for (size_t c = 0; c < kProfileCounters; c++) {
+#ifdef __linux__
+    if (profiler.counters[c] >= 0) {
+      close(profiler.counters[c]);
+    }
+#endif
+    profiler.counters[c] = -1;
+  }
+}
+
+/**
+ * @brief Reads the count of a hardware counter.
+ *
+ * @return Returns 0 on success, -1 if the counter is not open or cannot be
+ *         read.
+ */
+static int ReadCounter(profile_counter_t counter, uint64_t* value) {
+#ifdef __linux__
+  int fd = profiler.counters[counter];
+  if (fd >= 0 && read(fd, value, sizeof(*value)) == sizeof(*value)) {
+    return 0;
+  }
+#else
+  (void)counter;
+  (void)value;
+#endif
+  return -1;
+}
+
+#endif  // LIFE_NO_PROFILE
@@ -0,0 +1,90 @@
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Phases of a run timed by the profiler
+typedef enum {
+  kPhaseParse,    // Loading the initial world in `CreateWorld`
+  kPhaseCopy,     // Copying the halo and placing the world around the steps
+  kPhaseCompute,  // Stepping the tiles or bands of a worker
+  kPhaseWait,     // Waiting for the other workers at the end of a task
+  kPhaseRender,   // Printing or drawing a generation in `PrintWorld`
+  kProfilePhases,
+} profile_phase_t;
+
+// Hardware events counted over the whole process while profiling
+typedef enum {
+  kCounterCycles,
+  kCounterInstructions,
+  kCounterCacheReferences,
+  kCounterCacheMisses,
+  kProfileCounters,
+} profile_counter_t;
+
+// Time spent by one thread in each phase. Every thread only writes its own
+// slot, and the slots are a cache line apart so that they never share a line
+// between two threads.
+typedef struct {
+  uint64_t nanoseconds[kProfilePhases];
+  uint64_t scopes[kProfilePhases];  // Number of times the phase was entered
+} __attribute__((aligned(64))) profile_slot_t;
+
+// Process-wide state of the profiler, enabled by `StartProfile`
+typedef struct {
+  int enabled;
+  size_t threads;          // Number of slots, one per worker of the pool
+  profile_slot_t* slots;
+  uint64_t start;          // Clock when profiling started, in nanoseconds
+  int counters[kProfileCounters];  // Descriptors of the hardware counters,
+                                   // or -1 where they are not available
+  int counters_error;      // `errno` of the first counter that failed to open
+} profiler_t;
+
+#ifndef LIFE_NO_PROFILE
+int StartProfile(size_t threads);
+void StopProfile(void);
+uint64_t ProfileClock(void);
+void ProfileAdd(profile_phase_t phase, size_t thread, uint64_t nanoseconds);
+void ProfileSince(profile_phase_t phase, size_t thread, uint64_t begin);
+void PrintProfile(FILE* file);
+#else
+// Built with `make PROFILE=0`, every scope compiles to nothing
+static inline int StartProfile(size_t threads) {
+  (void)threads;
+  return -1;
+}
+static inline void StopProfile(void) {}
+static inline uint64_t ProfileClock(void) {
+  return 0;
+}
+static inline void ProfileAdd(profile_phase_t phase, size_t thread,
+                              uint64_t nanoseconds) {
+  (void)phase;
+  (void)thread;
+  (void)nanoseconds;
+}
+static inline void ProfileSince(profile_phase_t phase, size_t thread,
+                                uint64_t begin) {
+  (void)phase;
+  (void)thread;
+  (void)begin;
+}
+static inline void PrintProfile(FILE* file) {
+  (void)file;
+}
+#endif
+
+#endif  // PROFILE_H_
@@ -0,0 +1,249 @@
+/**
+ * render.c
+ *
+ * Implements the differential terminal renderer. Rather than clearing the
+ * screen and printing every cell of every generation, the renderer keeps the
+ * frame on screen and only sends the cells that changed since, so the bytes
+ * written per frame follow the activity of the pattern instead of the size
+ * of the world.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "render.h"
+
+static void AppendBytes(renderer_t* renderer, const char* bytes, size_t size);
+static void AppendMove(renderer_t* renderer, size_t line, size_t column);
+static void AppendNumber(renderer_t* renderer, size_t number);
+static void AppendFullFrame(renderer_t* renderer, const world_t* world);
+static void AppendChangedCells(renderer_t* renderer, const world_t* world);
+
+// Escape sequences moving the cursor home and clearing the screen
+static const char kClearScreen[] = "\x1b[H\x1b[2J";
+// Escape sequence clearing the rest of the line
+static const char kClearLine[] = "\x1b[K";
+static const char kFooter[] = "================================\n";
+// Longest run of unchanged cells rewritten as is rather than skipped with a
+// cursor move, which takes up to a dozen bytes
+static const size_t kMaxGap = 8;
+
+/**
+ * @brief Creates a renderer for worlds of `rows` x `cols` live cells.
+ *
+ * @param rows  The number of live rows of the worlds to draw.
+ * @param cols  The number of live columns of the worlds to draw.
+ * @param alive The character drawn for live cells.
+ * @param dead  The character drawn for dead cells.
+ *
+ * @return Returns a pointer to the new renderer on success, or NULL if memory
+ *         allocation fails or the frame is too large to be allocated.
+ *
+ * @note The returned renderer must be released with `FreeRenderer`.
+ */
+renderer_t* CreateRenderer(size_t rows, size_t cols, char alive, char dead) {
+  renderer_t* renderer = calloc(1, sizeof(renderer_t));
+  if (!renderer) {
+    return NULL;
+  }
+
+  renderer->alive = alive;
+  renderer->dead = dead;
+  renderer->shown = CreateWorldGrid(rows, cols);
+  size_t extra = sizeof(kClearScreen) + sizeof(kFooter) + 64;
+  if (!renderer->shown || rows > (SIZE_MAX - extra) / (cols + 1)) {
+    FreeRenderer(renderer);
+    return NULL;
+  }
+  renderer->capacity = rows * (cols + 1) + sizeof(kClearScreen) +
+                       sizeof(kFooter) + 64;
+  renderer->buffer = malloc(renderer->capacity);
+  if (!renderer->shown || !renderer->buffer) {
+    FreeRenderer(renderer);
+    return NULL;
+  }
+  return renderer;
+}
+
+/**
+ * @brief Frees a renderer created by `CreateRenderer`.
+ *
+ * @param renderer The renderer to free. It is safe to pass NULL.
+ */
+void FreeRenderer(renderer_t* renderer) {
+  if (renderer) {
+    FreeWorldGrid(renderer->shown);
+    free(renderer->buffer);
+    free(renderer);
+  }
+}
+
+/**
+ * @brief Draws one generation of the world on the terminal.
+ *
+ * The first frame clears the screen and draws the world in full, followed by
+ * a footer. Later frames rewrite the generation counter and the cells that
+ * differ from the previous frame, then park the cursor below the footer.
+ *
+ * @param renderer The renderer holding the frame on screen.
+ * @param world    The world to draw. It must have the dimensions given to
+ *                 `CreateRenderer`.
+ * @param gen      The generation number shown above the world.
+ *
+ * @return Returns 0 on success, -1 if the frame cannot be built or written.
+ *         The next frame is then drawn in full.
+ */
+int RenderFrame(renderer_t* renderer, const world_t* world, size_t gen) {
+  renderer->length = 0;
+  renderer->failed = 0;
+
+  if (!renderer->drawn) {
+    AppendBytes(renderer, kClearScreen, sizeof(kClearScreen) - 1);
+  } else {
+    AppendMove(renderer, 1, 1);
+  }
+
+  char header[48];
+  int size = snprintf(header, sizeof(header), "Generation %zu:%s", gen,
+                      kClearLine);
+  AppendBytes(renderer, header, (size_t)size);
+
+  if (!renderer->drawn) {
+    AppendBytes(renderer, "\n", 1);
+    AppendFullFrame(renderer, world);
+    AppendBytes(renderer, kFooter, sizeof(kFooter) - 1);
+  } else {
+    size_t start = renderer->length;
+    AppendChangedCells(renderer, world);
+    // Past the size of a full frame, rewriting every row is cheaper
+    if (renderer->length - start > world->rows * (world->cols + 1)) {
+      renderer->length = start;
+      AppendMove(renderer, 2, 1);
+      AppendFullFrame(renderer, world);
+    }
+    AppendMove(renderer, world->rows + 3, 1);
+  }
+
+  if (renderer->failed ||
+      WriteAll(STDOUT_FILENO, renderer->buffer, renderer->length) < 0) {
+    renderer->drawn = 0;
+    return -1;
+  }
+
+  CopyWorldGrid(renderer->shown, world);
+  renderer->drawn = 1;
+  return 0;
+}
+
+/**
+ * @brief Appends every row of the world to the frame.
+ */
+static void AppendFullFrame(renderer_t* renderer, const world_t* world) {
+  for (size_t i = kPadding; i <= world->rows; i++) {
+    for (size_t j = kPadding; j <= world->cols; j++) {
+      char cell = GetCell(world, i, j) ? renderer->alive : renderer->dead;
+      AppendBytes(renderer, &cell, 1);
+    }
+    AppendBytes(renderer, "\n", 1);
+  }
+}
+
+/**
+ * @brief Appends the cells that differ from the frame on screen.
+ *
+ * Compares the world with the shown frame one word at a time, so unchanged
+ * words cost a single comparison. Changed cells close to the cursor are
+ * reached by rewriting the unchanged cells in between, and the others with a
+ * cursor move.
+ */
+static void AppendChangedCells(renderer_t* renderer, const world_t* world) {
+  size_t last = LastWord(world);
+  uint64_t last_mask = LastWordMask(world);
+  size_t cursor_row = 0;
+  size_t cursor_col = 0;
+
+  for (size_t i = kPadding; i <= world->rows; i++) {
+    const uint64_t* row = WorldRow(world, i);
+    const uint64_t* shown = WorldRow(renderer->shown, i);
+    for (size_t w = 0; w <= last; w++) {
+      uint64_t diff = row[w] ^ shown[w];
+      if (w == 0) {
+        diff &= ~(uint64_t)1;
+      }
+      if (w == last) {
+        diff &= last_mask;
+      }
+
+      while (diff) {
+        size_t j = w * kWordBits + (size_t)__builtin_ctzll(diff);
+        diff &= diff - 1;
+
+        if (cursor_row != i || j < cursor_col || j - cursor_col > kMaxGap) {
+          // Cell (i, j) sits on line i + 1, below the generation counter
+          AppendMove(renderer, i + 1, j);
+          cursor_col = j;
+        }
+        for (; cursor_col <= j; cursor_col++) {
+          char cell = GetCell(world, i, cursor_col) ? renderer->alive
+                                                    : renderer->dead;
+          AppendBytes(renderer, &cell, 1);
+        }
+        cursor_row = i;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Appends an escape sequence moving the cursor to a 1-based position.
+ */
+static void AppendMove(renderer_t* renderer, size_t line, size_t column) {
+  AppendBytes(renderer, "\x1b[", 2);
+  AppendNumber(renderer, line);
+  AppendBytes(renderer, ";", 1);
+  AppendNumber(renderer, column);
+  AppendBytes(renderer, "H", 1);
+}
+
+/**
+ * @brief Appends a number in decimal, without going through `snprintf` for
+ *        every cursor move.
+ */
+static void AppendNumber(renderer_t* renderer, size_t number) {
+  char digits[24];
+  size_t size = 0;
+  do {
+    digits[sizeof(digits) - ++size] = (char)('0' + number % 10);
+    number /= 10;
+  } while (number);
+  AppendBytes(renderer, digits + sizeof(digits) - size, size);
+}
+
+/**
+ * @brief Appends bytes to the frame, growing the buffer as needed.
+ *
+ * On allocation failure, the frame is flagged as failed and the bytes are
+ * dropped.
+ */
+static void AppendBytes(renderer_t* renderer, const char* bytes, size_t size) {
+  if (renderer->failed) {
+    return;
+  }
+
+  if (renderer->length + size > renderer->capacity) {
+    size_t capacity = renderer->capacity * 2;
+    if (capacity < renderer->length + size) {
+      capacity = renderer->length + size;
+    }
+    char* buffer = realloc(renderer->buffer, capacity);
+    if (!buffer) {
+      renderer->failed = 1;
+      return;
+    }
+    renderer->buffer = buffer;
+    renderer->capacity = capacity;
+  }
+
+  memcpy(renderer->buffer + renderer->length, bytes, size);
+  renderer->length += size;
+}
@@ -0,0 +1,35 @@
+#ifndef RENDER_H_
+#define RENDER_H_
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "utils.h"
+#include "world.h"
+
+// Differential terminal renderer.
+//
+// Keeps a copy of the frame currently on screen. The first frame clears the
+// screen and draws the whole world; every later frame only rewrites the
+// generation counter and the cells that changed, placing the cursor with
+// ANSI escape sequences. Each frame is assembled in `buffer` and sent to the
+// terminal with a single `write`.
+typedef struct {
+  world_t* shown;   // Cells currently on screen
+  int drawn;        // Whether the screen holds a full frame to diff against
+  char* buffer;     // Escape sequences and cells of the frame being built
+  size_t length;    // Bytes used in `buffer`
+  size_t capacity;  // Bytes allocated for `buffer`
+  int failed;       // Whether the frame being built ran out of memory
+  char alive;       // Character drawn for live cells
+  char dead;        // Character drawn for dead cells
+} renderer_t;
+
+renderer_t* CreateRenderer(size_t rows, size_t cols, char alive, char dead);
+void FreeRenderer(renderer_t* renderer);
+int RenderFrame(renderer_t* renderer, const world_t* world, size_t gen);
+
+#endif  // RENDER_H_
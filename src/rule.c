@@ -0,0 +1,100 @@
+/**
+ * rule.c
+ *
+ * Implements the parsing and formatting of Life-like rules written in B/S
+ * notation, such as "B3/S23" for Conway's Game of Life or "B36/S23" for
+ * HighLife.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "rule.h"
+
+static const char* ParseCounts(const char* text, uint16_t* mask);
+
+/**
+ * @brief Parses a rule written in B/S notation.
+ *
+ * Accepts "Bxx/Syy" and "Syy/Bxx", with either letter case, as well as the
+ * older "yy/xx" notation listing the survival counts first. Each count is a
+ * single digit from 0 to 8, and either list may be empty.
+ *
+ * @param text The rule to parse.
+ * @param rule The rule receiving the birth and survival masks.
+ *
+ * @return Returns 0 on success, -1 if `text` is not a valid rule. `rule` is
+ *         left untouched on failure.
+ */
+int ParseRule(const char* text, rule_t* rule) {
+  rule_t parsed = {0, 0};
+  uint16_t* masks[2] = {&parsed.survive, &parsed.birth};
+
+  if (isalpha((unsigned char)text[0])) {
+    char first = (char)toupper((unsigned char)text[0]);
+    if (first != 'B' && first != 'S') {
+      return -1;
+    }
+    char second = first == 'B' ? 'S' : 'B';
+    masks[0] = first == 'B' ? &parsed.birth : &parsed.survive;
+    masks[1] = first == 'B' ? &parsed.survive : &parsed.birth;
+
+    text = ParseCounts(text + 1, masks[0]);
+    if (!text || text[0] != '/' ||
+        toupper((unsigned char)text[1]) != second) {
+      return -1;
+    }
+    text = ParseCounts(text + 2, masks[1]);
+  } else {
+    text = ParseCounts(text, masks[0]);
+    if (!text || text[0] != '/') {
+      return -1;
+    }
+    text = ParseCounts(text + 1, masks[1]);
+  }
+
+  if (!text || *text != '\0') {
+    return -1;
+  }
+  *rule = parsed;
+  return 0;
+}
+
+/**
+ * @brief Writes a rule in B/S notation, such as "B3/S23".
+ *
+ * @param rule The rule to write.
+ * @param text The buffer receiving the rule, at least `kRuleTextSize` bytes
+ *             long.
+ */
+void FormatRule(const rule_t* rule, char* text) {
+  const uint16_t masks[2] = {rule->birth, rule->survive};
+  for (int part = 0; part < 2; part++) {
+    *text++ = part == 0 ? 'B' : 'S';
+    for (int n = 0; n <= 8; n++) {
+      if ((masks[part] >> n) & 1) {
+        *text++ = (char)('0' + n);
+      }
+    }
+    *text++ = part == 0 ? '/' : '\0';
+  }
+}
+
+/**
+ * @brief Parses a list of neighbour counts into a mask.
+ *
+ * @param text The list of digits to parse.
+ * @param mask The mask receiving one bit per count.
+ *
+ * @return Returns a pointer past the last digit, or NULL if a digit is out of
+ *         range.
+ */
+static const char* ParseCounts(const char* text, uint16_t* mask) {
+  for (; isdigit((unsigned char)*text); text++) {
+    if (*text > '8') {
+      return NULL;
+    }
+    *mask |= (uint16_t)(1 << (*text - '0'));
+  }
+  return text;
+}
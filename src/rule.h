@@ -0,0 +1,94 @@
+#ifndef RULE_H_
+#define RULE_H_
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Life-like rule in B/S notation.
+//
+// Bit `n` of `birth` is set if a dead cell with `n` live neighbours comes to
+// life, and bit `n` of `survive` if a live cell with `n` live neighbours stays
+// alive. Both masks double as lookup tables indexed by the neighbour count.
+typedef struct {
+  uint16_t birth;
+  uint16_t survive;
+} rule_t;
+
+enum {
+  kConwayBirth = 0x008,       // B3/S23
+  kConwaySurvive = 0x00C,
+  kHighLifeBirth = 0x048,     // B36/S23
+  kHighLifeSurvive = 0x00C,
+  kSeedsBirth = 0x004,        // B2/S
+  kSeedsSurvive = 0x000,
+  kDayAndNightBirth = 0x1C8,  // B3678/S34678
+  kDayAndNightSurvive = 0x1D8,
+};
+
+static const rule_t kConwayRule = {kConwayBirth, kConwaySurvive};
+
+// Size of a buffer able to hold any rule written by `FormatRule`
+enum { kRuleTextSize = 24 };
+
+// Rules given their own copy of each word-parallel kernel, with the masks
+// folded in at compile time. Expands to X(birth, survive, ...) for each of
+// them, passing the extra arguments through.
+#define LIFE_SPECIALIZED_RULES(X, ...)                       \
+  X(kConwayBirth, kConwaySurvive, __VA_ARGS__)               \
+  X(kHighLifeBirth, kHighLifeSurvive, __VA_ARGS__)           \
+  X(kSeedsBirth, kSeedsSurvive, __VA_ARGS__)                 \
+  X(kDayAndNightBirth, kDayAndNightSurvive, __VA_ARGS__)
+
+int ParseRule(const char* text, rule_t* rule);
+void FormatRule(const rule_t* rule, char* text);
+
+/**
+ * @brief Returns the next state of a cell from the lookup tables of a rule.
+ */
+static inline int NextCellState(const rule_t* rule, int alive,
+                                int neighbor_count) {
+  return ((alive ? rule->survive : rule->birth) >> neighbor_count) & 1;
+}
+
+// Defines `NAME`, which applies a rule to a vector of cells of type `TYPE`.
+//
+// `c` holds the cells themselves. `ones` and `twos` hold the two low bits of
+// the neighbour count of every cell, `fours` flags the counts of at least 4
+// and `eights` the count of 8. `TYPE` may be any integer or vector type
+// supporting the bitwise operators. When `birth` and `survive` are
+// compile-time constants, the loop over the counts unrolls and only the terms
+// of the counts used by the rule are left. Conway's rule keeps its shorter
+// form either way.
+#define LIFE_DEFINE_APPLY_RULE(NAME, TYPE, ATTRIBUTES)                       \
+  ATTRIBUTES static inline TYPE NAME(TYPE c, TYPE ones, TYPE twos,           \
+                                     TYPE fours, TYPE eights,                \
+                                     unsigned birth, unsigned survive) {     \
+    if (birth == kConwayBirth && survive == kConwaySurvive) {                \
+      return twos & ~fours & (ones | c);                                     \
+    }                                                                        \
+    TYPE exact_fours = fours & ~eights;                                      \
+    TYPE next = c ^ c;                                                       \
+    _Pragma("GCC unroll 9")                                                  \
+    for (unsigned n = 0; n <= 8; n++) {                                      \
+      unsigned born = (birth >> n) & 1;                                      \
+      unsigned kept = (survive >> n) & 1;                                    \
+      if (!born && !kept) {                                                  \
+        continue;                                                            \
+      }                                                                      \
+      TYPE match = ~(c ^ c);                                                 \
+      match &= (n & 1) ? ones : ~(ones);                                     \
+      match &= (n & 2) ? twos : ~(twos);                                     \
+      match &= (n & 4) ? exact_fours : ~(exact_fours);                       \
+      match &= (n & 8) ? eights : ~(eights);                                 \
+      if (!kept) {                                                           \
+        match &= ~c;                                                         \
+      } else if (!born) {                                                    \
+        match &= c;                                                          \
+      }                                                                      \
+      next |= match;                                                         \
+    }                                                                        \
+    return next;                                                             \
+  }
+
+#endif  // RULE_H_
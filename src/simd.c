@@ -0,0 +1,346 @@
+/**
+ * simd.c
+ *
+ * Implements the vectorized generation engines. Each of them mirrors the SWAR
+ * engine, but applies the full-adder logic to several 64-bit words at once:
+ * four with AVX2, eight with AVX-512 and two with NEON. The engines are only
+ * built for the architectures providing those instructions and are compiled
+ * with per-function target attributes, so a single binary can hold all of
+ * them and pick one at runtime.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "engine.h"
+
+#ifdef LIFE_HAVE_X86_SIMD
+#include <immintrin.h>
+
+/**
+ * @brief Reports whether the CPU supports AVX2.
+ */
+int HasAvx2(void) {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+
+/**
+ * @brief Reports whether the CPU supports the AVX-512 foundation.
+ */
+int HasAvx512(void) {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx512f");
+}
+
+/**
+ * @brief Reports whether the CPU counts the bits of a word in a single
+ *        instruction.
+ */
+int HasPopcount(void) {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("popcnt");
+}
+
+/**
+ * @brief AVX2 counterpart of `SwarCountNeighbors`, counting four words at
+ *        once.
+ */
+__attribute__((target("avx2")))
+static inline void Avx2CountNeighbors(__m256i nw, __m256i n, __m256i ne,
+                                      __m256i w, __m256i e, __m256i sw,
+                                      __m256i s, __m256i se, __m256i* ones,
+                                      __m256i* twos, __m256i* fours,
+                                      __m256i* eights) {
+  __m256i above_ones = _mm256_xor_si256(_mm256_xor_si256(nw, n), ne);
+  __m256i above_twos = _mm256_or_si256(
+      _mm256_and_si256(nw, n), _mm256_and_si256(ne, _mm256_xor_si256(nw, n)));
+  __m256i below_ones = _mm256_xor_si256(_mm256_xor_si256(sw, s), se);
+  __m256i below_twos = _mm256_or_si256(
+      _mm256_and_si256(sw, s), _mm256_and_si256(se, _mm256_xor_si256(sw, s)));
+  __m256i mid_ones = _mm256_xor_si256(w, e);
+  __m256i mid_twos = _mm256_and_si256(w, e);
+
+  __m256i outer_ones = _mm256_xor_si256(above_ones, below_ones);
+  *ones = _mm256_xor_si256(outer_ones, mid_ones);
+  __m256i carry = _mm256_or_si256(_mm256_and_si256(above_ones, below_ones),
+                                  _mm256_and_si256(mid_ones, outer_ones));
+
+  __m256i outer_twos = _mm256_xor_si256(above_twos, below_twos);
+  __m256i partial = _mm256_xor_si256(outer_twos, mid_twos);
+  __m256i majority = _mm256_or_si256(_mm256_and_si256(above_twos, below_twos),
+                                     _mm256_and_si256(mid_twos, outer_twos));
+  __m256i overflow = _mm256_and_si256(partial, carry);
+  *twos = _mm256_xor_si256(partial, carry);
+  *fours = _mm256_or_si256(majority, overflow);
+  *eights = _mm256_and_si256(majority, overflow);
+}
+
+LIFE_DEFINE_APPLY_RULE(Avx2ApplyRule, __m256i,
+                       __attribute__((target("avx2"), always_inline)))
+
+/**
+ * @brief Loads the west, centre and east neighbour words of `p[0..3]`.
+ */
+__attribute__((target("avx2")))
+static inline void Avx2LoadRow(const uint64_t* p, __m256i* w, __m256i* c,
+                               __m256i* e) {
+  __m256i prev = _mm256_loadu_si256((const __m256i*)(p - 1));
+  __m256i next = _mm256_loadu_si256((const __m256i*)(p + 1));
+  *c = _mm256_loadu_si256((const __m256i*)p);
+  *w = _mm256_or_si256(_mm256_slli_epi64(*c, 1), _mm256_srli_epi64(prev, 63));
+  *e = _mm256_or_si256(_mm256_srli_epi64(*c, 1), _mm256_slli_epi64(next, 63));
+}
+
+/**
+ * @brief Advances a region of the world four words at a time with AVX2.
+ *
+ * @param src     The world holding the current generation.
+ * @param dst     The world receiving the next generation.
+ * @param region  The region of the world to compute.
+ * @param birth   The birth mask of the rule.
+ * @param survive The survival mask of the rule.
+ */
+__attribute__((target("avx2"), always_inline))
+static inline void StepAvx2Rule(const world_t* src, world_t* dst,
+                                const region_t* region, unsigned birth,
+                                unsigned survive) {
+  for (size_t i = region->row_begin; i < region->row_end; i++) {
+    const uint64_t* up = WorldRow(src, i - 1);
+    const uint64_t* mid = WorldRow(src, i);
+    const uint64_t* down = WorldRow(src, i + 1);
+    uint64_t* out = WorldRow(dst, i);
+
+    size_t k = region->word_begin;
+    for (; k + 4 <= region->word_end; k += 4) {
+      __m256i nw, n, ne, w, c, e, sw, s, se, ones, twos, fours, eights;
+      Avx2LoadRow(&up[k], &nw, &n, &ne);
+      Avx2LoadRow(&mid[k], &w, &c, &e);
+      Avx2LoadRow(&down[k], &sw, &s, &se);
+      Avx2CountNeighbors(nw, n, ne, w, e, sw, s, se, &ones, &twos,
+                         &fours, &eights);
+      _mm256_storeu_si256((__m256i*)&out[k],
+                          Avx2ApplyRule(c, ones, twos, fours, eights,
+                                        birth, survive));
+    }
+    for (; k < region->word_end; k++) {
+      out[k] = SwarStepWord(&up[k], &mid[k], &down[k], birth, survive);
+    }
+    ClearPaddingColumns(src, out, region);
+  }
+}
+
+/**
+ * @brief Advances a region of the world with AVX2, with a copy of the kernel
+ *        specialized for each of the common rules.
+ */
+__attribute__((target("avx2")))
+void StepAvx2(const world_t* src, world_t* dst, const region_t* region,
+              const rule_t* rule) {
+  LIFE_STEP_RULE(StepAvx2Rule, src, dst, region, rule);
+}
+
+// Truth tables for `_mm512_ternarylogic_epi64`
+#define kTernaryXor 0x96
+#define kTernaryMajority 0xE8
+
+/**
+ * @brief AVX-512 counterpart of `SwarCountNeighbors`, counting eight words at
+ *        once.
+ */
+__attribute__((target("avx512f")))
+static inline void Avx512CountNeighbors(__m512i nw, __m512i n, __m512i ne,
+                                        __m512i w, __m512i e, __m512i sw,
+                                        __m512i s, __m512i se, __m512i* ones,
+                                        __m512i* twos, __m512i* fours,
+                                        __m512i* eights) {
+  __m512i above_ones = _mm512_ternarylogic_epi64(nw, n, ne, kTernaryXor);
+  __m512i above_twos = _mm512_ternarylogic_epi64(nw, n, ne, kTernaryMajority);
+  __m512i below_ones = _mm512_ternarylogic_epi64(sw, s, se, kTernaryXor);
+  __m512i below_twos = _mm512_ternarylogic_epi64(sw, s, se, kTernaryMajority);
+  __m512i mid_ones = _mm512_xor_si512(w, e);
+  __m512i mid_twos = _mm512_and_si512(w, e);
+
+  *ones = _mm512_ternarylogic_epi64(above_ones, below_ones, mid_ones,
+                                    kTernaryXor);
+  __m512i carry = _mm512_ternarylogic_epi64(above_ones, below_ones, mid_ones,
+                                            kTernaryMajority);
+
+  __m512i partial = _mm512_ternarylogic_epi64(above_twos, below_twos,
+                                              mid_twos, kTernaryXor);
+  __m512i majority = _mm512_ternarylogic_epi64(above_twos, below_twos,
+                                               mid_twos, kTernaryMajority);
+  __m512i overflow = _mm512_and_si512(partial, carry);
+  *twos = _mm512_xor_si512(partial, carry);
+  *fours = _mm512_or_si512(majority, overflow);
+  *eights = _mm512_and_si512(majority, overflow);
+}
+
+LIFE_DEFINE_APPLY_RULE(Avx512ApplyRule, __m512i,
+                       __attribute__((target("avx512f"), always_inline)))
+
+/**
+ * @brief Loads the west, centre and east neighbour words of `p[0..7]`.
+ */
+__attribute__((target("avx512f")))
+static inline void Avx512LoadRow(const uint64_t* p, __m512i* w, __m512i* c,
+                                 __m512i* e) {
+  __m512i prev = _mm512_loadu_si512((const void*)(p - 1));
+  __m512i next = _mm512_loadu_si512((const void*)(p + 1));
+  *c = _mm512_loadu_si512((const void*)p);
+  *w = _mm512_or_si512(_mm512_slli_epi64(*c, 1), _mm512_srli_epi64(prev, 63));
+  *e = _mm512_or_si512(_mm512_srli_epi64(*c, 1), _mm512_slli_epi64(next, 63));
+}
+
+/**
+ * @brief Advances a region of the world eight words at a time with AVX-512.
+ *
+ * @param src     The world holding the current generation.
+ * @param dst     The world receiving the next generation.
+ * @param region  The region of the world to compute.
+ * @param birth   The birth mask of the rule.
+ * @param survive The survival mask of the rule.
+ */
+__attribute__((target("avx512f"), always_inline))
+static inline void StepAvx512Rule(const world_t* src, world_t* dst,
+                                  const region_t* region, unsigned birth,
+                                  unsigned survive) {
+  for (size_t i = region->row_begin; i < region->row_end; i++) {
+    const uint64_t* up = WorldRow(src, i - 1);
+    const uint64_t* mid = WorldRow(src, i);
+    const uint64_t* down = WorldRow(src, i + 1);
+    uint64_t* out = WorldRow(dst, i);
+
+    size_t k = region->word_begin;
+    for (; k + 8 <= region->word_end; k += 8) {
+      __m512i nw, n, ne, w, c, e, sw, s, se, ones, twos, fours, eights;
+      Avx512LoadRow(&up[k], &nw, &n, &ne);
+      Avx512LoadRow(&mid[k], &w, &c, &e);
+      Avx512LoadRow(&down[k], &sw, &s, &se);
+      Avx512CountNeighbors(nw, n, ne, w, e, sw, s, se, &ones, &twos,
+                           &fours, &eights);
+      _mm512_storeu_si512((void*)&out[k],
+                          Avx512ApplyRule(c, ones, twos, fours, eights,
+                                          birth, survive));
+    }
+    for (; k < region->word_end; k++) {
+      out[k] = SwarStepWord(&up[k], &mid[k], &down[k], birth, survive);
+    }
+    ClearPaddingColumns(src, out, region);
+  }
+}
+
+/**
+ * @brief Advances a region of the world with AVX-512, with a copy of the
+ *        kernel specialized for each of the common rules.
+ */
+__attribute__((target("avx512f")))
+void StepAvx512(const world_t* src, world_t* dst, const region_t* region,
+                const rule_t* rule) {
+  LIFE_STEP_RULE(StepAvx512Rule, src, dst, region, rule);
+}
+#endif  // LIFE_HAVE_X86_SIMD
+
+#ifdef LIFE_HAVE_NEON
+#include <arm_neon.h>
+
+/**
+ * @brief NEON counterpart of `SwarCountNeighbors`, counting two words at
+ *        once.
+ */
+static inline void NeonCountNeighbors(uint64x2_t nw, uint64x2_t n,
+                                      uint64x2_t ne, uint64x2_t w,
+                                      uint64x2_t e, uint64x2_t sw,
+                                      uint64x2_t s, uint64x2_t se,
+                                      uint64x2_t* ones, uint64x2_t* twos,
+                                      uint64x2_t* fours, uint64x2_t* eights) {
+  uint64x2_t above_ones = veorq_u64(veorq_u64(nw, n), ne);
+  uint64x2_t above_twos = vorrq_u64(vandq_u64(nw, n),
+                                    vandq_u64(ne, veorq_u64(nw, n)));
+  uint64x2_t below_ones = veorq_u64(veorq_u64(sw, s), se);
+  uint64x2_t below_twos = vorrq_u64(vandq_u64(sw, s),
+                                    vandq_u64(se, veorq_u64(sw, s)));
+  uint64x2_t mid_ones = veorq_u64(w, e);
+  uint64x2_t mid_twos = vandq_u64(w, e);
+
+  uint64x2_t outer_ones = veorq_u64(above_ones, below_ones);
+  *ones = veorq_u64(outer_ones, mid_ones);
+  uint64x2_t carry = vorrq_u64(vandq_u64(above_ones, below_ones),
+                               vandq_u64(mid_ones, outer_ones));
+
+  uint64x2_t outer_twos = veorq_u64(above_twos, below_twos);
+  uint64x2_t partial = veorq_u64(outer_twos, mid_twos);
+  uint64x2_t majority = vorrq_u64(vandq_u64(above_twos, below_twos),
+                                  vandq_u64(mid_twos, outer_twos));
+  uint64x2_t overflow = vandq_u64(partial, carry);
+  *twos = veorq_u64(partial, carry);
+  *fours = vorrq_u64(majority, overflow);
+  *eights = vandq_u64(majority, overflow);
+}
+
+LIFE_DEFINE_APPLY_RULE(NeonApplyRule, uint64x2_t,
+                       __attribute__((always_inline)))
+
+/**
+ * @brief Loads the west, centre and east neighbour words of `p[0..1]`.
+ */
+static inline void NeonLoadRow(const uint64_t* p, uint64x2_t* w,
+                               uint64x2_t* c, uint64x2_t* e) {
+  uint64x2_t prev = vld1q_u64(p - 1);
+  uint64x2_t next = vld1q_u64(p + 1);
+  *c = vld1q_u64(p);
+  *w = vorrq_u64(vshlq_n_u64(*c, 1), vshrq_n_u64(prev, 63));
+  *e = vorrq_u64(vshrq_n_u64(*c, 1), vshlq_n_u64(next, 63));
+}
+
+/**
+ * @brief Reports whether the CPU supports NEON, which AArch64 guarantees.
+ */
+int HasNeon(void) { return 1; }
+
+/**
+ * @brief Advances a region of the world two words at a time with NEON.
+ *
+ * @param src     The world holding the current generation.
+ * @param dst     The world receiving the next generation.
+ * @param region  The region of the world to compute.
+ * @param birth   The birth mask of the rule.
+ * @param survive The survival mask of the rule.
+ */
+__attribute__((always_inline))
+static inline void StepNeonRule(const world_t* src, world_t* dst,
+                                const region_t* region, unsigned birth,
+                                unsigned survive) {
+  for (size_t i = region->row_begin; i < region->row_end; i++) {
+    const uint64_t* up = WorldRow(src, i - 1);
+    const uint64_t* mid = WorldRow(src, i);
+    const uint64_t* down = WorldRow(src, i + 1);
+    uint64_t* out = WorldRow(dst, i);
+
+    size_t k = region->word_begin;
+    for (; k + 2 <= region->word_end; k += 2) {
+      uint64x2_t nw, n, ne, w, c, e, sw, s, se, ones, twos, fours, eights;
+      NeonLoadRow(&up[k], &nw, &n, &ne);
+      NeonLoadRow(&mid[k], &w, &c, &e);
+      NeonLoadRow(&down[k], &sw, &s, &se);
+      NeonCountNeighbors(nw, n, ne, w, e, sw, s, se, &ones, &twos,
+                         &fours, &eights);
+      vst1q_u64(&out[k], NeonApplyRule(c, ones, twos, fours, eights,
+                                       birth, survive));
+    }
+    for (; k < region->word_end; k++) {
+      out[k] = SwarStepWord(&up[k], &mid[k], &down[k], birth, survive);
+    }
+    ClearPaddingColumns(src, out, region);
+  }
+}
+
+/**
+ * @brief Advances a region of the world with NEON, with a copy of the kernel
+ *        specialized for each of the common rules.
+ */
+void StepNeon(const world_t* src, world_t* dst, const region_t* region,
+              const rule_t* rule) {
+  LIFE_STEP_RULE(StepNeonRule, src, dst, region, rule);
+}
+#endif  // LIFE_HAVE_NEON
@@ -0,0 +1,364 @@
+/**
+ * stream.c
+ *
+ * Implements the streaming of generations to a file or a pipe, for tools
+ * that post-process a run offline. Frames are packed a word at a time and
+ * sent as deltas against the previous frame, through a large buffer that is
+ * optionally compressed with zstd before it reaches the descriptor.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "stream.h"
+
+static int AppendBytes(stream_t* stream, const void* data, size_t size);
+static int FlushStream(stream_t* stream, int end);
+static int EmitBytes(stream_t* stream, const void* data, size_t size);
+static size_t EncodeDelta(stream_t* stream);
+static size_t PutVarint(unsigned char* bytes, uint64_t value);
+static void PutUint64(unsigned char* bytes, uint64_t value);
+static void FreeStream(stream_t* stream);
+
+/**
+ * @brief Returns whether a file name asks for a zstd-compressed stream.
+ */
+static int IsZstdStream(const char* filename) {
+  const char* extension = strrchr(filename, '.');
+  return extension && strcasecmp(extension, kZstdExtension) == 0;
+}
+
+/**
+ * @brief Creates a stream and writes its header.
+ *
+ * @param filename The file to write, replaced if it exists, or
+ *                 `kStandardStream` for the standard output.
+ * @param rows     The number of live rows of the world.
+ * @param cols     The number of live columns of the world.
+ * @param rule     The rule of the game, recorded in the header.
+ * @param every    The generations between two frames, or 0 to write the
+ *                 last generation only.
+ *
+ * @return Returns a pointer to the new stream, or NULL if the file cannot be
+ *         opened, compression is not available or memory allocation fails.
+ *         An error message is printed unless memory allocation failed.
+ *
+ * @note The returned stream must be released with `CloseStream`.
+ */
+stream_t* CreateStream(const char* filename, size_t rows, size_t cols,
+                       const rule_t* rule, size_t every) {
+#ifndef LIFE_HAVE_ZSTD
+  if (IsZstdStream(filename)) {
+    fprintf(stderr, "Error: zstd compression is not available, rebuild with "
+                    "'make ZSTD=1', '%s'\n", filename);
+    return NULL;
+  }
+#endif
+
+  stream_t* stream = calloc(1, sizeof(stream_t));
+  if (!stream) {
+    return NULL;
+  }
+  stream->fd = -1;
+  stream->filename = filename;
+  stream->every = every;
+  stream->frame_bytes = rows * ((cols + 7) / 8);
+  stream->blocks = (stream->frame_bytes + 7) / 8;
+  stream->current = calloc(stream->blocks, 8);
+  stream->previous = calloc(stream->blocks, 8);
+  stream->delta = malloc(stream->frame_bytes);
+  stream->buffer = malloc(kStreamBufferSize);
+  if (!stream->current || !stream->previous || !stream->delta ||
+      !stream->buffer) {
+    FreeStream(stream);
+    return NULL;
+  }
+
+#ifdef LIFE_HAVE_ZSTD
+  if (IsZstdStream(filename)) {
+    stream->zstd = ZSTD_createCCtx();
+    stream->packed_size = ZSTD_CStreamOutSize();
+    stream->packed = malloc(stream->packed_size);
+    if (!stream->zstd || !stream->packed) {
+      FreeStream(stream);
+      return NULL;
+    }
+  }
+#endif
+
+  if (strcmp(filename, kStandardStream) == 0) {
+    stream->fd = STDOUT_FILENO;
+  } else {
+    stream->fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (stream->fd < 0) {
+      fprintf(stderr, "Error: Failed to open file for writing, '%s'\n",
+              filename);
+      FreeStream(stream);
+      return NULL;
+    }
+  }
+
+  unsigned char header[kBinaryHeaderSize];
+  PackBinaryHeader(header, kStreamMagic, rows, cols, rule);
+  AppendBytes(stream, header, sizeof(header));
+  return stream;
+}
+
+/**
+ * @brief Flushes the frames left in the buffer, closes the stream and frees
+ *        it.
+ *
+ * @param stream The stream to close. It is safe to pass NULL.
+ *
+ * @return Returns 0 on success, -1 if any write to the stream failed, in
+ *         which case an error message is printed.
+ */
+int CloseStream(stream_t* stream) {
+  if (!stream) {
+    return 0;
+  }
+
+  FlushStream(stream, 1);
+  if (stream->fd != STDOUT_FILENO && close(stream->fd) != 0) {
+    stream->failed = 1;
+  }
+  stream->fd = -1;
+
+  int failed = stream->failed;
+  if (failed) {
+    fprintf(stderr, "Error: Failed to write file, '%s'\n", stream->filename);
+  }
+  FreeStream(stream);
+  return failed ? -1 : 0;
+}
+
+/**
+ * @brief Returns whether generation `gen` is written to the stream: every
+ *        `every`-th generation, counted from generation 0, and the last one.
+ */
+int StreamsGeneration(const stream_t* stream, size_t gen, int last) {
+  return last || (stream->every && gen % stream->every == 0);
+}
+
+/**
+ * @brief Writes a generation to the stream, if it is one of those selected
+ *        by `StreamsGeneration`.
+ *
+ * @param stream The stream to write to.
+ * @param world  The generation to write.
+ * @param gen    The generation number of `world`.
+ * @param last   Whether `world` is the last generation of the game.
+ *
+ * @return Returns 0 on success or if the generation is skipped, -1 if a
+ *         write to the stream failed.
+ */
+int WriteFrame(stream_t* stream, const world_t* world, size_t gen, int last) {
+  if (!StreamsGeneration(stream, gen, last)) {
+    return 0;
+  }
+
+  size_t row_bytes = (world->cols + 7) / 8;
+  for (size_t i = kPadding; i <= world->rows; i++) {
+    PackBinaryRow(WorldRow(world, i), world->cols,
+                  stream->current + (i - kPadding) * row_bytes);
+  }
+
+  // A delta too large to pay off is replaced with a keyframe
+  size_t size = 0;
+  int kind = kFrameKey;
+  if (stream->frames % kKeyframeInterval != 0) {
+    size = EncodeDelta(stream);
+    kind = size <= stream->frame_bytes ? kFrameDelta : kFrameKey;
+  }
+  const unsigned char* payload = stream->current;
+  if (kind == kFrameDelta) {
+    payload = stream->delta;
+  } else {
+    size = stream->frame_bytes;
+  }
+
+  unsigned char header[kFrameHeaderSize];
+  header[0] = (unsigned char)kind;
+  PutUint64(header + 1, gen);
+  PutUint64(header + 9, size);
+  AppendBytes(stream, header, sizeof(header));
+  AppendBytes(stream, payload, size);
+
+  unsigned char* written = stream->previous;
+  stream->previous = stream->current;
+  stream->current = written;
+  stream->frames++;
+  return stream->failed ? -1 : 0;
+}
+
+/**
+ * @brief Encodes the changes from the previous frame to the current one into
+ *        `stream->delta`.
+ *
+ * @return Returns the size of the delta, or `stream->frame_bytes + 1` if it
+ *         would be larger than a keyframe.
+ */
+static size_t EncodeDelta(stream_t* stream) {
+  size_t size = 0;
+  size_t end = 0;  // Block following the last record
+  size_t b = 0;
+  while (b < stream->blocks) {
+    uint64_t now, before;
+    memcpy(&now, stream->current + 8 * b, sizeof(now));
+    memcpy(&before, stream->previous + 8 * b, sizeof(before));
+    if (now == before) {
+      b++;
+      continue;
+    }
+
+    size_t start = b;
+    while (b < stream->blocks) {
+      memcpy(&now, stream->current + 8 * b, sizeof(now));
+      memcpy(&before, stream->previous + 8 * b, sizeof(before));
+      if (now == before) {
+        break;
+      }
+      b++;
+    }
+
+    // Two LEB128 integers of 64 bits take at most 20 bytes
+    size_t count = b - start;
+    if (size + 20 + 8 * count > stream->frame_bytes) {
+      return stream->frame_bytes + 1;
+    }
+    size += PutVarint(stream->delta + size, start - end);
+    size += PutVarint(stream->delta + size, count);
+    for (size_t k = start; k < b; k++) {
+      memcpy(&now, stream->current + 8 * k, sizeof(now));
+      memcpy(&before, stream->previous + 8 * k, sizeof(before));
+      uint64_t change = now ^ before;
+      memcpy(stream->delta + size, &change, sizeof(change));
+      size += sizeof(change);
+    }
+    end = b;
+  }
+  return size;
+}
+
+/**
+ * @brief Appends bytes to the buffer of the stream, flushing it first if
+ *        they do not fit. Payloads as large as the buffer bypass it.
+ *
+ * @return Returns 0 on success, -1 if a write failed.
+ */
+static int AppendBytes(stream_t* stream, const void* data, size_t size) {
+  if (stream->length + size > kStreamBufferSize) {
+    FlushStream(stream, 0);
+  }
+  if (size >= kStreamBufferSize) {
+    EmitBytes(stream, data, size);
+  } else {
+    memcpy(stream->buffer + stream->length, data, size);
+    stream->length += size;
+  }
+  return stream->failed ? -1 : 0;
+}
+
+/**
+ * @brief Sends the buffer of the stream on, and ends the compressed frame
+ *        of a zstd stream if `end` is set.
+ */
+static int FlushStream(stream_t* stream, int end) {
+  EmitBytes(stream, stream->buffer, stream->length);
+  stream->length = 0;
+
+#ifdef LIFE_HAVE_ZSTD
+  if (end && stream->zstd && !stream->failed) {
+    size_t remaining;
+    do {
+      ZSTD_inBuffer in = {NULL, 0, 0};
+      ZSTD_outBuffer out = {stream->packed, stream->packed_size, 0};
+      remaining = ZSTD_compressStream2(stream->zstd, &out, &in, ZSTD_e_end);
+      if (ZSTD_isError(remaining) ||
+          WriteAll(stream->fd, out.dst, out.pos) < 0) {
+        stream->failed = 1;
+        break;
+      }
+    } while (remaining > 0);
+  }
+#else
+  (void)end;
+#endif
+  return stream->failed ? -1 : 0;
+}
+
+/**
+ * @brief Writes bytes to the descriptor of the stream, through the
+ *        compressor for a zstd stream. A failed stream discards them.
+ */
+static int EmitBytes(stream_t* stream, const void* data, size_t size) {
+  if (stream->failed || size == 0) {
+    return stream->failed ? -1 : 0;
+  }
+
+#ifdef LIFE_HAVE_ZSTD
+  if (stream->zstd) {
+    ZSTD_inBuffer in = {data, size, 0};
+    while (in.pos < in.size) {
+      ZSTD_outBuffer out = {stream->packed, stream->packed_size, 0};
+      size_t status = ZSTD_compressStream2(stream->zstd, &out, &in,
+                                           ZSTD_e_continue);
+      if (ZSTD_isError(status) ||
+          WriteAll(stream->fd, out.dst, out.pos) < 0) {
+        stream->failed = 1;
+        return -1;
+      }
+    }
+    return 0;
+  }
+#endif
+
+  if (WriteAll(stream->fd, data, size) < 0) {
+    stream->failed = 1;
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Writes `value` as a little-endian LEB128 integer.
+ *
+ * @return Returns the number of bytes written, at most 10.
+ */
+static size_t PutVarint(unsigned char* bytes, uint64_t value) {
+  size_t size = 0;
+  while (value >= 0x80) {
+    bytes[size++] = (unsigned char)(value | 0x80);
+    value >>= 7;
+  }
+  bytes[size++] = (unsigned char)value;
+  return size;
+}
+
+/**
+ * @brief Writes `value` as a 64-bit little-endian integer.
+ */
+static void PutUint64(unsigned char* bytes, uint64_t value) {
+  for (size_t b = 0; b < 8; b++) {
+    bytes[b] = (unsigned char)(value >> (8 * b));
+  }
+}
+
+/**
+ * @brief Frees a stream and its buffers, closing its descriptor unless it is
+ *        the standard output.
+ */
+static void FreeStream(stream_t* stream) {
+  if (stream->fd >= 0 && stream->fd != STDOUT_FILENO) {
+    close(stream->fd);
+  }
+#ifdef LIFE_HAVE_ZSTD
+  ZSTD_freeCCtx(stream->zstd);
+  free(stream->packed);
+#endif
+  free(stream->buffer);
+  free(stream->delta);
+  free(stream->previous);
+  free(stream->current);
+  free(stream);
+}
@@ -0,0 +1,82 @@
+#ifndef STREAM_H_
+#define STREAM_H_
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+#ifdef LIFE_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "loader.h"
+#include "rule.h"
+#include "utils.h"
+#include "world.h"
+#include "writer.h"
+
+// Stream of generations written to a file or a pipe.
+//
+// A stream starts with a header laid out like the one of a binary pattern
+// (see loader.h), with the magic `kStreamMagic`. Each frame follows as a
+// `kFrameHeaderSize`-byte header, made of a kind byte, the generation number
+// and the size of the payload as 64-bit little-endian integers, then the
+// payload:
+//
+//   - A keyframe (`kFrameKey`) holds the cells bit-packed like the rows of a
+//     binary pattern, `(cols + 7) / 8` bytes per row, row after row.
+//   - A delta frame (`kFrameDelta`) holds the changes since the previous
+//     frame. The packed cells are seen as a sequence of 8-byte blocks, the
+//     last one zero-filled, and the payload is a list of records, each made
+//     of the number of unchanged blocks to skip and the number of changed
+//     blocks that follow, as LEB128 integers, then the XOR of those blocks
+//     with the previous frame.
+//
+// The first frame is a keyframe, and so is every `kKeyframeInterval`-th one
+// after it, or any delta that would be larger than a keyframe, so readers
+// can start from any keyframe. A stream whose name ends in `kZstdExtension`
+// is compressed as a whole with zstd, when built with `make ZSTD=1`.
+typedef struct {
+  int fd;                   // Descriptor written to
+  const char* filename;     // Name of the stream, for error messages
+  size_t every;             // Generations between two frames, or 0 for the
+                            // last one only
+  size_t frames;            // Frames written so far
+  size_t frame_bytes;       // Size of the packed cells of a frame
+  size_t blocks;            // 8-byte blocks covering `frame_bytes`
+  unsigned char* current;   // Packed cells of the frame being written
+  unsigned char* previous;  // Packed cells of the last frame written
+  unsigned char* delta;     // Payload of the delta frame being built
+  unsigned char* buffer;    // Bytes not written to `fd` yet
+  size_t length;            // Bytes held by `buffer`
+  int failed;               // Whether a write failed
+#ifdef LIFE_HAVE_ZSTD
+  ZSTD_CCtx* zstd;          // Compressor, or NULL for a plain stream
+  unsigned char* packed;    // Output of the compressor
+  size_t packed_size;
+#endif
+} stream_t;
+
+static const char kStreamMagic[4] = {'L', 'I', 'F', 'S'};
+static const char kStandardStream[] = "-";
+static const char kZstdExtension[] = ".zst";
+enum {
+  kFrameKey = 'K',
+  kFrameDelta = 'D',
+  kFrameHeaderSize = 17,
+  kKeyframeInterval = 256,
+  kStreamBufferSize = 1 << 20,
+};
+
+stream_t* CreateStream(const char* filename, size_t rows, size_t cols,
+                       const rule_t* rule, size_t every);
+int CloseStream(stream_t* stream);
+int StreamsGeneration(const stream_t* stream, size_t gen, int last);
+int WriteFrame(stream_t* stream, const world_t* world, size_t gen, int last);
+
+#endif  // STREAM_H_
@@ -0,0 +1,102 @@
+#ifndef SWAR_H_
+#define SWAR_H_
+
+#include <stdint.h>
+
+#include "rule.h"
+
+// The gpu engine runs these helpers on the device too, so nvcc compiles them
+// for both sides
+#ifdef __CUDACC__
+#define LIFE_SWAR_DEVICE __host__ __device__
+#else
+#define LIFE_SWAR_DEVICE
+#endif
+
+/**
+ * @brief Counts the live neighbours of 64 cells at once.
+ *
+ * Adds up the eight neighbour words of a word with bitwise full adders so
+ * that every bit position holds its own neighbour count. `ones` and `twos`
+ * receive the two low bits of the counts, `fours` flags the counts of at
+ * least 4 and `eights` the count of 8. Each argument holds one row of
+ * neighbours aligned with the centre word: `nw`, `n` and `ne` come from the
+ * row above, `w` and `e` from the same row and `sw`, `s` and `se` from the
+ * row below.
+ */
+LIFE_SWAR_DEVICE
+static inline void SwarCountNeighbors(uint64_t nw, uint64_t n, uint64_t ne,
+                                      uint64_t w, uint64_t e, uint64_t sw,
+                                      uint64_t s, uint64_t se, uint64_t* ones,
+                                      uint64_t* twos, uint64_t* fours,
+                                      uint64_t* eights) {
+  // Column sums of the rows above and below (weights 1 and 2)
+  uint64_t above_ones = nw ^ n ^ ne;
+  uint64_t above_twos = (nw & n) | (ne & (nw ^ n));
+  uint64_t below_ones = sw ^ s ^ se;
+  uint64_t below_twos = (sw & s) | (se & (sw ^ s));
+  uint64_t mid_ones = w ^ e;
+  uint64_t mid_twos = w & e;
+
+  // Weight 1 bit of the count, carrying into weight 2
+  *ones = above_ones ^ below_ones ^ mid_ones;
+  uint64_t carry = (above_ones & below_ones) |
+                   (mid_ones & (above_ones ^ below_ones));
+
+  // Weight 2 bit of the count; any carry out means the count is at least 4,
+  // and two carries out that it is 8
+  uint64_t partial = above_twos ^ below_twos ^ mid_twos;
+  uint64_t majority = (above_twos & below_twos) |
+                      (mid_twos & (above_twos ^ below_twos));
+  uint64_t overflow = partial & carry;
+  *twos = partial ^ carry;
+  *fours = majority | overflow;
+  *eights = majority & overflow;
+}
+
+LIFE_DEFINE_APPLY_RULE(SwarApplyRule, uint64_t,
+                       LIFE_SWAR_DEVICE __attribute__((always_inline)))
+
+/**
+ * @brief Computes the next state of 64 cells at once.
+ *
+ * Counts the neighbours of the centre word `c` with `SwarCountNeighbors` and
+ * applies the rule given by the `birth` and `survive` masks to all 64 cells
+ * in parallel.
+ *
+ * @return The word holding the next state of the 64 centre cells.
+ */
+LIFE_SWAR_DEVICE __attribute__((always_inline))
+static inline uint64_t SwarNextWord(uint64_t nw, uint64_t n, uint64_t ne,
+                                    uint64_t w, uint64_t c, uint64_t e,
+                                    uint64_t sw, uint64_t s, uint64_t se,
+                                    unsigned birth, unsigned survive) {
+  uint64_t ones, twos, fours, eights;
+  SwarCountNeighbors(nw, n, ne, w, e, sw, s, se, &ones, &twos, &fours,
+                     &eights);
+  return SwarApplyRule(c, ones, twos, fours, eights, birth, survive);
+}
+
+/**
+ * @brief Computes the next state of one word from the rows around it.
+ *
+ * Builds the shifted neighbour words of the word at `mid` from the matching
+ * words of the row above (`up`) and the row below (`down`), borrowing the edge
+ * bits from the words on either side of each of them.
+ *
+ * @return The word holding the next state of the 64 cells at `mid`.
+ */
+LIFE_SWAR_DEVICE __attribute__((always_inline))
+static inline uint64_t SwarStepWord(const uint64_t* up, const uint64_t* mid,
+                                    const uint64_t* down, unsigned birth,
+                                    unsigned survive) {
+  uint64_t n = up[0];
+  uint64_t c = mid[0];
+  uint64_t s = down[0];
+  return SwarNextWord((n << 1) | (up[-1] >> 63), n, (n >> 1) | (up[1] << 63),
+                      (c << 1) | (mid[-1] >> 63), c, (c >> 1) | (mid[1] << 63),
+                      (s << 1) | (down[-1] >> 63), s,
+                      (s >> 1) | (down[1] << 63), birth, survive);
+}
+
+#endif  // SWAR_H_
@@ -0,0 +1,238 @@
+/**
+ * temporal.c
+ *
+ * Implements temporal blocking, which advances the world several
+ * generations per pass over its memory. Stepping one generation at a time
+ * streams the whole world through the memory bus every generation, which
+ * bounds large worlds by the bandwidth rather than by the kernels. Here each
+ * band of rows is advanced by several generations while it sits in the
+ * cache, so the traffic to the memory is divided by the depth of the pass.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "temporal.h"
+
+static void StepTemporalBands(void* arg, size_t worker, size_t workers);
+static void StepBand(const temporal_pass_t* pass, world_t** scratch,
+                     size_t begin, size_t end);
+
+/**
+ * @brief Creates the scratch space for advancing a world up to `depth`
+ *        generations per pass.
+ *
+ * The bands are as tall as the two scratch worlds of a worker allow within
+ * `kTemporalCacheBytes`, but never shorter than twice the depth, so that
+ * the rows recomputed by neighbouring bands stay a fraction of the work, and
+ * never taller than needed to give every worker a band.
+ *
+ * @param world   The world to advance, which sets the size of the bands.
+ * @param depth   The most generations advanced per pass, from 1 to
+ *                `kMaxTemporalDepth`.
+ * @param workers The number of workers of the pool running the passes.
+ *
+ * @return Returns a pointer to the new scratch space, or NULL if memory
+ *         allocation fails.
+ *
+ * @note The returned scratch space must be released with `FreeTemporal`.
+ */
+temporal_t* CreateTemporal(const world_t* world, size_t depth,
+                           size_t workers) {
+  temporal_t* temporal = calloc(1, sizeof(temporal_t));
+  if (!temporal) {
+    return NULL;
+  }
+
+  size_t row_bytes = world->stride * sizeof(uint64_t);
+  size_t fit = kTemporalCacheBytes / (2 * row_bytes);
+  size_t band_rows = fit > 4 * depth ? fit - 2 * depth : 2 * depth;
+  size_t share = (world->rows + workers - 1) / workers;
+  if (band_rows > share) {
+    band_rows = share ? share : 1;
+  }
+
+  temporal->depth = depth;
+  temporal->band_rows = band_rows;
+  temporal->bands = (world->rows + band_rows - 1) / band_rows;
+  temporal->workers = workers;
+  temporal->scratch = calloc(2 * workers, sizeof(world_t*));
+  if (!temporal->scratch) {
+    FreeTemporal(temporal);
+    return NULL;
+  }
+  for (size_t i = 0; i < 2 * workers; i++) {
+    temporal->scratch[i] = CreateWorldGrid(band_rows + 2 * depth,
+                                           world->cols);
+    if (!temporal->scratch[i]) {
+      FreeTemporal(temporal);
+      return NULL;
+    }
+  }
+  return temporal;
+}
+
+/**
+ * @brief Frees the scratch space created by `CreateTemporal`.
+ *
+ * @param temporal The scratch space to free. It is safe to pass NULL.
+ */
+void FreeTemporal(temporal_t* temporal) {
+  if (!temporal) {
+    return;
+  }
+  if (temporal->scratch) {
+    for (size_t i = 0; i < 2 * temporal->workers; i++) {
+      FreeWorldGrid(temporal->scratch[i]);
+    }
+  }
+  free(temporal->scratch);
+  free(temporal);
+}
+
+/**
+ * @brief Advances `src` by `generations` generations into `dst` in a single
+ *        pass.
+ *
+ * The bands are split between the workers of `pool` like the bands of
+ * `SimulateBand`, each worker stepping its bands one after another in its
+ * own scratch worlds. Every live cell of `dst` is written, so a tile map of
+ * the world no longer knows which tiles changed afterwards and must have
+ * every tile marked changed before it is used again.
+ *
+ * When the world wraps around, the rows above and below a band are taken
+ * from the opposite edge and the padding columns of the scratch worlds are
+ * refilled every generation, so `src` needs no halo of its own. `src` is
+ * left untouched.
+ *
+ * @param temporal    The scratch space, created for worlds of this size and
+ *                    at least as many workers as `pool` has.
+ * @param engine      The engine stepping each generation of the bands.
+ * @param rule        The rule deciding births and survivals.
+ * @param src         The current generation.
+ * @param dst         The world receiving the generation `generations` later.
+ * @param generations The number of generations to advance, from 1 to the
+ *                    depth of `temporal`.
+ * @param wrap        Non-zero if the world wraps around its edges.
+ * @param pool        The pool of workers running the pass.
+ */
+void StepTemporal(temporal_t* temporal, const engine_t* engine,
+                  const rule_t* rule, const world_t* src, world_t* dst,
+                  size_t generations, int wrap, pool_t* pool) {
+  temporal_pass_t pass = {temporal, engine, rule, src, dst, generations,
+                          wrap};
+  RunPool(pool, StepTemporalBands, &pass);
+}
+
+/**
+ * @brief Advances one worker's share of the bands of a pass.
+ *
+ * @param arg     A pointer to the `temporal_pass_t` being run.
+ * @param worker  The index of the calling worker.
+ * @param workers The number of workers sharing the pass.
+ */
+static void StepTemporalBands(void* arg, size_t worker, size_t workers) {
+  const temporal_pass_t* pass = arg;
+  const temporal_t* temporal = pass->temporal;
+  size_t begin = temporal->bands * worker / workers;
+  size_t end = temporal->bands * (worker + 1) / workers;
+  uint64_t start = ProfileClock();
+
+  for (size_t band = begin; band < end; band++) {
+    size_t row_begin = kPadding + band * temporal->band_rows;
+    size_t row_end = row_begin + temporal->band_rows;
+    if (row_end > pass->src->rows + kPadding) {
+      row_end = pass->src->rows + kPadding;
+    }
+    StepBand(pass, temporal->scratch + 2 * worker, row_begin, row_end);
+  }
+  ProfileSince(kPhaseCompute, worker, start);
+}
+
+/**
+ * @brief Advances the rows [`begin`, `end`) of the world by the generations
+ *        of the pass.
+ *
+ * Row `s` of the scratch worlds holds row `first + s` of the world. The
+ * first scratch world receives the band and the rows within the depth of
+ * the pass around it, and every generation is stepped into the other one,
+ * over a region one row shorter on each side than the generation before,
+ * since the rows at the edges of the region lack the neighbours above or
+ * below them. Along the edges of a bounded world, the rows past the edge
+ * stay dead in both scratch worlds instead.
+ *
+ * A band whose neighbourhood is entirely dead stays dead, and is cleared
+ * without being stepped.
+ */
+static void StepBand(const temporal_pass_t* pass, world_t** scratch,
+                     size_t begin, size_t end) {
+  const world_t* src = pass->src;
+  long long rows = (long long)src->rows;
+  long long depth = (long long)pass->generations;
+  long long first = (long long)begin - depth - 1;
+  size_t height = end - begin + 2 * pass->generations;
+  size_t bytes = src->stride * sizeof(uint64_t);
+  world_t* level = scratch[0];
+  world_t* other = scratch[1];
+
+  uint64_t alive = 0;
+  for (size_t s = 1; s <= height; s++) {
+    long long row = first + (long long)s;
+    uint64_t* cells = WorldRow(level, s);
+    if (pass->wrap) {
+      row = ((row - 1) % rows + rows) % rows + 1;
+    } else if (row < 1 || row > rows) {
+      memset(cells, 0, bytes);
+      memset(WorldRow(other, s), 0, bytes);
+      continue;
+    }
+
+    const uint64_t* source = WorldRow(src, (size_t)row);
+    for (size_t k = 0; k < src->stride; k++) {
+      cells[k] = source[k];
+      alive |= source[k];
+    }
+  }
+  if (!alive) {
+    memset(WorldRow(pass->dst, begin), 0, (end - begin) * bytes);
+    return;
+  }
+  if (pass->wrap) {
+    FillHaloColumns(level, kPadding, height + kPadding);
+  }
+
+  for (size_t g = 1; g <= pass->generations; g++) {
+    region_t region = WorldRegion(level);
+    region.row_begin = g + kPadding;
+    region.row_end = height + kPadding - g;
+    if (!pass->wrap) {
+      if ((long long)region.row_begin < 1 - first) {
+        region.row_begin = (size_t)(1 - first);
+      }
+      if ((long long)region.row_end > rows + 1 - first) {
+        region.row_end = (size_t)(rows + 1 - first);
+      }
+    }
+    pass->engine->step(level, other, &region, pass->rule);
+    if (pass->wrap && g < pass->generations) {
+      FillHaloColumns(other, region.row_begin, region.row_end);
+    }
+
+    world_t* tmp = level;
+    level = other;
+    other = tmp;
+  }
+
+  // Kernels that only write the live columns, like the scalar one, leave the
+  // padding columns of a wrapped band as they were filled two generations
+  // earlier
+  size_t band = (size_t)((long long)begin - first);
+  if (pass->wrap) {
+    for (size_t s = band; s < band + end - begin; s++) {
+      SetCell(level, s, 0, 0);
+      SetCell(level, s, src->cols + kPadding, 0);
+    }
+  }
+  memcpy(WorldRow(pass->dst, begin), WorldRow(level, band),
+         (end - begin) * bytes);
+}
@@ -0,0 +1,57 @@
+#ifndef TEMPORAL_H_
+#define TEMPORAL_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine.h"
+#include "pool.h"
+#include "profile.h"
+#include "rule.h"
+#include "world.h"
+
+// Most generations advanced by a single pass over the world
+static const size_t kMaxTemporalDepth = 64;
+// Bytes of the two scratch worlds of a worker, sized to stay in the L2 cache
+static const size_t kTemporalCacheBytes = 256 << 10;
+
+// Scratch space for advancing a world several generations per pass.
+//
+// The live rows of the world are cut into bands of `band_rows` rows. A band
+// is advanced `depth` generations at once: its rows and the `depth` rows
+// above and below it are copied into a scratch world small enough to stay
+// in the cache, stepped there back and forth between the two scratch worlds
+// of the worker, one row fewer on each side every generation, and only the
+// rows of the band itself are written back. Each row of the world is thus
+// read and written once per pass instead of once per generation, at the
+// cost of recomputing the rows bands share. Bands overlap, but each one
+// only writes its own rows, so the workers never wait for each other.
+typedef struct {
+  size_t depth;        // Most generations advanced per pass
+  size_t band_rows;    // Live rows of the world written back per band
+  size_t bands;        // Number of bands covering the world
+  size_t workers;      // Number of workers with scratch worlds
+  world_t** scratch;   // Two scratch worlds of `band_rows + 2 * depth` rows
+                       // per worker
+} temporal_t;
+
+// Work shared by the pool workers of one pass
+typedef struct {
+  temporal_t* temporal;
+  const engine_t* engine;
+  const rule_t* rule;
+  const world_t* src;
+  world_t* dst;
+  size_t generations;  // Generations advanced by the pass, up to `depth`
+  int wrap;            // Whether the world wraps around its edges
+} temporal_pass_t;
+
+temporal_t* CreateTemporal(const world_t* world, size_t depth,
+                           size_t workers);
+void FreeTemporal(temporal_t* temporal);
+void StepTemporal(temporal_t* temporal, const engine_t* engine,
+                  const rule_t* rule, const world_t* src, world_t* dst,
+                  size_t generations, int wrap, pool_t* pool);
+
+#endif  // TEMPORAL_H_
@@ -0,0 +1,520 @@
+/**
+ * tiles.c
+ *
+ * Implements sparse stepping of the world. The world is split into fixed-size
+ * tiles, and a map of the tiles that changed in the previous generation lets
+ * each generation skip the tiles whose neighbourhood stayed the same, so the
+ * cost of a generation follows the activity of the world rather than its
+ * area.
+ *
+ * Skipping relies on the double-buffered stepping done by `PlayGame`: a tile
+ * that did not change holds the same cells in both buffers, so leaving it
+ * untouched in the buffer being written is the same as recomputing it. The
+ * same holds for the hash of a tile, so only the tiles that changed are
+ * hashed again, and the same for the counters of a tile, which are counted
+ * while comparing its two generations, so they cost no pass of their own.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "tiles.h"
+
+static inline int IsTileActive(const tiles_t* tiles, size_t row, size_t col);
+static inline region_t TileRegion(const world_t* world, size_t row,
+                                  size_t col);
+static inline int TileChanged(const world_t* src, const world_t* dst,
+                              const region_t* region);
+static uint64_t HashTile(const world_t* world, const region_t* region,
+                         size_t index);
+static int CountTile(const tiles_t* tiles, const world_t* src,
+                     const world_t* dst, const region_t* region,
+                     cell_stats_t* stats);
+static void SumTileRow(tiles_t* tiles, size_t row);
+static inline void MergeStats(cell_stats_t* into, const cell_stats_t* from);
+
+/**
+ * @brief Creates the tile map of a world, with every tile marked changed.
+ *
+ * @param world The world to split into tiles.
+ * @param wrap  Non-zero if the world wraps around its edges.
+ *
+ * @return Returns a pointer to the new tile map, or NULL if memory allocation
+ *         fails.
+ *
+ * @note The returned map must be released with `FreeTiles`.
+ */
+tiles_t* CreateTiles(const world_t* world, int wrap) {
+  tiles_t* tiles = malloc(sizeof(tiles_t));
+  if (!tiles) {
+    return NULL;
+  }
+
+  tiles->rows = (world->rows + kTileRows - 1) / kTileRows;
+  tiles->cols = (LastWord(world) + kTileWords) / kTileWords;
+  tiles->wrap = wrap;
+  tiles->hashes = NULL;
+  tiles->stats = NULL;
+  tiles->row_stats = NULL;
+  tiles->popcount = 0;
+  tiles->changed = malloc(tiles->rows * tiles->cols);
+  tiles->next = malloc(tiles->rows * tiles->cols);
+  if (!tiles->changed || !tiles->next) {
+    FreeTiles(tiles);
+    return NULL;
+  }
+
+  MarkAllTilesChanged(tiles);
+  return tiles;
+}
+
+/**
+ * @brief Frees a tile map created by `CreateTiles`.
+ *
+ * @param tiles The tile map to free. It is safe to pass NULL.
+ */
+void FreeTiles(tiles_t* tiles) {
+  if (tiles) {
+    free(tiles->changed);
+    free(tiles->next);
+    free(tiles->hashes);
+    free(tiles->stats);
+    free(tiles->row_stats);
+    free(tiles);
+  }
+}
+
+/**
+ * @brief Marks every tile as changed, forcing the next generation to
+ *        recompute the whole world.
+ */
+void MarkAllTilesChanged(tiles_t* tiles) {
+  memset(tiles->changed, 1, tiles->rows * tiles->cols);
+}
+
+/**
+ * @brief Makes the tiles marked while computing a generation the baseline of
+ *        the next one.
+ */
+void SwapTiles(tiles_t* tiles) {
+  uint8_t* tmp = tiles->changed;
+  tiles->changed = tiles->next;
+  tiles->next = tmp;
+}
+
+/**
+ * @brief Starts keeping the hash of every tile, or starts over, from the
+ *        current state of the world.
+ *
+ * @param tiles The tile map of the world.
+ * @param world The world, in the generation the next step starts from.
+ *
+ * @return Returns 0 on success, -1 if memory allocation fails.
+ */
+int EnableTileHashes(tiles_t* tiles, const world_t* world) {
+  if (!tiles->hashes) {
+    tiles->hashes = malloc(tiles->rows * tiles->cols * sizeof(uint64_t));
+  }
+  if (!tiles->hashes) {
+    return -1;
+  }
+
+  for (size_t i = 0; i < tiles->rows; i++) {
+    for (size_t j = 0; j < tiles->cols; j++) {
+      region_t region = TileRegion(world, i, j);
+      size_t index = i * tiles->cols + j;
+      tiles->hashes[index] = HashTile(world, &region, index);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Returns the hash of the whole world, the sum of the hashes of its
+ *        tiles, kept by `EnableTileHashes`.
+ *
+ * Each tile hash depends on the position of the tile, so the same cells
+ * moved elsewhere yield a different hash.
+ */
+uint64_t WorldHash(const tiles_t* tiles) {
+  uint64_t hash = 0;
+  for (size_t k = 0; k < tiles->rows * tiles->cols; k++) {
+    hash += tiles->hashes[k];
+  }
+  return hash;
+}
+
+/**
+ * @brief Starts keeping the counters of every tile, or starts over, from the
+ *        current state of the world.
+ *
+ * The world counts as unchanged since the previous generation, so no cell
+ * is counted as born or dead.
+ *
+ * @param tiles The tile map of the world.
+ * @param world The world, in the generation the next step starts from.
+ *
+ * @return Returns 0 on success, -1 if memory allocation fails.
+ */
+int EnableTileStats(tiles_t* tiles, const world_t* world) {
+  if (!tiles->stats) {
+    tiles->stats = calloc(tiles->rows * tiles->cols, sizeof(cell_stats_t));
+    tiles->row_stats = malloc(tiles->rows * sizeof(cell_stats_t));
+  }
+  if (!tiles->stats || !tiles->row_stats) {
+    return -1;
+  }
+#ifdef LIFE_HAVE_X86_SIMD
+  tiles->popcount = HasPopcount();
+#endif
+
+  for (size_t i = 0; i < tiles->rows; i++) {
+    for (size_t j = 0; j < tiles->cols; j++) {
+      region_t region = TileRegion(world, i, j);
+      cell_stats_t* stats = &tiles->stats[i * tiles->cols + j];
+      CountTile(tiles, world, world, &region, stats);
+      stats->deaths = 0;
+    }
+    SumTileRow(tiles, i);
+  }
+  return 0;
+}
+
+/**
+ * @brief Sums the counters of the whole world, kept by `EnableTileStats`,
+ *        over its tile rows.
+ *
+ * @param tiles The tile map of the world.
+ * @param stats Receives the counters of the last generation computed.
+ */
+void WorldStats(const tiles_t* tiles, cell_stats_t* stats) {
+  *stats = kEmptyStats;
+  for (size_t i = 0; i < tiles->rows; i++) {
+    MergeStats(stats, &tiles->row_stats[i]);
+  }
+}
+
+/**
+ * @brief Computes the active tiles of a range of tile rows.
+ *
+ * Recomputes every tile of tile rows [tile_row_begin, tile_row_end) that is
+ * active according to `IsTileActive`, and records in `tiles->next` which of
+ * them changed, hashing those again if hashes are kept. Inactive tiles are
+ * left untouched. If counters are kept, the recomputed tiles are counted
+ * instead of just compared, the inactive ones keep their population with no
+ * births or deaths, and the counters of each tile row are summed.
+ *
+ * @param engine         The engine computing the tiles.
+ * @param rule           The rule deciding births and survivals.
+ * @param src            The world holding the current generation.
+ * @param dst            The world receiving the next generation.
+ * @param tiles          The tile map of the world.
+ * @param tile_row_begin The first tile row to compute.
+ * @param tile_row_end   One past the last tile row to compute.
+ */
+void StepTileRows(const engine_t* engine, const rule_t* rule,
+                  const world_t* src, world_t* dst, tiles_t* tiles,
+                  size_t tile_row_begin, size_t tile_row_end) {
+  for (size_t i = tile_row_begin; i < tile_row_end; i++) {
+    for (size_t j = 0; j < tiles->cols; j++) {
+      uint8_t changed = 0;
+      size_t index = i * tiles->cols + j;
+      if (IsTileActive(tiles, i, j)) {
+        region_t region = TileRegion(src, i, j);
+        engine->step(src, dst, &region, rule);
+        if (tiles->stats) {
+          changed = (uint8_t)CountTile(tiles, src, dst, &region,
+                                       &tiles->stats[index]);
+        } else {
+          changed = (uint8_t)TileChanged(src, dst, &region);
+        }
+        if (changed && tiles->hashes) {
+          tiles->hashes[index] = HashTile(dst, &region, index);
+        }
+      } else if (tiles->stats) {
+        tiles->stats[index].births = 0;
+        tiles->stats[index].deaths = 0;
+      }
+      tiles->next[index] = changed;
+    }
+    if (tiles->stats) {
+      SumTileRow(tiles, i);
+    }
+  }
+}
+
+/**
+ * @brief Checks whether a tile, or any tile around it, changed in the last
+ *        generation.
+ *
+ * @param tiles The tile map of the world.
+ * @param row   The tile row of the tile.
+ * @param col   The tile column of the tile.
+ *
+ * @return 1 if the tile must be recomputed, 0 otherwise.
+ */
+inline int IsTileActive(const tiles_t* tiles, size_t row, size_t col) {
+  if (tiles->wrap) {
+    // Adding `rows` or `cols` keeps the offsets of the neighbours positive
+    for (size_t i = 0; i < 3; i++) {
+      size_t r = (row + tiles->rows + i - 1) % tiles->rows;
+      for (size_t j = 0; j < 3; j++) {
+        size_t c = (col + tiles->cols + j - 1) % tiles->cols;
+        if (tiles->changed[r * tiles->cols + c]) {
+          return 1;
+        }
+      }
+    }
+    return 0;
+  }
+
+  size_t row_begin = row > 0 ? row - 1 : 0;
+  size_t row_end = row + 1 < tiles->rows ? row + 2 : tiles->rows;
+  size_t col_begin = col > 0 ? col - 1 : 0;
+  size_t col_end = col + 1 < tiles->cols ? col + 2 : tiles->cols;
+
+  for (size_t i = row_begin; i < row_end; i++) {
+    for (size_t j = col_begin; j < col_end; j++) {
+      if (tiles->changed[i * tiles->cols + j]) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Returns the region of the world covered by a tile.
+ *
+ * @param world The world split into tiles.
+ * @param row   The tile row of the tile.
+ * @param col   The tile column of the tile.
+ */
+inline region_t TileRegion(const world_t* world, size_t row, size_t col) {
+  region_t region;
+  region.row_begin = kPadding + row * kTileRows;
+  region.row_end = region.row_begin + kTileRows;
+  if (region.row_end > world->rows + kPadding) {
+    region.row_end = world->rows + kPadding;
+  }
+  region.word_begin = col * kTileWords;
+  region.word_end = region.word_begin + kTileWords;
+  if (region.word_end > LastWord(world) + 1) {
+    region.word_end = LastWord(world) + 1;
+  }
+  return region;
+}
+
+/**
+ * @brief Checks whether a region differs between two generations.
+ *
+ * Only the live cells are compared: the padding columns of a wrapped world
+ * hold copies of the opposite edge in `src` while it is stepped, but are
+ * always dead in `dst`, like in `CountRegion`.
+ *
+ * @param src    The world holding the current generation.
+ * @param dst    The world holding the next generation.
+ * @param region The region to compare.
+ *
+ * @return 1 if any live cell of the region changed, 0 otherwise.
+ */
+inline int TileChanged(const world_t* src, const world_t* dst,
+                       const region_t* region) {
+  uint64_t first = region->word_begin == 0 ? ~(uint64_t)1 : ~(uint64_t)0;
+  uint64_t last = region->word_end == LastWord(dst) + 1 ? LastWordMask(dst)
+                                                        : ~(uint64_t)0;
+  size_t end = region->word_end - 1;
+  uint64_t diff = 0;
+  for (size_t i = region->row_begin; i < region->row_end; i++) {
+    const uint64_t* before = WorldRow(src, i);
+    const uint64_t* after = WorldRow(dst, i);
+    uint64_t edges = (before[region->word_begin] ^
+                      after[region->word_begin]) & first;
+    edges |= (before[end] ^ after[end]) & last;
+    if (region->word_begin == end) {
+      edges &= first & last;
+    }
+    diff |= edges;
+    for (size_t k = region->word_begin + 1; k < end; k++) {
+      diff |= before[k] ^ after[k];
+    }
+  }
+  return diff != 0;
+}
+
+/**
+ * @brief Hashes the cells of a tile, seeded with its index in the map.
+ *
+ * The words of each row are spread over four independent multiply-xor
+ * chains, so consecutive words do not wait for each other, and each chain
+ * goes through the finalizer of SplitMix64 before they are combined so that
+ * the sum of many tile hashes stays well mixed.
+ */
+static uint64_t HashTile(const world_t* world, const region_t* region,
+                         size_t index) {
+  const uint64_t kMultiplier = 0xFF51AFD7ED558CCD;
+  uint64_t seed = ((uint64_t)index + 1) * 0x9E3779B97F4A7C15;
+  uint64_t lanes[4] = {seed, seed + 1, seed + 2, seed + 3};
+  uint64_t h0 = lanes[0], h1 = lanes[1], h2 = lanes[2], h3 = lanes[3];
+
+  for (size_t i = region->row_begin; i < region->row_end; i++) {
+    const uint64_t* row = WorldRow(world, i);
+    size_t k = region->word_begin;
+    for (; k + 4 <= region->word_end; k += 4) {
+      h0 = (h0 ^ row[k]) * kMultiplier;
+      h1 = (h1 ^ row[k + 1]) * kMultiplier;
+      h2 = (h2 ^ row[k + 2]) * kMultiplier;
+      h3 = (h3 ^ row[k + 3]) * kMultiplier;
+    }
+    // Narrow tiles along the right edge feed the first chains only
+    if (k < region->word_end) {
+      h0 = (h0 ^ row[k++]) * kMultiplier;
+    }
+    if (k < region->word_end) {
+      h1 = (h1 ^ row[k++]) * kMultiplier;
+    }
+    if (k < region->word_end) {
+      h2 = (h2 ^ row[k]) * kMultiplier;
+    }
+  }
+
+  lanes[0] = h0;
+  lanes[1] = h1;
+  lanes[2] = h2;
+  lanes[3] = h3;
+  uint64_t hash = 0;
+  for (size_t l = 0; l < 4; l++) {
+    uint64_t lane = lanes[l];
+    lane ^= lane >> 30;
+    lane *= 0xBF58476D1CE4E5B9;
+    lane ^= lane >> 27;
+    lane *= 0x94D049BB133111EB;
+    lane ^= lane >> 31;
+    hash = (hash ^ lane) * 0x9E3779B97F4A7C15;
+  }
+  return hash;
+}
+
+/**
+ * @brief Counts the live cells of a region in the next generation, and those
+ *        born and dead since the current one, while comparing them.
+ *
+ * Only the live columns are counted, since the padding columns of the
+ * current generation hold the opposite edges of a wrapped world. The deaths
+ * are not counted but follow from the births and the population of the
+ * region in the current generation, which saves a third of the counting.
+ *
+ * @param src    The world holding the current generation.
+ * @param dst    The world holding the next generation.
+ * @param region The region to count.
+ * @param stats  Holds the counters of the region in the current generation,
+ *               and receives those of the next one.
+ *
+ * @return 1 if any live cell of the region changed, 0 otherwise.
+ */
+static inline __attribute__((always_inline)) int CountRegion(
+    const world_t* src, const world_t* dst, const region_t* region,
+    cell_stats_t* stats) {
+  size_t words = region->word_end - region->word_begin;
+  uint64_t masks[kTileWords];
+  uint64_t columns[kTileWords];
+  for (size_t w = 0; w < words; w++) {
+    masks[w] = ~(uint64_t)0;
+    columns[w] = 0;
+  }
+  if (region->word_begin == 0) {
+    masks[0] &= ~(uint64_t)1;
+  }
+  if (region->word_end == LastWord(dst) + 1) {
+    masks[words - 1] &= LastWordMask(dst);
+  }
+
+  // The bounding box is taken from the rows and the columns of words where
+  // any cell is alive, once the whole tile is counted
+  cell_stats_t count = kEmptyStats;
+  for (size_t i = region->row_begin; i < region->row_end; i++) {
+    const uint64_t* before = WorldRow(src, i) + region->word_begin;
+    const uint64_t* after = WorldRow(dst, i) + region->word_begin;
+    uint64_t any = 0;
+    for (size_t w = 0; w < words; w++) {
+      uint64_t cells = after[w] & masks[w];
+      count.population += (size_t)__builtin_popcountll(cells);
+      count.births += (size_t)__builtin_popcountll(cells & ~before[w]);
+      columns[w] |= cells;
+      any |= cells;
+    }
+    if (any) {
+      count.top = count.top < i - kPadding ? count.top : i - kPadding;
+      count.bottom = i - kPadding;
+    }
+  }
+
+  for (size_t w = 0; w < words && count.population; w++) {
+    if (columns[w]) {
+      size_t k = region->word_begin + w;
+      size_t right = k * kWordBits + kWordBits - 1 -
+                     (size_t)__builtin_clzll(columns[w]);
+      if (count.left == SIZE_MAX) {
+        count.left = k * kWordBits + (size_t)__builtin_ctzll(columns[w]) -
+                     kPadding;
+      }
+      count.right = right - kPadding;
+    }
+  }
+  count.deaths = stats->population + count.births - count.population;
+  *stats = count;
+  return count.births || count.deaths;
+}
+
+#ifdef LIFE_HAVE_X86_SIMD
+/**
+ * @brief `CountRegion` compiled with the popcnt instruction.
+ */
+__attribute__((target("popcnt")))
+static int CountRegionPopcount(const world_t* src, const world_t* dst,
+                               const region_t* region, cell_stats_t* stats) {
+  return CountRegion(src, dst, region, stats);
+}
+#endif
+
+/**
+ * @brief Counts a tile with `CountRegion`, using the popcnt instruction if
+ *        the CPU has it, since the portable builtin is several times slower.
+ */
+static int CountTile(const tiles_t* tiles, const world_t* src,
+                     const world_t* dst, const region_t* region,
+                     cell_stats_t* stats) {
+#ifdef LIFE_HAVE_X86_SIMD
+  if (tiles->popcount) {
+    return CountRegionPopcount(src, dst, region, stats);
+  }
+#else
+  (void)tiles;
+#endif
+  return CountRegion(src, dst, region, stats);
+}
+
+/**
+ * @brief Sums the counters of the tiles of a tile row into its row counters.
+ */
+static void SumTileRow(tiles_t* tiles, size_t row) {
+  cell_stats_t* sum = &tiles->row_stats[row];
+  *sum = kEmptyStats;
+  for (size_t j = 0; j < tiles->cols; j++) {
+    MergeStats(sum, &tiles->stats[row * tiles->cols + j]);
+  }
+}
+
+/**
+ * @brief Adds the counters of a region to those of another one, growing its
+ *        bounding box to cover both.
+ */
+static inline void MergeStats(cell_stats_t* into, const cell_stats_t* from) {
+  into->population += from->population;
+  into->births += from->births;
+  into->deaths += from->deaths;
+  into->top = from->top < into->top ? from->top : into->top;
+  into->left = from->left < into->left ? from->left : into->left;
+  into->bottom = from->bottom > into->bottom ? from->bottom : into->bottom;
+  into->right = from->right > into->right ? from->right : into->right;
+}
@@ -0,0 +1,72 @@
+#ifndef TILES_H_
+#define TILES_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine.h"
+#include "world.h"
+
+// Height of a tile, in rows
+static const size_t kTileRows = 32;
+// Width of a tile, in 64-bit words
+static const size_t kTileWords = 8;
+
+// Counters of the cells of a world, or of a part of it, in one generation.
+//
+// The bounding box holds the live cells within rows [`top`, `bottom`] and
+// columns [`left`, `right`], counted from 0 at the top left cell of the
+// world. It is empty when `top` is past `bottom`, as `kEmptyStats` is.
+typedef struct {
+  size_t population;  // Live cells
+  size_t births;      // Cells born since the previous generation
+  size_t deaths;      // Cells dead since the previous generation
+  size_t top;
+  size_t left;
+  size_t bottom;
+  size_t right;
+} cell_stats_t;
+
+// Counters of a region without live cells, which merges as a no-op
+static const cell_stats_t kEmptyStats = {0, 0, 0, SIZE_MAX, SIZE_MAX, 0, 0};
+
+// Map of the tiles of a world that changed between two generations.
+//
+// The live area of the world is cut into tiles of `kTileRows` rows by
+// `kTileWords` words. A tile only needs to be recomputed if it, or one of
+// the eight tiles around it, changed in the previous generation; every other
+// tile is known to keep its current state. On a torus, the tiles along one
+// edge of the world neighbour the tiles along the opposite edge.
+//
+// The map can also keep a 64-bit hash of the cells of each tile, refreshed
+// only for the tiles that changed. Their sum hashes the whole world, at a cost
+// that follows the activity of the world like the generations themselves.
+// Likewise, it can keep the counters of each tile, counted while comparing
+// the tiles that were recomputed, and their sum over each tile row, which
+// the worker stepping the row adds up.
+typedef struct {
+  size_t rows;       // Number of tile rows
+  size_t cols;       // Number of tile columns
+  int wrap;          // Whether the world wraps around its edges
+  uint8_t* changed;  // Tiles that changed in the last generation
+  uint8_t* next;     // Tiles changing in the generation being computed
+  uint64_t* hashes;  // Hash of the cells of each tile, or NULL if not kept
+  cell_stats_t* stats;      // Counters of each tile, or NULL if not kept
+  cell_stats_t* row_stats;  // Counters of each tile row
+  int popcount;             // Whether the counters use the popcnt instruction
+} tiles_t;
+
+tiles_t* CreateTiles(const world_t* world, int wrap);
+void FreeTiles(tiles_t* tiles);
+void MarkAllTilesChanged(tiles_t* tiles);
+void SwapTiles(tiles_t* tiles);
+int EnableTileHashes(tiles_t* tiles, const world_t* world);
+uint64_t WorldHash(const tiles_t* tiles);
+int EnableTileStats(tiles_t* tiles, const world_t* world);
+void WorldStats(const tiles_t* tiles, cell_stats_t* stats);
+void StepTileRows(const engine_t* engine, const rule_t* rule,
+                  const world_t* src, world_t* dst, tiles_t* tiles,
+                  size_t tile_row_begin, size_t tile_row_end);
+
+#endif  // TILES_H_
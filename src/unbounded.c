@@ -0,0 +1,424 @@
+/**
+ * unbounded.c
+ *
+ * Implements an unbounded universe for the SWAR kernel. Live cells are kept
+ * in 64 x 64 chunks stored in a hash map keyed by chunk coordinates. Chunks
+ * are created as soon as activity reaches their edge and released when they
+ * empty, so memory follows the population rather than the bounding box of
+ * the pattern.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "unbounded.h"
+
+// Number of chunks allocated at once
+#define kSlabChunks 256
+
+struct chunk_slab_t {
+  chunk_slab_t* next;
+  chunk_t chunks[kSlabChunks];
+};
+
+static const size_t kInitialChunkSlots = 64;
+
+// Work shared by the pool workers computing one generation
+typedef struct {
+  universe_t* universe;
+} universe_step_t;
+
+/**
+ * @brief Creates an empty unbounded universe.
+ *
+ * @param rule The rule the universe evolves under. It must not include B0,
+ *             which would fill the empty plane.
+ *
+ * @return Returns a pointer to the new universe, or NULL if memory allocation
+ *         fails.
+ *
+ * @note The returned universe must be released with `FreeUniverse`.
+ */
+universe_t* CreateUniverse(const rule_t* rule) {
+  universe_t* universe = calloc(1, sizeof(universe_t));
+  if (!universe) {
+    return NULL;
+  }
+
+  universe->rule = *rule;
+  universe->table_size = kInitialChunkSlots;
+  universe->table = calloc(universe->table_size, sizeof(chunk_t*));
+  if (!universe->table) {
+    free(universe);
+    return NULL;
+  }
+
+  return universe;
+}
+
+/**
+ * @brief Frees a universe created by `CreateUniverse`.
+ *
+ * @param universe The universe to free. It is safe to pass NULL.
+ */
+void FreeUniverse(universe_t* universe) {
+  if (universe) {
+    while (universe->slabs) {
+      chunk_slab_t* next = universe->slabs->next;
+      free(universe->slabs);
+      universe->slabs = next;
+    }
+    free(universe->chunks);
+    free(universe->table);
+    free(universe);
+  }
+}
+
+/**
+ * @brief Returns the first hash map slot to probe for a chunk.
+ */
+static inline size_t ChunkSlot(const universe_t* universe, int64_t x,
+                               int64_t y) {
+  uint64_t h = (uint64_t)x * 0x9E3779B97F4A7C15ULL ^
+               (uint64_t)y * 0xC2B2AE3D27D4EB4FULL;
+  return (size_t)(h ^ (h >> 32)) & (universe->table_size - 1);
+}
+
+/**
+ * @brief Looks up the chunk at chunk coordinates (x, y).
+ *
+ * @return Returns a pointer to the chunk, or NULL if it is not allocated,
+ *         meaning all of its cells are dead.
+ */
+static chunk_t* FindChunk(const universe_t* universe, int64_t x, int64_t y) {
+  size_t mask = universe->table_size - 1;
+  for (size_t i = ChunkSlot(universe, x, y); universe->table[i];
+       i = (i + 1) & mask) {
+    if (universe->table[i]->x == x && universe->table[i]->y == y) {
+      return universe->table[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Inserts a chunk in the hash map, which must have a free slot.
+ */
+static void InsertChunk(universe_t* universe, chunk_t* chunk) {
+  size_t mask = universe->table_size - 1;
+  size_t i = ChunkSlot(universe, chunk->x, chunk->y);
+  while (universe->table[i]) {
+    i = (i + 1) & mask;
+  }
+  universe->table[i] = chunk;
+}
+
+/**
+ * @brief Doubles the number of slots of the hash map.
+ *
+ * @return Returns 0 on success, -1 if memory allocation fails.
+ */
+static int GrowChunkTable(universe_t* universe) {
+  chunk_t** old = universe->table;
+  size_t old_size = universe->table_size;
+  chunk_t** table = calloc(old_size * 2, sizeof(chunk_t*));
+  if (!table) {
+    return -1;
+  }
+
+  universe->table = table;
+  universe->table_size = old_size * 2;
+  for (size_t i = 0; i < old_size; i++) {
+    if (old[i]) {
+      InsertChunk(universe, old[i]);
+    }
+  }
+  free(old);
+  return 0;
+}
+
+/**
+ * @brief Allocates an empty chunk at chunk coordinates (x, y).
+ *
+ * @return Returns a pointer to the new chunk, or NULL if memory allocation
+ *         fails.
+ */
+static chunk_t* AddChunk(universe_t* universe, int64_t x, int64_t y) {
+  if ((universe->chunk_count + 1) * 2 > universe->table_size &&
+      GrowChunkTable(universe) < 0) {
+    return NULL;
+  }
+  if (universe->chunk_count == universe->chunk_capacity) {
+    size_t capacity = universe->chunk_capacity ? universe->chunk_capacity * 2
+                                               : kInitialChunkSlots;
+    chunk_t** chunks = realloc(universe->chunks, capacity * sizeof(chunk_t*));
+    if (!chunks) {
+      return NULL;
+    }
+    universe->chunks = chunks;
+    universe->chunk_capacity = capacity;
+  }
+  if (!universe->free_chunks) {
+    chunk_slab_t* slab = malloc(sizeof(chunk_slab_t));
+    if (!slab) {
+      return NULL;
+    }
+    slab->next = universe->slabs;
+    universe->slabs = slab;
+    for (size_t i = 0; i < kSlabChunks; i++) {
+      slab->chunks[i].next_free = universe->free_chunks;
+      universe->free_chunks = &slab->chunks[i];
+    }
+  }
+
+  chunk_t* chunk = universe->free_chunks;
+  universe->free_chunks = chunk->next_free;
+  memset(chunk, 0, sizeof(chunk_t));
+  chunk->x = x;
+  chunk->y = y;
+
+  InsertChunk(universe, chunk);
+  universe->chunks[universe->chunk_count++] = chunk;
+  return chunk;
+}
+
+/**
+ * @brief Removes the chunk at index `index` of `universe->chunks`.
+ *
+ * Deletes the chunk from the hash map, shifting back the chunks probed after
+ * it so that no lookup stops early, and returns it to the free list.
+ */
+static void RemoveChunk(universe_t* universe, size_t index) {
+  chunk_t* chunk = universe->chunks[index];
+  size_t mask = universe->table_size - 1;
+  size_t i = ChunkSlot(universe, chunk->x, chunk->y);
+  while (universe->table[i] != chunk) {
+    i = (i + 1) & mask;
+  }
+
+  universe->table[i] = NULL;
+  for (size_t j = (i + 1) & mask; universe->table[j]; j = (j + 1) & mask) {
+    chunk_t* moved = universe->table[j];
+    size_t home = ChunkSlot(universe, moved->x, moved->y);
+    // Move the chunk into the hole unless its home slot lies in (i, j]
+    if (((j - home) & mask) >= ((j - i) & mask)) {
+      universe->table[i] = moved;
+      universe->table[j] = NULL;
+      i = j;
+    }
+  }
+
+  universe->chunks[index] = universe->chunks[--universe->chunk_count];
+  chunk->next_free = universe->free_chunks;
+  universe->free_chunks = chunk;
+}
+
+/**
+ * @brief Makes sure the chunk at (x, y) exists.
+ *
+ * @return Returns 0 on success, -1 if memory allocation fails.
+ */
+static int TouchChunk(universe_t* universe, int64_t x, int64_t y) {
+  if (FindChunk(universe, x, y) || AddChunk(universe, x, y)) {
+    return 0;
+  }
+  return -1;
+}
+
+/**
+ * @brief Allocates the chunks that live cells at the edge of `chunk` may
+ *        spread into during the next generation.
+ *
+ * @return Returns 0 on success, -1 if memory allocation fails.
+ */
+static int GrowAround(universe_t* universe, const chunk_t* chunk) {
+  const uint64_t* rows = chunk->rows[universe->current];
+  uint64_t top = rows[0];
+  uint64_t bottom = rows[kChunkSize - 1];
+  uint64_t any = 0;
+  uint64_t left = 0;
+  uint64_t right = 0;
+  for (size_t i = 0; i < kChunkSize; i++) {
+    any |= rows[i];
+    left |= rows[i] & 1;
+    right |= rows[i] >> 63;
+  }
+  if (!any) {
+    return 0;
+  }
+
+  int64_t x = chunk->x;
+  int64_t y = chunk->y;
+  if ((top && TouchChunk(universe, x, y - 1) < 0) ||
+      (bottom && TouchChunk(universe, x, y + 1) < 0) ||
+      (left && TouchChunk(universe, x - 1, y) < 0) ||
+      (right && TouchChunk(universe, x + 1, y) < 0) ||
+      ((top & 1) && TouchChunk(universe, x - 1, y - 1) < 0) ||
+      ((top >> 63) && TouchChunk(universe, x + 1, y - 1) < 0) ||
+      ((bottom & 1) && TouchChunk(universe, x - 1, y + 1) < 0) ||
+      ((bottom >> 63) && TouchChunk(universe, x + 1, y + 1) < 0)) {
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Computes the next generation of one chunk.
+ *
+ * Gathers the chunk and the edge rows and columns of its eight neighbours
+ * into a 66-row window, then runs the SWAR kernel over it.
+ */
+static void StepChunk(const universe_t* universe, chunk_t* chunk) {
+  int current = universe->current;
+  const chunk_t* around[3][3];
+  for (int dy = 0; dy < 3; dy++) {
+    for (int dx = 0; dx < 3; dx++) {
+      around[dy][dx] = FindChunk(universe, chunk->x + dx - 1,
+                                 chunk->y + dy - 1);
+    }
+  }
+
+  // Row r + 1 of the window holds row r of the chunk, for r in [-1, 64]
+  uint64_t window[kChunkSize + 2][3];
+  for (int r = 0; r < kChunkSize + 2; r++) {
+    int dy = r == 0 ? 0 : (r == kChunkSize + 1 ? 2 : 1);
+    int row = r == 0 ? kChunkSize - 1 : (r == kChunkSize + 1 ? 0 : r - 1);
+    for (int dx = 0; dx < 3; dx++) {
+      const chunk_t* source = around[dy][dx];
+      window[r][dx] = source ? source->rows[current][row] : 0;
+    }
+  }
+
+  uint64_t* out = chunk->rows[!current];
+  uint64_t any = 0;
+  unsigned birth = universe->rule.birth;
+  unsigned survive = universe->rule.survive;
+  for (int r = 0; r < kChunkSize; r++) {
+    out[r] = SwarStepWord(&window[r][1], &window[r + 1][1],
+                          &window[r + 2][1], birth, survive);
+    any |= out[r];
+  }
+  chunk->alive = any != 0;
+}
+
+/**
+ * @brief Computes one worker's share of the chunks of a generation.
+ */
+static void StepChunks(void* arg, size_t worker, size_t workers) {
+  universe_t* universe = ((universe_step_t*)arg)->universe;
+  size_t begin = universe->chunk_count * worker / workers;
+  size_t end = universe->chunk_count * (worker + 1) / workers;
+  uint64_t start = ProfileClock();
+  for (size_t i = begin; i < end; i++) {
+    StepChunk(universe, universe->chunks[i]);
+  }
+  ProfileSince(kPhaseCompute, worker, start);
+}
+
+/**
+ * @brief Advances the universe by one generation.
+ *
+ * Allocates the chunks the pattern may grow into, computes every chunk on
+ * the workers of `pool`, then releases the chunks left empty.
+ *
+ * @param universe The universe to advance.
+ * @param pool     The pool of workers computing the generation.
+ *
+ * @return Returns 0 on success, -1 if memory allocation fails.
+ */
+int StepUniverse(universe_t* universe, pool_t* pool) {
+  size_t count = universe->chunk_count;
+  for (size_t i = 0; i < count; i++) {
+    if (GrowAround(universe, universe->chunks[i]) < 0) {
+      return -1;
+    }
+  }
+
+  universe_step_t step = {universe};
+  RunPool(pool, StepChunks, &step);
+  universe->current = !universe->current;
+
+  for (size_t i = universe->chunk_count; i > 0; i--) {
+    if (!universe->chunks[i - 1]->alive) {
+      RemoveChunk(universe, i - 1);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Replaces the universe with the live cells of a world.
+ *
+ * The top-left live cell of the world is placed at the origin of the plane,
+ * with the world extending towards positive coordinates.
+ *
+ * @param universe The universe to load into, which must be empty.
+ * @param world    The world to load.
+ *
+ * @return Returns 0 on success, -1 if memory allocation fails.
+ */
+int LoadUniverse(universe_t* universe, const world_t* world) {
+  size_t chunk_cols = (world->cols + kChunkSize - 1) / kChunkSize;
+  for (size_t y = 0; y < world->rows; y++) {
+    const uint64_t* row = WorldRow(world, y + kPadding);
+    for (size_t x = 0; x < chunk_cols; x++) {
+      // World columns are shifted by the padding column
+      uint64_t word = (row[x] >> 1) | (row[x + 1] << 63);
+      if (!word) {
+        continue;
+      }
+      chunk_t* chunk = FindChunk(universe, (int64_t)x,
+                                 (int64_t)(y / kChunkSize));
+      if (!chunk) {
+        chunk = AddChunk(universe, (int64_t)x, (int64_t)(y / kChunkSize));
+        if (!chunk) {
+          return -1;
+        }
+      }
+      chunk->rows[universe->current][y % kChunkSize] = word;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Copies the window of the universe covered by a world into it.
+ *
+ * The window starts at the origin of the plane, where `LoadUniverse` placed
+ * the top-left cell of the world it loaded. Cells outside the window are not
+ * copied.
+ *
+ * @param universe The universe to read.
+ * @param world    The world receiving the cells.
+ */
+void StoreUniverse(const universe_t* universe, world_t* world) {
+  memset(world->cells, 0,
+         sizeof(uint64_t) * (world->rows + 2 * kPadding) * world->stride);
+
+  size_t last = LastWord(world);
+  for (size_t i = 0; i < universe->chunk_count; i++) {
+    const chunk_t* chunk = universe->chunks[i];
+    if (chunk->x < 0 || chunk->y < 0 || (size_t)chunk->x > last ||
+        (size_t)chunk->y * kChunkSize >= world->rows) {
+      continue;
+    }
+
+    size_t x = (size_t)chunk->x;
+    for (size_t r = 0; r < kChunkSize; r++) {
+      size_t y = (size_t)chunk->y * kChunkSize + r;
+      if (y >= world->rows) {
+        break;
+      }
+      uint64_t word = chunk->rows[universe->current][r];
+      uint64_t* row = WorldRow(world, y + kPadding);
+      row[x] |= word << 1;
+      if (x + 1 <= last) {
+        row[x + 1] |= word >> 63;
+      }
+    }
+  }
+
+  for (size_t y = 0; y < world->rows; y++) {
+    WorldRow(world, y + kPadding)[last] &= LastWordMask(world);
+  }
+}
@@ -0,0 +1,52 @@
+#ifndef UNBOUNDED_H_
+#define UNBOUNDED_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pool.h"
+#include "profile.h"
+#include "rule.h"
+#include "swar.h"
+#include "world.h"
+
+// Side of a chunk, in cells. A chunk row is exactly one 64-bit word.
+#define kChunkSize 64
+
+// Square block of 64 x 64 cells of an unbounded universe.
+//
+// Bit `x % 64` of `rows[..][y % 64]` holds the cell at (x, y) of the plane.
+// Each chunk keeps both generations of the double-buffered step.
+typedef struct chunk_t chunk_t;
+struct chunk_t {
+  int64_t x;                  // Chunk column, in units of chunks
+  int64_t y;                  // Chunk row, in units of chunks
+  uint64_t rows[2][kChunkSize];
+  chunk_t* next_free;         // Next chunk in the free list
+  int alive;                  // Whether the next generation has live cells
+};
+
+typedef struct chunk_slab_t chunk_slab_t;
+
+// Universe that grows as its pattern does, storing only the chunks around
+// live cells.
+typedef struct {
+  chunk_t** table;        // Open-addressing hash map of the chunks
+  size_t table_size;      // Number of slots, always a power of two
+  chunk_t** chunks;       // Every chunk, in no particular order
+  size_t chunk_count;
+  size_t chunk_capacity;
+  chunk_slab_t* slabs;    // Blocks the chunks are carved from
+  chunk_t* free_chunks;   // Chunks released when they emptied
+  int current;            // Index of the current generation in `rows`
+  rule_t rule;            // Rule the universe evolves under
+} universe_t;
+
+universe_t* CreateUniverse(const rule_t* rule);
+void FreeUniverse(universe_t* universe);
+int LoadUniverse(universe_t* universe, const world_t* world);
+int StepUniverse(universe_t* universe, pool_t* pool);
+void StoreUniverse(const universe_t* universe, world_t* world);
+
+#endif  // UNBOUNDED_H_
@@ -2,8 +2,8 @@
  * utils.c
  *
  * This file contains utility functions used across the Game of Life simulation project.
- * It includes implementations for parsing command-line arguments, creating and managing
- * grids or worlds, and other helper functionalities that support the main simulation.
+ * It includes implementations for parsing command-line arguments and other helper
+ * functionalities that support the main simulation.
  *
  * Author: Juan Diego Becerra
  * Date: 2024-03-16
@@ -30,6 +30,7 @@
  */
 int ParseLong(size_t* out, const char* arg) {
   char* end;
+  errno = 0;
   long value = strtol(arg, &end, 10);
   if (errno != 0 || value < 1 || !out) {
     return -1;
@@ -40,65 +41,61 @@ int ParseLong(size_t* out, const char* arg) {
 }
 
 /**
- * @brief Creates and returns a 2D grid of characters.
+ * @brief Parses the given string as a count, which unlike `ParseLong` may be
+ *        0.
  *
- * Creates and returns a pointer to a 2D grid of characters with the specified
- * number of `rows` and `cols`, each cell initialized to the character `ch`.
- * The function allocates memory for the grid and for each row individually.
- *
- * @param rows The number of rows in the grid.
- * @param cols The number of columns in the grid.
- * @param ch   The character to initialize each cell of the grid with.
- * 
- * @return Returns a pointer to the array of character pointers (rows) on 
- *         success. Returns NULL if memory allocation fails for the grid or any
- *         row.
+ * @param out A pointer to a `size_t` where the parsed value will be stored.
+ * @param arg The string representation of the count to be parsed.
  *
- * @note The caller is responsible for freeing the allocated memory for the
- *       grid and its rows after use. Memory allocation failure for any row 
- *       triggers cleanup of previously allocated rows and the grid itself
- *       before returning NULL.
+ * @return Returns 0 on success, -1 if `arg` is not a valid non-negative
+ *         integer or overflows.
  */
-char** CreateCharGrid(size_t rows, size_t cols, char ch) {
-  char** grid = malloc(sizeof(char*) * rows);
-  if (!grid) {
-    return NULL;
+int ParseCount(size_t* out, const char* arg) {
+  char* end;
+  errno = 0;
+  long value = strtol(arg, &end, 10);
+  if (errno != 0 || end == arg || value < 0 || !out) {
+    return -1;
   }
 
-  for (size_t i = 0; i < rows; i++) {
-    grid[i] = malloc(sizeof(char) * cols);
-    if (!grid[i]) {
-      while (i > 0) {
-        free(grid[--i]);
-      }
-      return NULL;
-    }
-    memset(grid[i], ch, sizeof(char) * cols);
-  }
-  
-  return grid;
+  *out = (size_t)value;
+  return 0;
 }
 
 /**
- * @brief Frees the memory allocated for a 2D grid of characters.
+ * @brief Reads a clock suited to timing intervals.
  *
- * Iterates over each row of the grid to free the memory allocated for the row,
- * and then frees the memory allocated for the grid itself. This function
- * should be called to clean up memory allocated by `CreateCharGrid`.
+ * @return Returns the time in seconds of a monotonic clock with an arbitrary
+ *         origin, so only differences between two readings are meaningful.
+ */
+double MonotonicSeconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Writes a whole buffer to a file descriptor, retrying on partial
+ *        writes and interruptions.
  *
- * @param grid A pointer to the array of character pointers (rows) to be freed.
- * @param rows The number of rows in the grid, which were allocated.
+ * @param fd   The descriptor to write to.
+ * @param data The bytes to write.
+ * @param size The number of bytes to write.
  *
- * @note It is safe to call this function with a NULL pointer or with a `rows`
- *       value of 0. However, the caller must ensure that the grid and its rows
- *       were allocated dynamically using `malloc` or similar allocation
- *       functions.
+ * @return Returns 0 on success, -1 on a write error.
  */
-void FreeGrid(char** grid, size_t rows) {
-  if (grid) {
-    for (size_t i = 0; i < rows; i++) {
-      free(grid[i]);
+int WriteAll(int fd, const void* data, size_t size) {
+  const char* bytes = data;
+  while (size > 0) {
+    ssize_t written = write(fd, bytes, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
     }
-    free(grid);
+    bytes += written;
+    size -= (size_t)written;
   }
-}
\ No newline at end of file
+  return 0;
+}
@@ -5,9 +5,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 
 int ParseLong(size_t* out, const char* arg);
-char** CreateCharGrid(size_t rows, size_t cols, char ch);
-void FreeGrid(char** grid, size_t rows);
+int ParseCount(size_t* out, const char* arg);
+double MonotonicSeconds(void);
+int WriteAll(int fd, const void* data, size_t size);
 
 #endif  // UTILS_H_
\ No newline at end of file
@@ -0,0 +1,224 @@
+/**
+ * world.c
+ *
+ * Implements the bit-packed world grid shared by the simulation and I/O
+ * paths. Cells are stored one bit each in 64-bit words, with every row of
+ * the grid laid out back to back in a single contiguous buffer.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "world.h"
+
+/**
+ * @brief Creates a bit-packed world grid with every cell dead.
+ *
+ * Allocates a grid able to hold `rows` x `cols` live cells surrounded by a
+ * ring of `kPadding` dead cells. Each row is rounded up to a whole number of
+ * 64-bit words, and the last word of every row always keeps at least one
+ * padding bit so that neighbouring rows never share a live column. A dead
+ * guard word is kept on each side of the buffer.
+ *
+ * The world and its cells take a single allocation: the `world_t` and the
+ * leading guard word fill the cache line before the first row, so the cells
+ * start on a cache line boundary. Worlds of `kHugePageBytes` or more are
+ * mapped straight from the kernel, rounded up to whole huge pages and
+ * starting on a huge page boundary, instead of coming from the heap. Their
+ * pages are only backed once first written, so they end up on the NUMA node
+ * of the thread writing them first, and `AdviseHugePages` can back them with
+ * transparent huge pages.
+ *
+ * @param rows The number of live rows in the world.
+ * @param cols The number of live columns in the world.
+ *
+ * @return Returns a pointer to the new world on success, or NULL if memory
+ *         allocation fails or the world is too large to be allocated.
+ *
+ * @note The returned world must be released with `FreeWorldGrid`.
+ */
+world_t* CreateWorldGrid(size_t rows, size_t cols) {
+  size_t lead = (sizeof(world_t) + sizeof(uint64_t) + kCacheLineBytes - 1) /
+                kCacheLineBytes * kCacheLineBytes;
+  // A size whose buffer is too large to be counted in bytes could never be
+  // allocated, and would wrap the size computed for it around
+  if (cols > SIZE_MAX - (2 * kPadding + kWordBits - 1) ||
+      rows > SIZE_MAX - 2 * kPadding) {
+    return NULL;
+  }
+  size_t stride = (cols + 2 * kPadding + kWordBits - 1) / kWordBits;
+  size_t words_max = (SIZE_MAX - lead - 2 * kHugePageBytes) /
+                     sizeof(uint64_t) - 1;
+  if (rows + 2 * kPadding > words_max / stride) {
+    return NULL;
+  }
+  size_t bytes = lead + ((rows + 2 * kPadding) * stride + 1) *
+                            sizeof(uint64_t);
+
+  void* block;
+  size_t mapped = 0;
+  if (bytes >= kHugePageBytes) {
+    // One huge page more is mapped than needed, so that the block can start
+    // on a huge page boundary and be backed by huge pages from its first
+    // byte on, and the slack on either side of it is unmapped
+    mapped = (bytes + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes;
+    char* area = mmap(NULL, mapped + kHugePageBytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (area == MAP_FAILED) {
+      return NULL;
+    }
+    size_t slack = (kHugePageBytes - (uintptr_t)area % kHugePageBytes) %
+                   kHugePageBytes;
+    if (slack) {
+      munmap(area, slack);
+    }
+    // Never empty, as `slack` is less than a huge page
+    munmap(area + slack + mapped, kHugePageBytes - slack);
+    block = area + slack;
+  } else {
+    bytes = (bytes + kCacheLineBytes - 1) / kCacheLineBytes * kCacheLineBytes;
+    block = aligned_alloc(kCacheLineBytes, bytes);
+    if (!block) {
+      return NULL;
+    }
+    memset(block, 0, bytes);
+  }
+
+  world_t* world = block;
+  world->rows = rows;
+  world->cols = cols;
+  world->stride = stride;
+  world->cells = (uint64_t*)((char*)block + lead);
+  world->mapped = mapped;
+  return world;
+}
+
+/**
+ * @brief Frees a world grid created by `CreateWorldGrid`.
+ *
+ * @param world The world to free. It is safe to pass NULL.
+ */
+void FreeWorldGrid(world_t* world) {
+  if (!world) {
+    return;
+  }
+  if (world->mapped) {
+    munmap(world, world->mapped);
+  } else {
+    free(world);
+  }
+}
+
+/**
+ * @brief Asks the kernel to back a world with transparent huge pages.
+ *
+ * Only the worlds mapped by `CreateWorldGrid` can be backed by huge pages;
+ * the call does nothing for the others, or where the kernel lacks them. The
+ * pages of the world not written yet are backed by huge pages as they are
+ * first written, and the kernel collapses the others in the background.
+ *
+ * @param world The world to back with huge pages.
+ */
+void AdviseHugePages(const world_t* world) {
+#ifdef MADV_HUGEPAGE
+  if (world->mapped) {
+    madvise((void*)world, world->mapped, MADV_HUGEPAGE);
+  }
+#else
+  (void)world;
+#endif
+}
+
+/**
+ * @brief Refills the padding ring with copies of the opposite edges.
+ *
+ * Copies the last live column into the left padding column and the first
+ * live column into the right one, then the last live row, padding included,
+ * into the top padding row and the first live row into the bottom one. The
+ * world can then be stepped as a torus without any wrap-around arithmetic
+ * in the kernels.
+ *
+ * @param world The world whose padding ring to refill.
+ */
+void FillHalo(world_t* world) {
+  FillHaloColumns(world, kPadding, world->rows + kPadding);
+
+  size_t bytes = sizeof(uint64_t) * world->stride;
+  memcpy(WorldRow(world, 0), WorldRow(world, world->rows), bytes);
+  memcpy(WorldRow(world, world->rows + kPadding), WorldRow(world, kPadding),
+         bytes);
+}
+
+/**
+ * @brief Refills the padding columns of rows [`row_begin`, `row_end`) with
+ *        copies of the opposite live columns, as `FillHalo` does for every
+ *        live row.
+ *
+ * @param world     The world whose padding columns to refill.
+ * @param row_begin The first row to refill.
+ * @param row_end   The row past the last one to refill.
+ */
+void FillHaloColumns(world_t* world, size_t row_begin, size_t row_end) {
+  for (size_t i = row_begin; i < row_end; i++) {
+    SetCell(world, i, 0, GetCell(world, i, world->cols));
+    SetCell(world, i, world->cols + kPadding, GetCell(world, i, kPadding));
+  }
+}
+
+/**
+ * @brief Kills every cell of the padding ring filled by `FillHalo`.
+ *
+ * @param world The world whose padding ring to clear.
+ */
+void ClearHalo(world_t* world) {
+  for (size_t i = kPadding; i <= world->rows; i++) {
+    SetCell(world, i, 0, 0);
+    SetCell(world, i, world->cols + kPadding, 0);
+  }
+
+  size_t bytes = sizeof(uint64_t) * world->stride;
+  memset(WorldRow(world, 0), 0, bytes);
+  memset(WorldRow(world, world->rows + kPadding), 0, bytes);
+}
+
+/**
+ * @brief Copies every cell of `src` into `dst`.
+ *
+ * @param dst The destination world.
+ * @param src The source world.
+ *
+ * @note Both worlds must have been created with the same dimensions.
+ */
+void CopyWorldGrid(world_t* dst, const world_t* src) {
+  memcpy(dst->cells, src->cells,
+         sizeof(uint64_t) * (src->rows + 2 * kPadding) * src->stride);
+}
+
+/**
+ * @brief Counts the live cells of a world.
+ *
+ * Padding cells are always dead, so every word of the live rows is counted
+ * whole.
+ */
+size_t CountPopulation(const world_t* world) {
+  const uint64_t* words = WorldRow(world, kPadding);
+  size_t population = 0;
+  for (size_t k = 0; k < world->rows * world->stride; k++) {
+    population += (size_t)__builtin_popcountll(words[k]);
+  }
+  return population;
+}
+
+/**
+ * @brief Returns 1 if every cell of the world is dead, 0 otherwise. The scan
+ *        stops at the first live word.
+ */
+int IsWorldEmpty(const world_t* world) {
+  const uint64_t* words = WorldRow(world, kPadding);
+  for (size_t k = 0; k < world->rows * world->stride; k++) {
+    if (words[k]) {
+      return 0;
+    }
+  }
+  return 1;
+}
@@ -0,0 +1,86 @@
+#ifndef WORLD_H_
+#define WORLD_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// Bit-packed world grid.
+//
+// Cells are stored one bit per cell in 64-bit words: column `j` of a row
+// lives in bit `j % 64` of word `j / 64`. All rows share one contiguous
+// buffer of `stride` words each. Indices include the dead padding ring, so
+// the live area spans rows [1, rows] and columns [1, cols]; row 0, row
+// `rows + 1`, column 0 and every column past `cols` are always dead.
+//
+// The buffer keeps one extra dead guard word before the first row and after
+// the last one. Together with the padding bits at both ends of each row, this
+// lets word-parallel kernels read the words on either side of any word in
+// the grid without bounds checks.
+typedef struct {
+  size_t rows;
+  size_t cols;
+  size_t stride;     // Words per row, including padding columns
+  uint64_t* cells;   // (rows + 2) * stride words
+  size_t mapped;     // Bytes mapped for the world, or 0 if it is on the heap
+} world_t;
+
+static const size_t kPadding = 1;
+static const size_t kWordBits = 64;
+// Alignment of the first row of every world
+static const size_t kCacheLineBytes = 64;
+// Size from which worlds are mapped rather than taken from the heap, the
+// size of a transparent huge page on x86-64 and most arm64 kernels
+static const size_t kHugePageBytes = 2 << 20;
+
+world_t* CreateWorldGrid(size_t rows, size_t cols);
+void FreeWorldGrid(world_t* world);
+void AdviseHugePages(const world_t* world);
+void CopyWorldGrid(world_t* dst, const world_t* src);
+void FillHalo(world_t* world);
+void FillHaloColumns(world_t* world, size_t row_begin, size_t row_end);
+void ClearHalo(world_t* world);
+size_t CountPopulation(const world_t* world);
+int IsWorldEmpty(const world_t* world);
+
+/**
+ * @brief Returns a pointer to the first word of a padded row.
+ */
+static inline uint64_t* WorldRow(const world_t* world, size_t row) {
+  return world->cells + row * world->stride;
+}
+
+/**
+ * @brief Returns the index of the last word of a row holding live columns.
+ */
+static inline size_t LastWord(const world_t* world) {
+  return world->cols / kWordBits;
+}
+
+/**
+ * @brief Returns the mask of live columns within the word `LastWord`.
+ */
+static inline uint64_t LastWordMask(const world_t* world) {
+  size_t bits = world->cols % kWordBits + 1;
+  return bits == kWordBits ? ~(uint64_t)0 : ((uint64_t)1 << bits) - 1;
+}
+
+/**
+ * @brief Returns 1 if the cell at (`row`, `col`) is alive, 0 otherwise.
+ */
+static inline int GetCell(const world_t* world, size_t row, size_t col) {
+  return (WorldRow(world, row)[col / kWordBits] >> (col % kWordBits)) & 1;
+}
+
+/**
+ * @brief Sets the cell at (`row`, `col`) alive if `alive` is non-zero, dead
+ *        otherwise.
+ */
+static inline void SetCell(world_t* world, size_t row, size_t col, int alive) {
+  uint64_t* word = &WorldRow(world, row)[col / kWordBits];
+  uint64_t bit = (uint64_t)1 << (col % kWordBits);
+  *word = alive ? (*word | bit) : (*word & ~bit);
+}
+
+#endif  // WORLD_H_
@@ -0,0 +1,251 @@
+/**
+ * writer.c
+ *
+ * Implements the saving of worlds to pattern files, in the same plain text,
+ * RLE and binary formats read by loader.c. Runs of RLE cells are measured a
+ * whole word at a time, so saving a large, sparse world costs little more
+ * than scanning its words.
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include "writer.h"
+
+static int WriteText(FILE* file, const world_t* world, char alive, char dead);
+static int WriteRle(FILE* file, const world_t* world, const rule_t* rule);
+static int WriteBinary(FILE* file, const world_t* world, const rule_t* rule);
+static size_t RunLength(const uint64_t* row, size_t begin, size_t end,
+                        int alive);
+static void WriteRleRun(FILE* file, size_t run, char tag, size_t* width);
+
+// Longest line of the cells of an RLE file, as recommended by the format
+static const size_t kRleLineWidth = 70;
+
+/**
+ * @brief Saves a world to a pattern file.
+ *
+ * The format of the file is chosen from its name by `PatternFormat`. RLE and
+ * binary files also record the rule, so that loading them back restores it.
+ *
+ * @param world    The world to save.
+ * @param rule     The rule of the world.
+ * @param filename The file to write, replaced if it exists.
+ * @param alive    The character of live cells in a text file.
+ * @param dead     The character of dead cells in a text file.
+ *
+ * @return Returns 0 on success, -1 if the file cannot be written. An error
+ *         message is printed on failure.
+ */
+int SaveWorld(const world_t* world, const rule_t* rule, const char* filename,
+              char alive, char dead) {
+  FILE* file = fopen(filename, "wb");
+  if (!file) {
+    fprintf(stderr, "Error: Failed to open file for writing, '%s'\n",
+            filename);
+    return -1;
+  }
+
+  int status;
+  switch (PatternFormat(filename)) {
+    case kFormatRle:
+      status = WriteRle(file, world, rule);
+      break;
+
+    case kFormatBinary:
+      status = WriteBinary(file, world, rule);
+      break;
+
+    default:
+      status = WriteText(file, world, alive, dead);
+      break;
+  }
+
+  if (fclose(file) != 0 || status < 0) {
+    fprintf(stderr, "Error: Failed to write file, '%s'\n", filename);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Writes every row of the world as one line of characters.
+ */
+static int WriteText(FILE* file, const world_t* world, char alive,
+                     char dead) {
+  char* line = malloc(world->cols + 1);
+  if (!line) {
+    return -1;
+  }
+
+  line[world->cols] = '\n';
+  for (size_t i = kPadding; i <= world->rows; i++) {
+    for (size_t j = kPadding; j <= world->cols; j++) {
+      line[j - kPadding] = GetCell(world, i, j) ? alive : dead;
+    }
+    fwrite(line, 1, world->cols + 1, file);
+  }
+
+  free(line);
+  return ferror(file) ? -1 : 0;
+}
+
+/**
+ * @brief Writes the world as an RLE pattern.
+ *
+ * Dead cells at the end of a row and empty rows at the end of the world are
+ * left out, and consecutive row ends are merged into a single run.
+ */
+static int WriteRle(FILE* file, const world_t* world, const rule_t* rule) {
+  char rule_text[kRuleTextSize];
+  FormatRule(rule, rule_text);
+  fprintf(file, "x = %zu, y = %zu, rule = %s\n", world->cols, world->rows,
+          rule_text);
+
+  size_t width = 0;
+  size_t row_ends = 0;
+  size_t end = world->cols + kPadding;
+  for (size_t i = kPadding; i <= world->rows; i++) {
+    const uint64_t* row = WorldRow(world, i);
+    size_t j = kPadding;
+    while (j < end) {
+      size_t dead = RunLength(row, j, end, 0);
+      j += dead;
+      if (j >= end) {
+        break;
+      }
+      size_t alive = RunLength(row, j, end, 1);
+      j += alive;
+
+      if (row_ends) {
+        WriteRleRun(file, row_ends, '$', &width);
+        row_ends = 0;
+      }
+      if (dead) {
+        WriteRleRun(file, dead, 'b', &width);
+      }
+      WriteRleRun(file, alive, 'o', &width);
+    }
+    row_ends++;
+  }
+
+  fputs("!\n", file);
+  return ferror(file) ? -1 : 0;
+}
+
+/**
+ * @brief Writes one run of an RLE pattern, starting a new line first if the
+ *        run would not fit on the current one.
+ */
+static void WriteRleRun(FILE* file, size_t run, char tag, size_t* width) {
+  char text[24];
+  int size = run > 1 ? snprintf(text, sizeof(text), "%zu%c", run, tag)
+                     : snprintf(text, sizeof(text), "%c", tag);
+  if (*width + (size_t)size > kRleLineWidth) {
+    fputc('\n', file);
+    *width = 0;
+  }
+  fwrite(text, 1, (size_t)size, file);
+  *width += (size_t)size;
+}
+
+/**
+ * @brief Returns the number of cells from column `begin` of a row, up to
+ *        `end`, that are alive if `alive` is set or dead otherwise.
+ */
+static size_t RunLength(const uint64_t* row, size_t begin, size_t end,
+                        int alive) {
+  size_t j = begin;
+  while (j < end) {
+    size_t bit = j % kWordBits;
+    uint64_t word = row[j / kWordBits];
+    // Bits of the cells ending the run, from column `j` on
+    uint64_t stops = (alive ? ~word : word) >> bit;
+    if (bit > 0) {
+      stops &= ((uint64_t)1 << (kWordBits - bit)) - 1;
+    }
+    if (stops) {
+      j += (size_t)__builtin_ctzll(stops);
+      break;
+    }
+    j += kWordBits - bit;
+  }
+  return (j < end ? j : end) - begin;
+}
+
+/**
+ * @brief Writes the world in the binary format described in loader.h.
+ */
+static int WriteBinary(FILE* file, const world_t* world, const rule_t* rule) {
+  unsigned char header[kBinaryHeaderSize];
+  PackBinaryHeader(header, kBinaryMagic, world->rows, world->cols, rule);
+  fwrite(header, 1, sizeof(header), file);
+
+  size_t row_bytes = (world->cols + 7) / 8;
+  unsigned char* bytes = malloc(row_bytes);
+  if (!bytes) {
+    return -1;
+  }
+
+  for (size_t i = kPadding; i <= world->rows; i++) {
+    PackBinaryRow(WorldRow(world, i), world->cols, bytes);
+    fwrite(bytes, 1, row_bytes, file);
+  }
+
+  free(bytes);
+  return ferror(file) ? -1 : 0;
+}
+
+/**
+ * @brief Fills the header of a binary pattern, as described in loader.h.
+ *
+ * @param header The `kBinaryHeaderSize` bytes to fill.
+ * @param magic  The four bytes identifying the file, such as `kBinaryMagic`.
+ * @param rows   The number of rows of the pattern.
+ * @param cols   The number of columns of the pattern.
+ * @param rule   The rule of the pattern.
+ */
+void PackBinaryHeader(unsigned char* header, const char* magic, size_t rows,
+                      size_t cols, const rule_t* rule) {
+  memset(header, 0, kBinaryHeaderSize);
+  memcpy(header, magic, sizeof(kBinaryMagic));
+  header[4] = kBinaryVersion;
+  for (size_t b = 0; b < 8; b++) {
+    header[8 + b] = (unsigned char)((uint64_t)rows >> (8 * b));
+    header[16 + b] = (unsigned char)((uint64_t)cols >> (8 * b));
+  }
+  header[24] = (unsigned char)(rule->birth & 0xFF);
+  header[25] = (unsigned char)(rule->birth >> 8);
+  header[26] = (unsigned char)(rule->survive & 0xFF);
+  header[27] = (unsigned char)(rule->survive >> 8);
+}
+
+/**
+ * @brief Packs the live cells of a row into `(cols + 7) / 8` bytes, with
+ *        column `j` of the pattern in bit `j % 8` of byte `j / 8`.
+ *
+ * Column `j` of the pattern is column `j + 1` of the row, so each group of
+ * 64 columns is the pair of words it straddles, shifted by the padding.
+ * Columns past the width of the world are padding, so the last byte is
+ * zero-filled.
+ *
+ * @param row   The padded row, as returned by `WorldRow`.
+ * @param cols  The number of live columns of the row.
+ * @param bytes Receives the packed row.
+ */
+void PackBinaryRow(const uint64_t* row, size_t cols, unsigned char* bytes) {
+  size_t row_bytes = (cols + 7) / 8;
+  for (size_t offset = 0, w = 0; offset < row_bytes; offset += 8, w++) {
+    // The top bit comes from the next word, which is only read when it
+    // holds a live column
+    uint64_t cells = row[w] >> kPadding;
+    if (cols + kPadding >= (w + 1) * kWordBits) {
+      cells |= row[w + 1] << (kWordBits - kPadding);
+    }
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    cells = __builtin_bswap64(cells);
+#endif
+    size_t count = row_bytes - offset < 8 ? row_bytes - offset : 8;
+    memcpy(bytes + offset, &cells, count);
+  }
+}
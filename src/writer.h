@@ -0,0 +1,19 @@
+#ifndef WRITER_H_
+#define WRITER_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "loader.h"
+#include "rule.h"
+#include "world.h"
+
+int SaveWorld(const world_t* world, const rule_t* rule, const char* filename,
+              char alive, char dead);
+void PackBinaryHeader(unsigned char* header, const char* magic, size_t rows,
+                      size_t cols, const rule_t* rule);
+void PackBinaryRow(const uint64_t* row, size_t cols, unsigned char* bytes);
+
+#endif  // WRITER_H_
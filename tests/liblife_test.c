@@ -0,0 +1,242 @@
+/**
+ * liblife_test.c
+ *
+ * Tests the handle interface of liblife, linked against liblife.a the way a
+ * program embedding the simulator links it: stepping known patterns, reading
+ * the cells in place, the counters after cells are set and the handles that
+ * cannot be created. Every failed check is printed with its line, and the
+ * program exits with status 1 if any failed.
+ *
+ * Usage: ./liblife_test
+ *
+ * Author: Juan Diego Becerra
+ * Date: 2026-10-14
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "liblife.h"
+
+// Checks a condition, printing it with its line if it does not hold
+#define CHECK(condition)                                           \
+  do {                                                             \
+    checks++;                                                      \
+    if (!(condition)) {                                            \
+      fprintf(stderr, "%s:%d: Check failed, '%s'\n", __FILE__,     \
+              __LINE__, #condition);                               \
+      failures++;                                                  \
+    }                                                              \
+  } while (0)
+
+static size_t checks = 0;
+static size_t failures = 0;
+
+static void TestStepBlinker(void);
+static void TestStepGlider(void);
+static void TestCellLayout(void);
+static void TestStatsAfterSetCell(void);
+static void TestInvalidOptions(void);
+static size_t CountCells(const life_t* life);
+
+int main(void) {
+  TestStepBlinker();
+  TestStepGlider();
+  TestCellLayout();
+  TestStatsAfterSetCell();
+  TestInvalidOptions();
+
+  printf("liblife: %zu checks, %zu failed\n", checks, failures);
+  return failures ? 1 : 0;
+}
+
+/**
+ * @brief Steps a blinker, which turns between a row and a column of three
+ *        cells every generation, on the portable engines and the widest one
+ *        the CPU supports.
+ */
+static void TestStepBlinker(void) {
+  static const char* const kEngines[] = {"scalar", "swar", "lut", NULL};
+
+  for (size_t e = 0; e < sizeof(kEngines) / sizeof(kEngines[0]); e++) {
+    life_options_t options = {kEngines[e], NULL, 2, 0};
+    life_t* life = LifeCreate(5, 5, &options);
+    CHECK(life != NULL);
+    if (!life) {
+      continue;
+    }
+
+    for (size_t j = 1; j <= 3; j++) {
+      LifeSetCell(life, 2, j, 1);
+    }
+    LifeStep(life, 1);
+    CHECK(LifeGeneration(life) == 1);
+    CHECK(CountCells(life) == 3);
+    for (size_t i = 1; i <= 3; i++) {
+      CHECK(LifeGetCell(life, i, 2));
+    }
+
+    LifeStep(life, 3);
+    CHECK(LifeGeneration(life) == 4);
+    CHECK(CountCells(life) == 3);
+    for (size_t j = 1; j <= 3; j++) {
+      CHECK(LifeGetCell(life, 2, j));
+    }
+    LifeFree(life);
+  }
+}
+
+/**
+ * @brief Steps a glider, which moves one cell down and to the right every
+ *        four generations, across the word boundary of a wide world and
+ *        around the edges of a wrapped one.
+ */
+static void TestStepGlider(void) {
+  static const size_t kGlider[5][2] = {{0, 1}, {1, 2}, {2, 0}, {2, 1},
+                                       {2, 2}};
+
+  life_t* life = LifeCreate(8, 130, NULL);
+  CHECK(life != NULL);
+  if (life) {
+    for (size_t k = 0; k < 5; k++) {
+      LifeSetCell(life, kGlider[k][0], kGlider[k][1] + 60, 1);
+    }
+    LifeStep(life, 16);
+    CHECK(CountCells(life) == 5);
+    for (size_t k = 0; k < 5; k++) {
+      CHECK(LifeGetCell(life, kGlider[k][0] + 4, kGlider[k][1] + 64));
+    }
+    LifeFree(life);
+  }
+
+  life_options_t options = {NULL, NULL, 1, 1};
+  life = LifeCreate(6, 6, &options);
+  CHECK(life != NULL);
+  if (life) {
+    for (size_t k = 0; k < 5; k++) {
+      LifeSetCell(life, kGlider[k][0], kGlider[k][1], 1);
+    }
+    LifeStep(life, 4 * 6);
+    CHECK(CountCells(life) == 5);
+    for (size_t k = 0; k < 5; k++) {
+      CHECK(LifeGetCell(life, kGlider[k][0], kGlider[k][1]));
+    }
+    LifeFree(life);
+  }
+}
+
+/**
+ * @brief Checks that `LifeCells` hands out the buffer the cells are stepped
+ *        in, with column `c` at bit `(c + 1) % 64` of word `(c + 1) / 64` of
+ *        its row, and the bits on either side of the columns dead.
+ */
+static void TestCellLayout(void) {
+  static const size_t kColumns[] = {0, 62, 63, 64, 126, 129};
+
+  life_t* life = LifeCreate(3, 130, NULL);
+  CHECK(life != NULL);
+  if (!life) {
+    return;
+  }
+
+  size_t stride;
+  const uint64_t* cells = LifeCells(life, &stride);
+  CHECK(stride >= (130 + 2 + 63) / 64);
+  for (size_t k = 0; k < sizeof(kColumns) / sizeof(kColumns[0]); k++) {
+    LifeSetCell(life, 1, kColumns[k], 1);
+  }
+
+  // Setting the cells writes the same buffer, seen without copying it
+  size_t again;
+  CHECK(LifeCells(life, &again) == cells && again == stride);
+  const uint64_t* row = cells + stride;
+  for (size_t c = 0; c < 130; c++) {
+    int bit = (row[(c + 1) / 64] >> ((c + 1) % 64)) & 1;
+    CHECK(bit == LifeGetCell(life, 1, c));
+  }
+  CHECK((row[0] & 1) == 0);
+  for (size_t b = 130 + 1; b < stride * 64; b++) {
+    CHECK(((row[b / 64] >> (b % 64)) & 1) == 0);
+  }
+  for (size_t w = 0; w < stride; w++) {
+    CHECK(cells[w] == 0 && cells[2 * stride + w] == 0);
+  }
+  CHECK(LifeGetCell(life, 1, 130) == 0);
+  CHECK(LifeGetCell(life, 3, 0) == 0);
+  LifeFree(life);
+}
+
+/**
+ * @brief Checks the counters of a world whose cells were set, before and
+ *        after it is stepped.
+ */
+static void TestStatsAfterSetCell(void) {
+  life_t* life = LifeCreate(10, 100, NULL);
+  CHECK(life != NULL);
+  if (!life) {
+    return;
+  }
+
+  life_stats_t stats;
+  LifeGetStats(life, &stats);
+  CHECK(stats.population == 0);
+
+  // A blinker, lying across columns 70 to 72, and a block
+  for (size_t j = 70; j <= 72; j++) {
+    LifeSetCell(life, 4, j, 1);
+  }
+  LifeSetCell(life, 1, 2, 1);
+  LifeSetCell(life, 1, 3, 1);
+  LifeSetCell(life, 2, 2, 1);
+  LifeSetCell(life, 2, 3, 1);
+  LifeGetStats(life, &stats);
+  CHECK(stats.population == 7);
+  CHECK(stats.births == 0 && stats.deaths == 0);
+  CHECK(stats.top == 1 && stats.bottom == 4);
+  CHECK(stats.left == 2 && stats.right == 72);
+
+  LifeStep(life, 1);
+  LifeGetStats(life, &stats);
+  CHECK(stats.population == 7);
+  CHECK(stats.births == 2 && stats.deaths == 2);
+  CHECK(stats.top == 1 && stats.bottom == 5);
+  CHECK(stats.left == 2 && stats.right == 71);
+
+  // Clearing a cell of the block counts it again without stepping
+  LifeSetCell(life, 1, 2, 0);
+  LifeGetStats(life, &stats);
+  CHECK(stats.population == 6);
+  CHECK(stats.births == 0 && stats.deaths == 0);
+  LifeFree(life);
+}
+
+/**
+ * @brief Checks that handles with an invalid size or option are not created.
+ */
+static void TestInvalidOptions(void) {
+  life_options_t engine = {"nonexistent", NULL, 1, 0};
+  life_options_t rule = {NULL, "B3/S2x", 1, 0};
+  life_options_t birth = {NULL, "B0/S8", 1, 0};
+
+  CHECK(LifeCreate(0, 10, NULL) == NULL);
+  CHECK(LifeCreate(10, 0, NULL) == NULL);
+  CHECK(LifeCreate(SIZE_MAX, 64, NULL) == NULL);
+  CHECK(LifeCreate((size_t)1 << 61, 64, NULL) == NULL);
+  CHECK(LifeCreate(10, 10, &engine) == NULL);
+  CHECK(LifeCreate(10, 10, &rule) == NULL);
+  CHECK(LifeCreate(10, 10, &birth) == NULL);
+  CHECK(LifeLoad("tests/nonexistent.txt", 0, 0, NULL) == NULL);
+}
+
+/**
+ * @brief Returns the number of live cells of a world, read cell by cell.
+ */
+static size_t CountCells(const life_t* life) {
+  size_t count = 0;
+  for (size_t i = 0; i < LifeRows(life); i++) {
+    for (size_t j = 0; j < LifeColumns(life); j++) {
+      count += (size_t)LifeGetCell(life, i, j);
+    }
+  }
+  return count;
+}
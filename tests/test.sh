@@ -26,9 +26,14 @@ fi
 TESTS=tests
 OUTPUT=output.txt
 EXPECTED=expected.txt
-INPUT=input.txt
+# Initial world of each test, in any format the game reads (input.txt,
+# input.rle, input.lifb)
+INPUT=input
 PROCEDURE=run
-readonly TESTS OUTPUT EXPECTED INPUT PROCEDURE
+# Extra options passed to every test command, e.g. '--engine swar'. They come
+# before the test's own options, so a test selecting its engine keeps it.
+EXTRA_ARGS="$*"
+readonly TESTS OUTPUT EXPECTED INPUT PROCEDURE EXTRA_ARGS
 
 # Check to see if a file exists.
 exists() {
@@ -54,8 +59,8 @@ fi
 passed=0
 failed=0
 for testcase in "${TESTS}"/*/; do
-    if ! exists "${testcase}${INPUT}"; then
-        echo "Error: Input file '${INPUT}' does not exist for '${testcase}'";
+    if ! compgen -G "${testcase}${INPUT}.*" > /dev/null; then
+        echo "Error: Input file '${INPUT}.*' does not exist for '${testcase}'";
         echo -e "Skipping...\n"
         continue
     fi
@@ -71,6 +76,7 @@ for testcase in "${TESTS}"/*/; do
     fi
 
     command=$(head -n 1 "${testcase}${PROCEDURE}")
+    command="${command/#.\/life/./life ${EXTRA_ARGS}}"
     eval "${command} --debug" > "${testcase}${OUTPUT}"
     
     if diff "${testcase}${OUTPUT}" "${testcase}${EXPECTED}" > /dev/null; then